@@ -0,0 +1,34 @@
+TEMPLATE = app
+CONFIG += console c++20
+CONFIG -= qt app_bundle
+
+QMAKE_CXXFLAGS += -O2
+TARGET = OptimBatch
+OBJECTS_DIR = obj/batch/
+
+SOURCES += \
+    src/Batch.cpp \
+    src/BatchOptim.cpp \
+    src/Expression.cpp \
+    src/MathFunc.cpp \
+    src/PointKernels.cpp
+
+HEADERS += \
+    src/BatchOptim.h \
+    src/CachedFunction.h \
+    src/DiffStoper.h \
+    src/Expression.h \
+    src/FixedOptim.h \
+    src/FunctionCatalog.h \
+    src/GeneralFunction.h \
+    src/InstrumentedFunction.h \
+    src/LineSearch.h \
+    src/MathFunc.h \
+    src/NewtonOptim.h \
+    src/OptMethod.h \
+    src/Optimization.h \
+    src/Pathway.h \
+    src/Point.h \
+    src/PointKernels.h \
+    src/StaticOptim.h \
+    src/ThreadPool.h
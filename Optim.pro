@@ -15,18 +15,41 @@ OBJECTS_DIR = obj/
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    src/Expression.cpp \
     src/MathFunc.cpp \
     src/Optim.cpp \
+    src/PointKernels.cpp \
+    src/ScalableFunc.cpp \
     src/gui_optim.cpp \
     src/mygraphicsscene.cpp \
     src/settings.cpp
 
 HEADERS += \
+    src/AsyncOptim.h \
+    src/AutoDiff.h \
+    src/CachedFunction.h \
     src/DiffStoper.h \
+    src/Expression.h \
+    src/FiniteDifference.h \
+    src/FixedOptim.h \
+    src/FunctionCatalog.h \
+    src/GeneralFunction.h \
+    src/InstrumentedFunction.h \
+    src/LineSearch.h \
     src/MathFunc.h \
+    src/MultiStart.h \
+    src/NewtonOptim.h \
     src/OptMethod.h \
+    src/Pathway.h \
     src/Optimization.h \
     src/Point.h \
+    src/ReverseDiff.h \
+    src/ScalableFunc.h \
+    src/SpscQueue.h \
+    src/StaticOptim.h \
+    src/Sweep.h \
+    src/PointKernels.h \
+    src/ThreadPool.h \
     src/gui_optim.h \
     src/mygraphicsscene.h \
     src/settings.h \
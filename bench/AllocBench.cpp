@@ -0,0 +1,144 @@
+/// @file
+/// @brief Benchmark of heap allocations in Point arithmetic and in the optimization methods.
+/// @details Global operator new is replaced by a counting one. The program prints the count of allocations
+/// per iteration of a point expression and per function evaluation of the line search.
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include "MathFunc.h"
+#include "OptMethod.h"
+#include "DiffStoper.h"
+
+static std::atomic<size_t> allocations{0};
+
+// The replacements are not inlined, so the compiler does not pair malloc in new with operator delete.
+[[gnu::noinline]] void* operator new(size_t size)
+{
+    ++allocations;
+
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+/// @brief Function which counts evaluations and allocations made between them.
+class CountingFunction : public GeneralFunction<double>
+{
+private:
+    GeneralFunction<double>& f;
+public:
+    mutable size_t values = 0;
+    mutable size_t dirtyValues = 0;
+    mutable size_t lastAllocations = 0;
+
+    CountingFunction(GeneralFunction<double>& _f) : f(_f) {}
+
+    double Value(const Point<double>& p) const override
+    {
+        if (allocations != lastAllocations)
+            ++dirtyValues;
+
+        ++values;
+        double res = f.Value(p);
+        lastAllocations = allocations;
+
+        return res;
+    }
+
+    Point<double> Gradient(const Point<double>& p) const override
+    {
+        return f.Gradient(p);
+    }
+
+    double ValueAndGradient(const Point<double>& p, Point<double>& gradient) const override
+    {
+        if (allocations != lastAllocations)
+            ++dirtyValues;
+
+        ++values;
+        double res = f.ValueAndGradient(p, gradient);
+        lastAllocations = allocations;
+
+        return res;
+    }
+};
+
+template <class Op>
+void Measure(const char* name, size_t dim, size_t iterations, Op op)
+{
+    size_t before = allocations;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i{}; i < iterations; ++i)
+        op(static_cast<double>(i) / iterations);
+
+    std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - start;
+
+    std::cout << name << " dim=" << dim << ": " << static_cast<double>(allocations - before) / iterations
+              << " allocations/iter, " << time.count() / iterations << " ns/iter" << std::endl;
+}
+
+int main()
+{
+    const size_t iterations = 100000;
+
+    for (size_t dim : {2, 1000})
+    {
+        Point<double> p(std::vector<double>(dim, 1.0)), v(std::vector<double>(dim, 0.5)), probe = p;
+        double sink = 0;
+
+        Measure("temporary   p + al * v", dim, iterations, [&](double al)
+        {
+            Point<double> tmp = p + al * v;
+            sink += tmp[0];
+        });
+
+        Measure("destination p + al * v", dim, iterations, [&](double al)
+        {
+            probe = p + al * v;
+            sink += probe[0];
+        });
+
+        Measure("destination p + (-v)  ", dim, iterations, [&](double)
+        {
+            probe = p + (-v);
+            sink += probe[0];
+        });
+
+        std::cout << "(checksum " << sink << ")" << std::endl;
+    }
+
+    F_2D::FuncRosenbrock rosenbrock;
+    CountingFunction f(rosenbrock);
+    NumStop<double> stop(100);
+    DetermOptimization<double> determ(f, stop, 1e-6, 1e-2);
+    StochastOptimization<double> stoch(f, stop, 0.6, 0.1, 0, 0.2);
+
+    for (Optimization<double>* opt : {static_cast<Optimization<double>*>(&determ), static_cast<Optimization<double>*>(&stoch)})
+    {
+        f.values = f.dirtyValues = 0;
+        opt->SetArea(Point<double>({-1, -0.1}), Point<double>({1.1, 1.1}));
+
+        size_t before = allocations;
+        opt->DoOptimize(Point<double>({-0.5, 0.5}));
+
+        std::cout << (opt == &determ ? "Deterministic" : "Stochastic") << ": " << f.values << " evaluations, "
+                  << static_cast<double>(allocations - before) / f.values << " allocations/evaluation, "
+                  << f.dirtyValues << " evaluations preceded by an allocation" << std::endl;
+    }
+
+    return 0;
+}
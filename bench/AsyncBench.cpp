@@ -0,0 +1,80 @@
+/// @file
+/// @brief Benchmark of the optimization in a worker thread.
+/// @details The Stochastic Method is run in a worker thread while the main thread drains the queue of points
+/// at the rate of a display. The program prints the cost of streaming per iteration, the count of received
+/// and dropped points and the latency of cancellation and of a restart.
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include "AsyncOptim.h"
+#include "MathFunc.h"
+#include "OptMethod.h"
+
+using Clock = std::chrono::steady_clock;
+
+double Milliseconds(Clock::time_point begin)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+int main()
+{
+    const size_t maxStep = 2000000;
+    const CubicArea<double> area{Point<double>({-5, -5}), Point<double>({5, 5})};
+    const Point<double> start({0, 0});
+    F_2D::FuncHimmelblau f;
+    NumStop<double> stop(maxStep);
+    StochastOptimization<double> method(f, stop, 0.8, 0.5, 0, 0.9);
+
+    method.SetArea(area.minArea, area.maxArea);
+
+    auto begin = Clock::now();
+    method.DoOptimize(start);
+    const double direct = Milliseconds(begin);
+
+    AsyncOptimization<double> async(4096);
+    size_t received = 0;
+    auto count = [&received](const Point<double>&) { ++received; };
+
+    method.SetArea(area.minArea, area.maxArea);
+    begin = Clock::now();
+    async.Start(method, stop, start);
+
+    // The consumer wakes up sixty times per second like redraws of the GUI.
+    while (async.IsRunning())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        async.Drain(count);
+    }
+
+    async.Wait();
+    async.Drain(count);
+    const double streamed = Milliseconds(begin);
+
+    std::cout << "Stochastic Method, " << maxStep << " iterations" << std::endl;
+    std::cout << "    in the calling thread: " << direct << " ms" << std::endl;
+    std::cout << "    in a worker thread with streaming: " << streamed << " ms, " << (streamed - direct) / maxStep * 1e6 << " ns per iteration" << std::endl;
+    std::cout << "    received " << received << " points, dropped " << async.getDropped() << std::endl;
+
+    // A run is cancelled and restarted at once like a click on the scene during a run.
+    method.SetArea(area.minArea, area.maxArea);
+    async.Start(method, stop, start);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    begin = Clock::now();
+    async.Cancel();
+    const double cancel = Milliseconds(begin);
+    const size_t length = method.getPathway().size();
+
+    method.SetArea(area.minArea, area.maxArea);
+    begin = Clock::now();
+    async.Start(method, stop, start);
+    const double restart = Milliseconds(begin);
+
+    async.Cancel();
+    async.Wait();
+
+    std::cout << "    cancellation: " << cancel << " ms, restart: " << restart << " ms, points of the cancelled run " << length << std::endl;
+
+    return 0;
+}
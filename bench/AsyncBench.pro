@@ -0,0 +1,29 @@
+TEMPLATE = app
+CONFIG += console c++20
+CONFIG -= qt app_bundle
+
+QMAKE_CXXFLAGS += -O2
+TARGET = AsyncBench
+OBJECTS_DIR = ../obj/bench/
+INCLUDEPATH += ../src
+
+SOURCES += \
+    AsyncBench.cpp \
+    ../src/MathFunc.cpp \
+    ../src/PointKernels.cpp
+
+HEADERS += \
+    ../src/AsyncOptim.h \
+    ../src/CachedFunction.h \
+    ../src/DiffStoper.h \
+    ../src/GeneralFunction.h \
+    ../src/InstrumentedFunction.h \
+    ../src/LineSearch.h \
+    ../src/MathFunc.h \
+    ../src/OptMethod.h \
+    ../src/Optimization.h \
+    ../src/Pathway.h \
+    ../src/Point.h \
+    ../src/PointKernels.h \
+    ../src/SpscQueue.h \
+    ../src/ThreadPool.h
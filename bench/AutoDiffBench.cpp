@@ -0,0 +1,96 @@
+/// @file
+/// @brief Benchmark of forward-mode automatic differentiation.
+/// @details Rosenbrock and Himmelblau are written once as templates and differentiated by AutoDiffFunction.
+/// The program compares gradients with the hand-written F_2D::FuncRosenbrock and F_2D::FuncHimmelblau
+/// and prints the time of a gradient and of a fused value and gradient evaluation.
+#include <chrono>
+#include <iostream>
+#include <random>
+#include "AutoDiff.h"
+#include "MathFunc.h"
+
+struct Rosenbrock
+{
+    template <class P>
+    auto operator()(const P& p) const
+    {
+        return (1 - p[0]) * (1 - p[0]) + (p[1] - p[0] * p[0]) * (p[1] - p[0] * p[0]);
+    }
+};
+
+struct Himmelblau
+{
+    template <class P>
+    auto operator()(const P& p) const
+    {
+        return (p[0] * p[0] + p[1] - 11) * (p[0] * p[0] + p[1] - 11) + (p[0] + p[1] * p[1] - 7) * (p[0] + p[1] * p[1] - 7);
+    }
+};
+
+template <class Op>
+double Measure(size_t iterations, Op op)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i{}; i < iterations; ++i)
+        op(i);
+
+    std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - start;
+
+    return time.count() / iterations;
+}
+
+template <class Container>
+void Compare(const char* name, const GeneralFunction<double, Container>& hand, const GeneralFunction<double, Container>& ad,
+             const std::vector<Point<double, Container>>& points)
+{
+    double maxError = 0, sink = 0;
+    Point<double, Container> gradient;
+
+    for (const auto& p : points)
+    {
+        Point<double, Container> h = hand.Gradient(p), a = ad.Gradient(p);
+
+        maxError = std::max(maxError, std::abs(hand.Value(p) - ad.Value(p)));
+
+        for (size_t i{}; i < p.size(); ++i)
+            maxError = std::max(maxError, std::abs(h[i] - a[i]));
+    }
+
+    const size_t n = points.size();
+    double handGradient = Measure(n, [&](size_t i) { sink += hand.Gradient(points[i])[0]; });
+    double adGradient = Measure(n, [&](size_t i) { sink += ad.Gradient(points[i])[0]; });
+    double handFused = Measure(n, [&](size_t i) { sink += hand.ValueAndGradient(points[i], gradient); });
+    double adFused = Measure(n, [&](size_t i) { sink += ad.ValueAndGradient(points[i], gradient); });
+
+    std::cout << name << ": max error " << maxError << ", Gradient " << handGradient << " ns (hand) / " << adGradient
+              << " ns (AD), ValueAndGradient " << handFused << " ns (hand) / " << adFused << " ns (AD) (checksum " << sink << ")"
+              << std::endl;
+}
+
+int main()
+{
+    const size_t count = 1000000;
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> distr(-5, 5);
+    std::vector<Point<double>> points;
+    std::vector<PointN<double, 2>> fixedPoints;
+
+    for (size_t i{}; i < count; ++i)
+    {
+        points.push_back(Point<double>({distr(generator), distr(generator)}));
+        fixedPoints.push_back(PointN<double, 2>({points.back()[0], points.back()[1]}));
+    }
+
+    F_2D::FuncRosenbrock rosenbrock;
+    F_2D::FuncHimmelblau himmelblau;
+    AutoDiffFunction<double, 2, Rosenbrock> rosenbrockAD;
+    AutoDiffFunction<double, 2, Himmelblau> himmelblauAD;
+
+    Compare<std::vector<double>>("Rosenbrock", rosenbrock, rosenbrockAD, points);
+    Compare<std::array<double, 2>>("Rosenbrock N=2", rosenbrock, rosenbrockAD, fixedPoints);
+    Compare<std::vector<double>>("Himmelblau", himmelblau, himmelblauAD, points);
+    Compare<std::array<double, 2>>("Himmelblau N=2", himmelblau, himmelblauAD, fixedPoints);
+
+    return 0;
+}
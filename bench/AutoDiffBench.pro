@@ -0,0 +1,21 @@
+TEMPLATE = app
+CONFIG += console c++20
+CONFIG -= qt app_bundle
+
+QMAKE_CXXFLAGS += -O2
+TARGET = AutoDiffBench
+OBJECTS_DIR = ../obj/bench/
+INCLUDEPATH += ../src
+
+SOURCES += \
+    AutoDiffBench.cpp \
+    ../src/MathFunc.cpp \
+    ../src/PointKernels.cpp
+
+HEADERS += \
+    ../src/AutoDiff.h \
+    ../src/GeneralFunction.h \
+    ../src/MathFunc.h \
+    ../src/Optimization.h \
+    ../src/Pathway.h \
+    ../src/Point.h
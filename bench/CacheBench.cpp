@@ -0,0 +1,48 @@
+/// @file
+/// @brief Benchmark of the cache of evaluations in runs of the batch runner.
+/// @details Jobs optimize functions of expressions with the default cache and again with cache=0.
+/// The program prints evaluations and cache hits of every job and checks that the cache does not change results
+/// and that the runs get hits. It exits with 1 if a check fails.
+#include <iostream>
+#include <sstream>
+#include "BatchOptim.h"
+#include "FunctionCatalog.h"
+
+int main()
+{
+    const char* functions[] = {"3x^2+0.5y^2+2", "(1-x)^2+(y-x^2)^2", "\\sin(\\pi*sin(x)+\\pi*\\sin(y))", "(x^2+y-11)^2+(x+y^2-7)^2"};
+    const char* searches[] = {"brent", "wolfe", "armijo"};
+    std::stringstream text;
+
+    for (const char* expression : functions)
+        for (const char* search : searches)
+            for (const char* cache : {"", " cache=0"})
+                text << "expr=" << expression << " search=" << search << " min=-2,-2 max=2,2 start=1.5,-1.5" << cache << "\n";
+
+    FunctionCatalog catalog;
+    const std::vector<Batch::Job> jobs = Batch::ReadJobs(text, catalog.getFunctions());
+    size_t hits = 0;
+    bool same = true;
+
+    for (size_t i{}; i < jobs.size(); i += 2)
+    {
+        const Batch::Result cached = Batch::RunJob(jobs[i], i), plain = Batch::RunJob(jobs[i + 1], i + 1);
+
+        std::cout << jobs[i].function << ", " << jobs[i].search << ": evaluations " << cached.evaluations << ", cache hits "
+                  << cached.cacheHits << ", without the cache " << plain.evaluations << " evaluations";
+
+        if (!cached.error.empty() || !plain.error.empty() || cached.value != plain.value || cached.iterations != plain.iterations)
+        {
+            std::cout << ", RESULTS DIFFER " << cached.error << plain.error;
+            same = false;
+        }
+
+        std::cout << std::endl;
+        hits += cached.cacheHits;
+    }
+
+    if (!hits)
+        std::cout << "NO CACHE HITS" << std::endl;
+
+    return same && hits ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+/// @file
+/// @brief Benchmark of functions compiled from expressions.
+/// @details The functions of MathFunc.h are written as expressions and compiled by ExpressionFunction.
+/// The program compares values and gradients with the hand-written functions and prints the time
+/// of one evaluation in a point and per point of a block.
+#include <chrono>
+#include <iostream>
+#include <random>
+#include "Expression.h"
+#include "MathFunc.h"
+
+template <class Op>
+double Measure(size_t iterations, Op op)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i{}; i < iterations; ++i)
+        op(i);
+
+    std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - start;
+
+    return time.count() / iterations;
+}
+
+void Compare(const char* text, const GeneralFunction<double>& hand, size_t dim, std::mt19937& generator)
+{
+    const size_t count = 1024, iterations = 1000;
+    ExpressionFunction compiled(text);
+    std::uniform_real_distribution<double> distr(-2, 2);
+    std::vector<std::vector<double>> coords(dim, std::vector<double>(count));
+    std::vector<const double*> block;
+    std::vector<Point<double>> points(count);
+
+    for (auto& c : coords)
+    {
+        for (double& x : c)
+            x = distr(generator);
+
+        block.push_back(c.data());
+    }
+
+    for (size_t i{}; i < count; ++i)
+    {
+        points[i].Resize(dim);
+
+        for (size_t j{}; j < dim; ++j)
+            points[i][j] = coords[j][i];
+    }
+
+    double maxError = 0, sink = 0;
+    Point<double> g1, g2;
+
+    for (const auto& p : points)
+    {
+        maxError = std::max(maxError, std::abs(compiled.ValueAndGradient(p, g1) - hand.ValueAndGradient(p, g2)));
+
+        for (size_t j{}; j < dim; ++j)
+            maxError = std::max(maxError, std::abs(g1[j] - g2[j]));
+    }
+
+    std::vector<double> values(count);
+
+    const double scalarHand = Measure(iterations * count, [&](size_t i) { sink += hand.Value(points[i % count]); });
+    const double scalarCompiled = Measure(iterations * count, [&](size_t i) { sink += compiled.Value(points[i % count]); });
+    const double batchHand = Measure(iterations, [&](size_t) { hand.ValueBatch(block, values); }) / count;
+    const double batchCompiled = Measure(iterations, [&](size_t) { compiled.ValueBatch(block, values); }) / count;
+
+    std::cout << text << ": max error " << maxError << ", " << compiled.getValueSize() << " instructions, "
+              << compiled.getGradientSize() << " with the gradient" << std::endl;
+    std::cout << "    point: " << scalarCompiled << " ns (hand-written " << scalarHand << " ns)" << std::endl;
+    std::cout << "    block: " << batchCompiled << " ns per point (hand-written " << batchHand << " ns)" << (sink ? "" : " ") << std::endl;
+}
+
+int main()
+{
+    std::mt19937 generator(1);
+
+    Compare("3x^2+0.5y^2+2", F_2D::FuncQuadratic1(), 2, generator);
+    Compare("(1-x)^2+(y-x^2)^2", F_2D::FuncRosenbrock(), 2, generator);
+    Compare("\\sin(\\pi*sin(x)+\\pi*\\sin(y))", F_2D::FuncSinSin(), 2, generator);
+    Compare("(x^2+y-11)^2+(x+y^2-7)^2", F_2D::FuncHimmelblau(), 2, generator);
+    Compare("3x^2+0.5y^2+z^2+0.3xy+z+3y+2", F_3D::FuncQuadratic1(), 3, generator);
+    Compare("(1-x)^2+(x-y)^2+(y-z)^2+(z-w)^2", F_4D::FuncQuadratic1(), 4, generator);
+
+    return 0;
+}
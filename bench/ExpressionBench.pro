@@ -0,0 +1,28 @@
+TEMPLATE = app
+CONFIG += console c++20
+CONFIG -= qt app_bundle
+
+QMAKE_CXXFLAGS += -O2
+TARGET = ExpressionBench
+OBJECTS_DIR = ../obj/bench/
+INCLUDEPATH += ../src
+
+SOURCES += \
+    ExpressionBench.cpp \
+    ../src/Expression.cpp \
+    ../src/MathFunc.cpp \
+    ../src/PointKernels.cpp
+
+HEADERS += \
+    ../src/CachedFunction.h \
+    ../src/DiffStoper.h \
+    ../src/Expression.h \
+    ../src/GeneralFunction.h \
+    ../src/LineSearch.h \
+    ../src/MathFunc.h \
+    ../src/OptMethod.h \
+    ../src/Optimization.h \
+    ../src/Pathway.h \
+    ../src/Point.h \
+    ../src/PointKernels.h \
+    ../src/ThreadPool.h
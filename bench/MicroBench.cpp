@@ -0,0 +1,234 @@
+/// @file
+/// @brief Microbenchmark of Point operations, evaluations of functions and the one dimensional search.
+/// @details Every operation is repeated until it runs at least the minimum time, the count of repetitions is doubled
+/// from one. The program prints nanoseconds per operation, heap allocations and allocated bytes per operation
+/// (global operator new is replaced by a counting one) and the throughput: bytes of points read and written per second
+/// for operations of points, operations per second for functions and probes per second for the search.
+///
+/// Usage: MicroBench [-c cpu] [-t seconds] [-m maxdim]
+/// -c pins the program to a processor, so the scheduler does not move it between measurements.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <span>
+#include "DiffStoper.h"
+#include "FunctionCatalog.h"
+#include "OptMethod.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+static std::atomic<size_t> allocations{0};
+static std::atomic<size_t> allocatedBytes{0};
+
+// The replacements are not inlined, so the compiler does not pair malloc in new with operator delete.
+[[gnu::noinline]] void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+/// @brief Makes the compiler assume that a value is read, so its computation is not removed.
+template <class V>
+inline void Keep(const V& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+static double minTime = 0.1;
+
+/// @brief Measures an operation and prints a line.
+/// @param name Name of the operation.
+/// @param dim Dimension or zero if it does not apply.
+/// @param work Units of the throughput per operation.
+/// @param unit Name of the unit of the throughput.
+/// @param op Operation.
+template <class Op>
+void Measure(const char* name, size_t dim, double work, const char* unit, Op op)
+{
+    size_t count = 1;
+    double time = 0;
+    size_t allocs = 0, bytes = 0;
+
+    op();
+
+    for (;; count *= 2)
+    {
+        const size_t allocsBefore = allocations, bytesBefore = allocatedBytes;
+        const auto begin = std::chrono::steady_clock::now();
+
+        for (size_t i{}; i < count; ++i)
+            op();
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+        time = elapsed.count();
+        allocs = allocations - allocsBefore;
+        bytes = allocatedBytes - bytesBefore;
+
+        if (time >= minTime)
+            break;
+    }
+
+    const double ns = time * 1e9 / count;
+
+    std::cout << std::left << std::setw(44) << name << std::right << std::setw(9);
+
+    if (dim)
+        std::cout << dim;
+    else
+        std::cout << "-";
+
+    std::cout << std::fixed << std::setprecision(2) << std::setw(14) << ns << std::setw(10)
+              << static_cast<double>(allocs) / count << std::setw(14) << static_cast<double>(bytes) / count
+              << std::setw(12) << work / ns << " " << unit << std::defaultfloat << std::endl;
+}
+
+/// @brief The Conjugate Vector Method with the one dimensional search open for measurements.
+class LineSearch : public DetermOptimization<double>
+{
+public:
+    using DetermOptimization<double>::DetermOptimization;
+    using DetermOptimization<double>::OneDimensionalOptimBlock;
+};
+
+void PinCpu(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    if (sched_setaffinity(0, sizeof(set), &set))
+        std::cerr << "Cannot pin to the processor " << cpu << ", measurements are not pinned." << std::endl;
+    else
+        std::cout << "Pinned to the processor " << cpu << std::endl;
+#else
+    std::cerr << "Pinning is supported on Linux only, measurements are not pinned." << std::endl;
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+    size_t maxDim = 1 << 20;
+
+    for (int i{1}; i + 1 < argc; i += 2)
+        if (!std::strcmp(argv[i], "-c"))
+            PinCpu(std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "-t"))
+            minTime = std::max(1e-3, std::atof(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "-m"))
+            maxDim = std::max(2ul, std::strtoul(argv[i + 1], nullptr, 10));
+
+    std::cout << std::left << std::setw(44) << "operation" << std::right << std::setw(9) << "dim" << std::setw(14) << "ns/op"
+              << std::setw(10) << "allocs/op" << std::setw(14) << "bytes/op" << std::setw(12) << "throughput" << std::endl;
+
+    // Throughput of points counts 8 bytes per coordinate read or written.
+    for (size_t dim : {2ul, 16ul, 128ul, 1ul << 10, 1ul << 13, 1ul << 16, 1ul << 20})
+    {
+        if (dim > maxDim)
+            break;
+
+        const std::vector<double> values(dim, 1.5);
+        const Point<double> a(values), b(std::vector<double>(dim, 0.5));
+        Point<double> r = a;
+        const double bytes = 8.0 * dim, s = 0.75;
+
+        Measure("construction from a container", dim, 2 * bytes, "GB/s", [&] { Point<double> p(values); Keep(p[0]); });
+        Measure("copy construction", dim, 2 * bytes, "GB/s", [&] { Point<double> p = a; Keep(p[0]); });
+        Measure("copy assignment", dim, 2 * bytes, "GB/s", [&] { r = a; Keep(r[0]); });
+        Measure("a + b into a temporary", dim, 3 * bytes, "GB/s", [&] { Point<double> p = a + b; Keep(p[0]); });
+        Measure("r = a + b", dim, 3 * bytes, "GB/s", [&] { r = a + b; Keep(r[0]); });
+        Measure("r = s * a", dim, 2 * bytes, "GB/s", [&] { r = s * a; Keep(r[0]); });
+        Measure("dot a * b", dim, 2 * bytes, "GB/s", [&] { Keep(a * b); });
+        Measure("operator[] over all coordinates", dim, bytes, "GB/s", [&]
+        {
+            double sum = 0;
+
+            for (size_t i{}; i < dim; ++i)
+                sum += a[i];
+
+            Keep(sum);
+        });
+    }
+
+    FunctionCatalog catalog;
+
+    for (const FunctionData<double>& fd : catalog.getFunctions())
+    {
+        const Point<double> p = fd.start;
+        Point<double> gradient = p;
+        const std::string value = "Value " + fd.name, grad = "Gradient " + fd.name;
+
+        Measure(value.c_str(), p.size(), 1e3, "Mop/s", [&] { Keep(fd.f.Value(p)); });
+        Measure(grad.c_str(), p.size(), 1e3, "Mop/s", [&] { gradient = fd.f.Gradient(p); Keep(gradient[0]); });
+    }
+
+    // The search of the method with the default parameters of the programs on fixed functions on [0, 1].
+    struct OneFunction
+    {
+        const char* name;
+        double (*f)(double);
+    };
+
+    const OneFunction oneFunctions[] = {
+        {"search (x - 0.3)^2", [](double x) { return (x - 0.3) * (x - 0.3); }},
+        {"search sin(20x) + x", [](double x) { return std::sin(20 * x) + x; }},
+        {"search |x - 0.7|", [](double x) { return std::abs(x - 0.7); }},
+        {"search exp(x) - 2x", [](double x) { return std::exp(x) - 2 * x; }}};
+
+    F_2D::FuncNull null;
+    NumStop<double> stop(1);
+    LineSearch search(null, stop, 1e-6, 1e-2);
+
+    for (const OneFunction& one : oneFunctions)
+    {
+        size_t probes = 0;
+        double res = 0;
+
+        // The method evaluates probes of a round by one call of the block, here they are evaluated in a loop.
+        const auto block = [&one](std::span<const double> args, std::span<double> values)
+        {
+            for (size_t i{}; i < args.size(); ++i)
+                values[i] = one.f(args[i]);
+        };
+
+        search.OneDimensionalOptimBlock(0.0, 1.0, one.f(0), res, [&](std::span<const double> args, std::span<double> values)
+        {
+            probes += args.size();
+            block(args, values);
+        });
+
+        const std::string name = std::string(one.name) + ", " + std::to_string(probes) + " probes";
+
+        Measure(name.c_str(), 0, 1e3 * static_cast<double>(probes), "Mprobe/s", [&]
+        {
+            Keep(search.OneDimensionalOptimBlock(0.0, 1.0, one.f(0), res, block));
+            Keep(res);
+        });
+    }
+
+    return 0;
+}
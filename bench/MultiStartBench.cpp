@@ -0,0 +1,117 @@
+/// @file
+/// @brief Benchmark of the multi-start engine.
+/// @details The Conjugate Vector Method and the Stochastic Method are run from many start points of every kind
+/// on multimodal functions by pools of different sizes. The program prints the time, the speedup over one thread,
+/// the best minima and checks that minima do not depend on the count of threads.
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include "DiffStoper.h"
+#include "MathFunc.h"
+#include "MultiStart.h"
+#include "OptMethod.h"
+#include "ScalableFunc.h"
+
+const char* Name(StartSampling sampling)
+{
+    switch (sampling)
+    {
+    case StartSampling::Uniform:
+        return "uniform";
+    case StartSampling::LatinHypercube:
+        return "Latin hypercube";
+    default:
+        return "Sobol";
+    }
+}
+
+bool Equal(const std::vector<LocalMinimum<double>>& a, const std::vector<LocalMinimum<double>>& b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (size_t i{}; i < a.size(); ++i)
+        if (a[i].value != b[i].value || a[i].count != b[i].count || a[i].run != b[i].run)
+            return false;
+
+    return true;
+}
+
+void Run(const char* name, const CubicArea<double>& area, const MultiStart<double>::MethodFactory& makeMethod,
+         size_t count, double distance)
+{
+    // At least four threads, so work stealing is exercised on small machines too.
+    const size_t threads = std::max(4u, std::thread::hardware_concurrency());
+    auto makeStop = []() -> std::unique_ptr<GeneralStop<double>>
+    {
+        struct Stop : AnyOf<double>
+        {
+            NumStop<double> num{200};
+            RelStop<double> rel{1e-10, 5};
+
+            Stop() : AnyOf<double>({&num, &rel}) {}
+        };
+
+        return std::make_unique<Stop>();
+    };
+
+    std::cout << name << ", " << count << " starts" << std::endl;
+
+    for (StartSampling sampling : {StartSampling::Uniform, StartSampling::LatinHypercube, StartSampling::Sobol})
+    {
+        const std::vector<Point<double>> starts = GenerateStarts(area, count, sampling, 7);
+        std::vector<LocalMinimum<double>> serial, minima;
+        double timeSerial = 0, time = 0;
+
+        for (size_t size : {size_t{1}, threads})
+        {
+            ThreadPool pool(size - 1);
+            MultiStart<double> engine(makeMethod, makeStop, pool, distance);
+            const auto begin = std::chrono::steady_clock::now();
+
+            minima = engine.Run(area, starts, 11);
+            time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+            if (size == 1)
+            {
+                serial = minima;
+                timeSerial = time;
+            }
+        }
+
+        std::cout << "    " << Name(sampling) << ": " << minima.size() << " minima, " << timeSerial << " ms on 1 thread, " << time << " ms on "
+                  << threads << " threads (x" << timeSerial / time << ")" << (Equal(serial, minima) ? "" : ", results differ") << std::endl;
+
+        for (size_t i{}; i < std::min<size_t>(minima.size(), 4); ++i)
+            std::cout << "        " << minima[i].value << " at " << minima[i].point << "from " << minima[i].count << " starts" << std::endl;
+    }
+}
+
+int main()
+{
+    F_2D::FuncHimmelblau himmelblau;
+    F_2D::FuncSinSin sinSin;
+    F_ND::FuncRastrigin rastrigin(5);
+
+    auto determ = [](GeneralFunction<double>& f)
+    {
+        return [&f](GeneralStop<double>& stop) -> std::unique_ptr<Optimization<double>>
+        {
+            return std::make_unique<DetermOptimization<double>>(f, stop, 1e-6, 1e-1);
+        };
+    };
+    auto stochast = [](GeneralFunction<double>& f)
+    {
+        return [&f](GeneralStop<double>& stop) -> std::unique_ptr<Optimization<double>>
+        {
+            return std::make_unique<StochastOptimization<double>>(f, stop, 0.8, 0.5, 0, 0.9);
+        };
+    };
+
+    Run("Himmelblau, Conjugate Vector Method", {Point<double>({-5, -5}), Point<double>({5, 5})}, determ(himmelblau), 256, 1e-3);
+    Run("Himmelblau, Stochastic Method", {Point<double>({-5, -5}), Point<double>({5, 5})}, stochast(himmelblau), 256, 0.5);
+    Run("SinSin, Conjugate Vector Method", {Point<double>({-10, -10}), Point<double>({10, 10})}, determ(sinSin), 256, 1e-3);
+    Run("Rastrigin, N = 5, Conjugate Vector Method", rastrigin.getArea(), determ(rastrigin), 1024, 1e-3);
+
+    return 0;
+}
@@ -0,0 +1,30 @@
+TEMPLATE = app
+CONFIG += console c++20
+CONFIG -= qt app_bundle
+
+QMAKE_CXXFLAGS += -O2
+TARGET = MultiStartBench
+OBJECTS_DIR = ../obj/bench/
+INCLUDEPATH += ../src
+
+SOURCES += \
+    MultiStartBench.cpp \
+    ../src/MathFunc.cpp \
+    ../src/PointKernels.cpp \
+    ../src/ScalableFunc.cpp
+
+HEADERS += \
+    ../src/CachedFunction.h \
+    ../src/DiffStoper.h \
+    ../src/GeneralFunction.h \
+    ../src/InstrumentedFunction.h \
+    ../src/LineSearch.h \
+    ../src/MathFunc.h \
+    ../src/MultiStart.h \
+    ../src/OptMethod.h \
+    ../src/Optimization.h \
+    ../src/Pathway.h \
+    ../src/Point.h \
+    ../src/PointKernels.h \
+    ../src/ScalableFunc.h \
+    ../src/ThreadPool.h
@@ -0,0 +1,131 @@
+/// @file
+/// @brief Benchmark of the Newton-CG method.
+/// @details The Conjugate Vector Method and the Newton-CG method with analytic, automatically differentiated
+/// and finite-difference products of the Hessian and vectors are run until the gap to the known minimum is below
+/// a tolerance. The program prints the count of evaluations by kinds, the count of iterations and the time.
+/// A product by differences costs two more gradients, they are not counted separately.
+#include <chrono>
+#include <iostream>
+#include "AutoDiff.h"
+#include "MathFunc.h"
+#include "NewtonOptim.h"
+#include "OptMethod.h"
+#include "ScalableFunc.h"
+
+/// @brief Stopper which stops when the gap to the minimum is below a tolerance.
+class GapStop : public GeneralStop<double>
+{
+private:
+    double minimum;
+    double tolerance;
+public:
+    GapStop(double _minimum, double _tolerance, size_t _maxStep) : GeneralStop<double>(_maxStep), minimum(_minimum), tolerance(_tolerance) {}
+
+    bool condition(const IterationState<double>& state) override
+    {
+        return state.iteration < maxStep && state.value - minimum > tolerance;
+    }
+};
+
+/// @brief Function without its own Hessian-vector product: products are differences of gradients.
+class DifferenceHessian : public GeneralFunction<double>
+{
+private:
+    const GeneralFunction<double>& f;
+public:
+    DifferenceHessian(const GeneralFunction<double>& _f) : f(_f) {}
+
+    double Value(const Point<double>& p) const override { return f.Value(p); }
+    Point<double> Gradient(const Point<double>& p) const override { return f.Gradient(p); }
+    double ValueAndGradient(const Point<double>& p, Point<double>& gradient) const override { return f.ValueAndGradient(p, gradient); }
+};
+
+struct Rosenbrock
+{
+    template <class P>
+    auto operator()(const P& p) const
+    {
+        return (1 - p[0]) * (1 - p[0]) + (p[1] - p[0] * p[0]) * (p[1] - p[0] * p[0]);
+    }
+};
+
+void Print(const char* method, const Optimization<double>& opt, double minimum, bool reached)
+{
+    const RunSummary<double> summary = opt.getSummary();
+    const auto& calls = summary.calls;
+
+    std::cout << "    " << method << ": " << summary.iterations - 1 << " iterations, "
+              << calls[static_cast<size_t>(FunctionCall::Value)].points << " values, "
+              << calls[static_cast<size_t>(FunctionCall::Gradient)].points + calls[static_cast<size_t>(FunctionCall::ValueAndGradient)].points
+              << " gradients, " << calls[static_cast<size_t>(FunctionCall::HessianVector)].points << " Hessian-vector products, "
+              << summary.time / 1e3 << " us, gap " << summary.valueEnd - minimum << (reached ? "" : " (not reached)") << std::endl;
+}
+
+void Compare(const char* name, GeneralFunction<double>& f, double minimum, const CubicArea<double>& area, const Point<double>& start,
+             GeneralFunction<double>* ad = nullptr)
+{
+    const double tolerance = 1e-8;
+    const size_t maxStep = 5000;
+    GapStop stop(minimum, tolerance, maxStep);
+    DifferenceHessian difference(f);
+
+    std::cout << name << ", N = " << start.size() << ", tolerance " << tolerance << std::endl;
+
+    DetermOptimization<double> determ(f, stop, 1e-7, 0.1);
+    determ.SetArea(area.minArea, area.maxArea);
+    determ.DoOptimize(start);
+    Print("Conjugate Vector Method", determ, minimum, determ.getValueLastPoint() - minimum <= tolerance);
+
+    NewtonOptimization<double> newton(f, stop, 1);
+    newton.SetArea(area.minArea, area.maxArea);
+    newton.DoOptimize(start);
+    Print("Newton-CG, analytic", newton, minimum, newton.getValueLastPoint() - minimum <= tolerance);
+
+    if (ad)
+    {
+        newton.SetParam(*ad, stop, 1);
+        newton.SetArea(area.minArea, area.maxArea);
+        newton.DoOptimize(start);
+        Print("Newton-CG, automatic", newton, minimum, newton.getValueLastPoint() - minimum <= tolerance);
+    }
+
+    newton.SetParam(difference, stop, 1);
+    newton.SetArea(area.minArea, area.maxArea);
+    newton.DoOptimize(start);
+    Print("Newton-CG, differences", newton, minimum, newton.getValueLastPoint() - minimum <= tolerance);
+}
+
+void Compare(F_ND::ScalableFunction& f)
+{
+    const CubicArea<double> area = f.getArea();
+    Point<double> start = f.getOptimum();
+
+    for (size_t i{}; i < start.size(); ++i)
+        start[i] = (start[i] + area.maxArea[i]) / 2;
+
+    Compare(f.getName(), f, f.getOptimumValue(), area, start);
+}
+
+int main()
+{
+    F_2D::FuncRosenbrock rosenbrock;
+    AutoDiffFunction<double, 2, Rosenbrock> rosenbrockAD;
+
+    Compare("Rosenbrock 2D", rosenbrock, 0, {Point<double>({-2, -2}), Point<double>({2, 2})}, Point<double>({-1.2, 1}), &rosenbrockAD);
+
+    F_ND::FuncRosenbrock rosenbrock100(100);
+    F_ND::FuncQuadratic quadratic(1000, 1e4);
+    F_ND::FuncQuadraticChain chain(1000);
+    F_ND::FuncQuadratic rotated(1000, 1e4);
+
+    rotated.SetRandomShift(1);
+    rotated.SetRotation(16, 2);
+
+    Compare(rosenbrock100);
+    Compare(quadratic);
+    Compare(chain);
+    std::cout << "Rotated and shifted: ";
+    Compare(rotated);
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+/// @file
+/// @brief Benchmark of reverse-mode automatic differentiation.
+/// @details The N-dimensional generalization of F_4D::FuncQuadratic1 (1-x_0)^2 + sum (x_{i-1}-x_i)^2 is differentiated
+/// by replaying a tape and by central finite differences. The program prints the time of a value, of a gradient
+/// by the tape and of a gradient by finite differences, and the maximum error against the analytic gradient.
+#include <chrono>
+#include <iostream>
+#include <random>
+#include "ReverseDiff.h"
+
+struct QuadraticChain
+{
+    template <class P>
+    auto operator()(const P& p) const
+    {
+        auto res = (1 - p[0]) * (1 - p[0]);
+
+        for (size_t i{1}; i < p.size(); ++i)
+            res += (p[i - 1] - p[i]) * (p[i - 1] - p[i]);
+
+        return res;
+    }
+};
+
+/// @brief Analytic gradient of QuadraticChain.
+Point<double> ChainGradient(const Point<double>& p)
+{
+    Point<double> g(std::vector<double>(p.size(), 0));
+    g[0] = -2 * (1 - p[0]);
+
+    for (size_t i{1}; i < p.size(); ++i)
+    {
+        g[i - 1] += 2 * (p[i - 1] - p[i]);
+        g[i] -= 2 * (p[i - 1] - p[i]);
+    }
+
+    return g;
+}
+
+/// @brief Gradient by central finite differences: 2N evaluations.
+Point<double> FiniteDifferences(const GeneralFunction<double>& f, Point<double> p)
+{
+    Point<double> g(std::vector<double>(p.size(), 0));
+
+    for (size_t i{}; i < p.size(); ++i)
+    {
+        const double x = p[i], h = 1e-6 * std::max(1.0, std::abs(x));
+
+        p[i] = x + h;
+        const double right = f.Value(p);
+        p[i] = x - h;
+        const double left = f.Value(p);
+        p[i] = x;
+
+        g[i] = (right - left) / (2 * h);
+    }
+
+    return g;
+}
+
+template <class Op>
+double Measure(size_t iterations, Op op)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i{}; i < iterations; ++i)
+        op();
+
+    std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - start;
+
+    return time.count() / iterations;
+}
+
+int main()
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> distr(-2, 2);
+    ReverseDiffFunction<double, QuadraticChain> f;
+
+    for (size_t dim : {10, 100, 1000, 10000})
+    {
+        std::vector<double> x(dim);
+
+        for (double& a : x)
+            a = distr(generator);
+
+        Point<double> p(x), gradient;
+        const Point<double> exact = ChainGradient(p);
+        double sink = 0, tapeError = 0, fdError = 0;
+
+        f.ValueAndGradient(p, gradient);
+        const Point<double> fd = FiniteDifferences(f, p);
+
+        for (size_t i{}; i < dim; ++i)
+        {
+            tapeError = std::max(tapeError, std::abs(gradient[i] - exact[i]));
+            fdError = std::max(fdError, std::abs(fd[i] - exact[i]));
+        }
+
+        const size_t iterations = 1000000 / dim + 1;
+        const double value = Measure(iterations, [&] { sink += f.Value(p); });
+        const double tape = Measure(iterations, [&] { sink += f.ValueAndGradient(p, gradient); });
+        const double finite = Measure(dim < 10000 ? iterations : 3, [&] { sink += FiniteDifferences(f, p)[0]; });
+
+        std::cout << "N=" << dim << ": Value " << value << " us, tape gradient " << tape << " us (" << tape / value
+                  << "x value, error " << tapeError << "), finite differences " << finite << " us (" << finite / value
+                  << "x value, error " << fdError << "), tape size " << f.getTape().getSize() << " (checksum " << sink << ")"
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+TEMPLATE = app
+CONFIG += console c++20
+CONFIG -= qt app_bundle
+
+QMAKE_CXXFLAGS += -O2
+TARGET = ReverseDiffBench
+OBJECTS_DIR = ../obj/bench/
+INCLUDEPATH += ../src
+
+SOURCES += \
+    ReverseDiffBench.cpp \
+    ../src/PointKernels.cpp
+
+HEADERS += \
+    ../src/GeneralFunction.h \
+    ../src/ReverseDiff.h \
+    ../src/Optimization.h \
+    ../src/Pathway.h \
+    ../src/Point.h
@@ -0,0 +1,84 @@
+/// @file
+/// @brief Benchmark of optimization methods on functions of large dimensions.
+/// @details The Conjugate Vector Method and the Stochastic Method are run on the functions of ScalableFunc.h
+/// from ten to a million dimensions, plain and with the shift and the rotation. The program prints the time
+/// of one evaluation, the time of one iteration of every method and the gap to the known minimum.
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include "DiffStoper.h"
+#include "OptMethod.h"
+#include "ScalableFunc.h"
+
+template <class Run>
+double Measure(size_t iterations, Run run)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i{}; i < iterations; ++i)
+        run();
+
+    std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - start;
+
+    return time.count() / iterations;
+}
+
+void Run(F_ND::ScalableFunction& f, bool transformed)
+{
+    const size_t dim = f.getDimension(), maxStep = dim > 10000 ? 3 : 20;
+    const CubicArea<double> area = f.getArea();
+
+    if (transformed)
+    {
+        f.SetRandomShift(1);
+        f.SetRotation(16, 2);
+    }
+
+    // The start is in the middle between the optimum and the corner of the area.
+    Point<double> start = f.getOptimum(), gradient;
+
+    for (size_t i{}; i < dim; ++i)
+        start[i] = (start[i] + area.maxArea[i]) / 2;
+
+    double sink = 0;
+    const double value = Measure(dim > 10000 ? 10 : 1000, [&] { sink += f.Value(start); });
+    const double both = Measure(dim > 10000 ? 10 : 1000, [&] { sink += f.ValueAndGradient(start, gradient); });
+
+    NumStop<double> stop(maxStep);
+    DetermOptimization<double> determ(f, stop, 1e-4, 0.1);
+    StochastOptimization<double> stochast(f, stop, 0.8, 0.1, 1, 0.9);
+
+    determ.SetArea(area.minArea, area.maxArea);
+    stochast.SetArea(area.minArea, area.maxArea);
+
+    const double timeDeterm = Measure(1, [&] { determ.DoOptimize(start); }) / maxStep;
+    const double timeStochast = Measure(1, [&] { stochast.DoOptimize(start); }) / maxStep;
+
+    std::cout << f.getName() << (transformed ? " shifted and rotated" : "") << ", N = " << dim << (sink ? "" : " ") << std::endl;
+    std::cout << "    value: " << value << " us, value and gradient: " << both << " us" << std::endl;
+    std::cout << "    Conjugate Vector Method: " << timeDeterm << " us per iteration, gap "
+              << determ.getValueLastPoint() - f.getOptimumValue() << " from " << f.Value(start) - f.getOptimumValue() << std::endl;
+    std::cout << "    Stochastic Method: " << timeStochast << " us per iteration, gap "
+              << stochast.getValueLastPoint() - f.getOptimumValue() << std::endl;
+}
+
+int main()
+{
+    for (size_t dim : {10, 1000, 100000, 1000000})
+        for (bool transformed : {false, true})
+        {
+            std::vector<std::unique_ptr<F_ND::ScalableFunction>> functions;
+            functions.emplace_back(new F_ND::FuncRosenbrock(dim));
+            functions.emplace_back(new F_ND::FuncRastrigin(dim));
+            functions.emplace_back(new F_ND::FuncAckley(dim));
+            functions.emplace_back(new F_ND::FuncGriewank(dim));
+            functions.emplace_back(new F_ND::FuncStyblinskiTang(dim));
+            functions.emplace_back(new F_ND::FuncQuadratic(dim));
+            functions.emplace_back(new F_ND::FuncQuadraticChain(dim));
+
+            for (auto& f : functions)
+                Run(*f, transformed);
+        }
+
+    return 0;
+}
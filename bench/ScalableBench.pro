@@ -0,0 +1,27 @@
+TEMPLATE = app
+CONFIG += console c++20
+CONFIG -= qt app_bundle
+
+QMAKE_CXXFLAGS += -O2
+TARGET = ScalableBench
+OBJECTS_DIR = ../obj/bench/
+INCLUDEPATH += ../src
+
+SOURCES += \
+    ScalableBench.cpp \
+    ../src/PointKernels.cpp \
+    ../src/ScalableFunc.cpp
+
+HEADERS += \
+    ../src/CachedFunction.h \
+    ../src/DiffStoper.h \
+    ../src/GeneralFunction.h \
+    ../src/InstrumentedFunction.h \
+    ../src/LineSearch.h \
+    ../src/OptMethod.h \
+    ../src/Optimization.h \
+    ../src/Pathway.h \
+    ../src/Point.h \
+    ../src/PointKernels.h \
+    ../src/ScalableFunc.h \
+    ../src/ThreadPool.h
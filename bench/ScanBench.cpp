@@ -0,0 +1,101 @@
+/// @file
+/// @brief Benchmark of the scan of the Conjugate Vector Method on pools of threads.
+/// @details The method with the global scan runs on functions of the catalog and on functions of ScalableFunc.h,
+/// whose evaluations are expensive. Probes of a round of the scan are evaluated as a block, chunks of the block
+/// are evaluated on the pool. The program prints the time of one iteration for every count of threads,
+/// the speedup against the calling thread alone and checks that the pathway does not depend on the count of threads.
+///
+/// Usage: ScanBench [-j maxThreads]
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include "DiffStoper.h"
+#include "FunctionCatalog.h"
+#include "OptMethod.h"
+#include "ScalableFunc.h"
+
+/// @brief Runs the method and returns microseconds per iteration.
+double Run(DetermOptimization<double>& determ, const CubicArea<double>& area, const Point<double>& start, size_t maxStep, Pathway<double>& pathway)
+{
+    // SetArea clears the pathway of the previous run.
+    determ.SetArea(area.minArea, area.maxArea);
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    determ.DoOptimize(start);
+
+    const std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - begin;
+    pathway = determ.getPathway();
+
+    return time.count() / maxStep;
+}
+
+void Compare(const std::string& name, GeneralFunction<double>& f, const CubicArea<double>& area, const Point<double>& start,
+             size_t maxStep, size_t maxThreads)
+{
+    NumStop<double> stop(maxStep);
+    DetermOptimization<double> determ(f, stop, 1e-6, 1e-2, LineSearchMode::Scan);
+    Pathway<double> serial, parallel;
+    const double timeSerial = Run(determ, area, start, maxStep, serial);
+
+    std::cout << name << ", N = " << start.size() << std::endl;
+    std::cout << "    1 thread: " << timeSerial << " us per iteration" << std::endl;
+
+    for (size_t threads = 2; threads <= maxThreads; threads *= 2)
+    {
+        ThreadPool pool(threads - 1);
+        determ.SetPool(&pool);
+
+        const double time = Run(determ, area, start, maxStep, parallel);
+        bool same = serial.size() == parallel.size();
+
+        for (size_t i{}; same && i < serial.size(); ++i)
+            for (size_t j{}; j < serial[i].size(); ++j)
+                same = same && serial[i][j] == parallel[i][j];
+
+        std::cout << "    " << threads << " threads: " << time << " us per iteration, speedup " << timeSerial / time
+                  << (same ? "" : ", PATHWAY DIFFERS") << std::endl;
+
+        determ.SetPool(nullptr);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t maxThreads = std::max(2u, std::thread::hardware_concurrency());
+
+    for (int i{1}; i + 1 < argc; i += 2)
+        if (!std::strcmp(argv[i], "-j"))
+            maxThreads = std::max(1ul, std::strtoul(argv[i + 1], nullptr, 10));
+
+    FunctionCatalog catalog;
+
+    for (const FunctionData<double>& fd : catalog.getFunctions())
+        Compare(fd.name, fd.f, {fd.minArea, fd.maxArea}, fd.start, 5, maxThreads);
+
+    for (size_t dim : {100, 10000})
+    {
+        std::vector<std::unique_ptr<F_ND::ScalableFunction>> functions;
+        functions.emplace_back(new F_ND::FuncRastrigin(dim));
+        functions.emplace_back(new F_ND::FuncAckley(dim));
+
+        for (auto& f : functions)
+        {
+            f->SetRandomShift(1);
+            f->SetRotation(16, 2);
+
+            const CubicArea<double> area = f->getArea();
+            // The start is in the middle between the optimum and the corner of the area.
+            Point<double> start = f->getOptimum();
+
+            for (size_t i{}; i < dim; ++i)
+                start[i] = (start[i] + area.maxArea[i]) / 2;
+
+            Compare(std::string(f->getName()) + " shifted and rotated", *f, area, start, 2, maxThreads);
+        }
+    }
+
+    return 0;
+}
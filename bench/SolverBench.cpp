@@ -0,0 +1,466 @@
+/// @file
+/// @brief End-to-end benchmark of optimization methods with comparison against a baseline.
+/// @details Every method is run with every stopper on the functions of the catalog and on the scalable functions.
+/// A case is repeated several times after a warm-up run, a sample of a short case is the mean time of several runs.
+/// For a case the program reports the wall time of every sample,
+/// counts of evaluations of values, gradients and Hessian-vector products, iterations, the final gap to the known minimum
+/// and the time-to-tolerance curve: the time and the evaluations at which the gap first fell below 1e-1, ..., 1e-8.
+/// Results are written as JSON with one case per line.
+///
+/// With a baseline the program compares wall times of equal cases by the one-sided Mann-Whitney test
+/// and flags a case as slower if the test is significant and the median grew by more than the threshold.
+/// The exit code is 1 if a case is slower.
+///
+/// Usage: SolverBench [-r repetitions] [-o results.json] [-b baseline.json] [-t threshold] [-a alpha] [-f filter]
+///        SolverBench --compare baseline.json results.json
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include "DiffStoper.h"
+#include "FunctionCatalog.h"
+#include "NewtonOptim.h"
+#include "OptMethod.h"
+#include "ScalableFunc.h"
+
+/// @brief Gaps of the time-to-tolerance curve.
+constexpr double TOLERANCES[] = {1e-1, 1e-2, 1e-3, 1e-4, 1e-5, 1e-6, 1e-7, 1e-8};
+constexpr size_t COUNTTOL = std::size(TOLERANCES);
+/// @brief Minimum time of a sample in nanoseconds.
+constexpr double MINSAMPLE = 2e6;
+
+/// @brief Stopper which records the time, the evaluations and the value of every iteration and asks another stopper.
+class TraceStop : public GeneralStop<double>
+{
+private:
+    GeneralStop<double>* stop;
+public:
+    std::vector<double> elapsed;
+    std::vector<size_t> evaluations;
+    std::vector<double> values;
+
+    TraceStop(GeneralStop<double>& _stop) : GeneralStop<double>(NOSTEPLIMIT), stop(&_stop) {}
+
+    size_t getMaxStep() const override { return stop->getMaxStep(); }
+
+    void Reset() override
+    {
+        elapsed.clear();
+        evaluations.clear();
+        values.clear();
+        stop->Reset();
+    }
+
+    bool condition(const IterationState<double>& state) override
+    {
+        elapsed.push_back(state.elapsed);
+        evaluations.push_back(state.evaluations);
+        values.push_back(state.value);
+
+        return stop->condition(state);
+    }
+};
+
+struct Case
+{
+    std::string id;
+    std::string method;
+    std::string stop;
+    std::string function;
+    GeneralFunction<double>* f;
+    CubicArea<double> area;
+    Point<double> start;
+    double optimum;
+    size_t maxStep;
+};
+
+struct Measurement
+{
+    std::vector<double> samples;
+    size_t iterations = 0;
+    size_t values = 0;
+    size_t gradients = 0;
+    size_t products = 0;
+    double gap = 0;
+    /// @brief Time in nanoseconds and evaluations at which the gap first fell below a tolerance. Negative time if it did not.
+    double tolTime[COUNTTOL];
+    size_t tolEvaluations[COUNTTOL];
+};
+
+double Median(std::vector<double> x)
+{
+    std::sort(x.begin(), x.end());
+
+    return x.size() % 2 ? x[x.size() / 2] : (x[x.size() / 2 - 1] + x[x.size() / 2]) / 2;
+}
+
+/// @brief One-sided p-value of the Mann-Whitney test of the hypothesis that current times are larger than baseline ones.
+/// @details The exact distribution of U is counted for small samples, the normal approximation is used for large ones.
+/// Ties count one half, U is rounded down, so the test is conservative.
+double MannWhitney(const std::vector<double>& baseline, const std::vector<double>& current)
+{
+    const size_t m = baseline.size(), n = current.size();
+    double u = 0;
+
+    for (double b : baseline)
+        for (double c : current)
+            u += c > b ? 1 : (c == b ? 0.5 : 0);
+
+    if (!m || !n)
+        return 1;
+
+    if (m * n > 2500)
+    {
+        const double mean = m * n / 2.0, sigma = std::sqrt(m * n * (m + n + 1) / 12.0);
+
+        return 0.5 * std::erfc((u - 0.5 - mean) / sigma / std::sqrt(2.0));
+    }
+
+    // count[i][j][k] is the count of orders of i baseline and j current samples with U = k.
+    const size_t maxU = m * n;
+    std::vector<std::vector<std::vector<double>>> count(m + 1, std::vector<std::vector<double>>(n + 1, std::vector<double>(maxU + 1)));
+
+    for (size_t i{}; i <= m; ++i)
+        for (size_t j{}; j <= n; ++j)
+            for (size_t k{}; k <= i * j; ++k)
+                if (!i || !j)
+                    count[i][j][k] = k == 0;
+                else
+                    // The largest sample is a current one (it exceeds i baseline samples) or a baseline one.
+                    count[i][j][k] = (k >= i ? count[i][j - 1][k - i] : 0) + count[i - 1][j][k];
+
+    double total = 0, tail = 0;
+
+    for (size_t k{}; k <= maxU; ++k)
+    {
+        total += count[m][n][k];
+
+        if (k >= static_cast<size_t>(u))
+            tail += count[m][n][k];
+    }
+
+    return tail / total;
+}
+
+Measurement Measure(const Case& c, size_t repetitions)
+{
+    NumStop<double> num(c.maxStep);
+    AbsStop<double> abs(c.maxStep, 1e-6);
+    GradStop<double> grad(1e-6);
+    RelStop<double> rel(1e-10, 3);
+    AnyOf<double> numGrad({&num, &grad}), numRel({&num, &rel});
+    GeneralStop<double>* inner = c.stop == "num" ? static_cast<GeneralStop<double>*>(&num) : c.stop == "abs" ? static_cast<GeneralStop<double>*>(&abs)
+                                 : c.stop == "grad" ? static_cast<GeneralStop<double>*>(&numGrad) : &numRel;
+    TraceStop trace(*inner);
+    std::unique_ptr<Optimization<double>> method;
+
+    if (c.method == "determ")
+        method = std::make_unique<DetermOptimization<double>>(*c.f, trace, 1e-6, 1e-2);
+    else if (c.method == "stochast")
+        method = std::make_unique<StochastOptimization<double>>(*c.f, trace, 0.6, 0.1, 1, 0.2);
+    else
+        method = std::make_unique<NewtonOptimization<double>>(*c.f, trace, 1.0);
+
+    Measurement res;
+
+    // Runs are equal: the area and the seed are set before every run.
+    auto run = [&method, &c](size_t count)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+
+        for (size_t i{}; i < count; ++i)
+        {
+            method->SetArea(c.area.minArea, c.area.maxArea);
+            method->SetSeed(1);
+            method->DoOptimize(c.start);
+        }
+
+        const std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - begin;
+
+        return time.count() / count;
+    };
+
+    // The first run warms caches and is not measured. A sample of a short case is the mean of runs of MINSAMPLE,
+    // so the timer and short disturbances do not dominate it.
+    const size_t batch = static_cast<size_t>(std::ceil(MINSAMPLE / std::max(run(1), 1.0)));
+
+    for (size_t r{}; r < repetitions; ++r)
+        res.samples.push_back(run(batch));
+
+    const RunSummary<double> summary = method->getSummary();
+    auto points = [&summary](FunctionCall kind) { return summary.calls[static_cast<size_t>(kind)].points; };
+
+    res.iterations = summary.iterations;
+    res.values = points(FunctionCall::Value) + points(FunctionCall::ValueAndGradient) + points(FunctionCall::ValueBatch);
+    res.gradients = points(FunctionCall::Gradient) + points(FunctionCall::ValueAndGradient) + points(FunctionCall::GradientBatch);
+    res.products = points(FunctionCall::HessianVector);
+    res.gap = summary.valueEnd - c.optimum;
+
+    for (size_t t{}; t < COUNTTOL; ++t)
+    {
+        res.tolTime[t] = -1;
+        res.tolEvaluations[t] = 0;
+
+        for (size_t i{}; i < trace.values.size(); ++i)
+            if (trace.values[i] - c.optimum <= TOLERANCES[t])
+            {
+                res.tolTime[t] = trace.elapsed[i];
+                res.tolEvaluations[t] = trace.evaluations[i];
+
+                break;
+            }
+    }
+
+    return res;
+}
+
+std::string JsonNumber(double value)
+{
+    if (!std::isfinite(value))
+        return "null";
+
+    std::ostringstream ss;
+    ss << std::setprecision(10) << value;
+
+    return ss.str();
+}
+
+std::string JsonText(const std::string& text)
+{
+    std::string res = "\"";
+
+    for (char c : text)
+        res += c == '"' || c == '\\' ? std::string("\\") + c : std::string(1, c);
+
+    return res + "\"";
+}
+
+void Write(std::ostream& out, const Case& c, const Measurement& m, bool last)
+{
+    out << "  {\"id\":" << JsonText(c.id) << ",\"method\":" << JsonText(c.method) << ",\"stop\":" << JsonText(c.stop)
+        << ",\"function\":" << JsonText(c.function) << ",\"dimension\":" << c.start.size()
+        << ",\"time_ns\":" << JsonNumber(Median(m.samples)) << ",\"samples_ns\":[";
+
+    for (size_t i{}; i < m.samples.size(); ++i)
+        out << (i ? "," : "") << JsonNumber(m.samples[i]);
+
+    out << "],\"iterations\":" << m.iterations << ",\"value_evaluations\":" << m.values << ",\"gradient_evaluations\":" << m.gradients
+        << ",\"hessian_products\":" << m.products << ",\"gap\":" << JsonNumber(m.gap) << ",\"time_to_tolerance\":[";
+
+    for (size_t t{}; t < COUNTTOL; ++t)
+        out << (t ? "," : "") << "{\"gap\":" << JsonNumber(TOLERANCES[t]) << ",\"time_ns\":"
+            << (m.tolTime[t] < 0 ? "null" : JsonNumber(m.tolTime[t])) << ",\"evaluations\":"
+            << (m.tolTime[t] < 0 ? "null" : std::to_string(m.tolEvaluations[t])) << "}";
+
+    out << "]}" << (last ? "" : ",") << "\n";
+}
+
+/// @brief Reads wall times of cases from a file written by this program. Every case is on its own line.
+std::map<std::string, std::vector<double>> ReadSamples(const char* name)
+{
+    std::ifstream in(name);
+    std::map<std::string, std::vector<double>> res;
+    std::string line;
+
+    if (!in.is_open())
+        throw std::invalid_argument(std::string("Cannot open ") + name + ".");
+
+    while (std::getline(in, line))
+    {
+        const size_t id = line.find("{\"id\":\""), samples = line.find("\"samples_ns\":[");
+
+        if (id == std::string::npos || samples == std::string::npos)
+            continue;
+
+        // Names of functions have only escaped backslashes.
+        std::string key;
+
+        for (size_t i{id + 7}; i < line.size() && line[i] != '"'; ++i)
+            key += line[i] == '\\' ? line[++i] : line[i];
+
+        const size_t samplesBegin = samples + 14;
+        std::vector<double>& times = res[key];
+        std::stringstream ss(line.substr(samplesBegin, line.find(']', samplesBegin) - samplesBegin));
+        std::string value;
+
+        while (std::getline(ss, value, ','))
+            times.push_back(std::stod(value));
+    }
+
+    return res;
+}
+
+/// @brief Compares cases of two results.
+/// @return Count of slower cases.
+size_t Compare(const std::map<std::string, std::vector<double>>& baseline, const std::map<std::string, std::vector<double>>& current,
+               double threshold, double alpha)
+{
+    size_t slower = 0;
+
+    std::cout << std::left << std::setw(48) << "case" << std::right << std::setw(14) << "baseline, us" << std::setw(14) << "current, us"
+              << std::setw(10) << "ratio" << std::setw(10) << "p" << std::endl;
+
+    for (const auto& [id, times] : current)
+    {
+        auto base = baseline.find(id);
+
+        if (base == baseline.end())
+        {
+            std::cout << std::left << std::setw(48) << id << " not in the baseline" << std::endl;
+            continue;
+        }
+
+        const double before = Median(base->second), after = Median(times), ratio = after / before, p = MannWhitney(base->second, times);
+        const bool slow = p < alpha && ratio > 1 + threshold;
+
+        slower += slow;
+        std::cout << std::left << std::setw(48) << id << std::right << std::fixed << std::setprecision(1) << std::setw(14) << before / 1e3
+                  << std::setw(14) << after / 1e3 << std::setprecision(3) << std::setw(10) << ratio << std::setw(10) << p
+                  << (slow ? "  SLOWER" : "") << std::defaultfloat << std::endl;
+    }
+
+    for (const auto& [id, times] : baseline)
+        if (!current.count(id))
+            std::cout << std::left << std::setw(48) << id << " not in the current results" << std::endl;
+
+    std::cout << slower << " of " << current.size() << " cases are slower" << std::endl;
+
+    return slower;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t repetitions = 10;
+    double threshold = 0.1, alpha = 0.01;
+    const char* output = "SolverBench.json";
+    const char* baseline = nullptr;
+    std::string filter;
+
+    try
+    {
+        if (argc == 4 && !std::strcmp(argv[1], "--compare"))
+            return Compare(ReadSamples(argv[2]), ReadSamples(argv[3]), threshold, alpha) ? 1 : 0;
+
+        for (int i{1}; i + 1 < argc; i += 2)
+            if (!std::strcmp(argv[i], "-r"))
+                repetitions = std::max(1ul, std::strtoul(argv[i + 1], nullptr, 10));
+            else if (!std::strcmp(argv[i], "-o"))
+                output = argv[i + 1];
+            else if (!std::strcmp(argv[i], "-b"))
+                baseline = argv[i + 1];
+            else if (!std::strcmp(argv[i], "-t"))
+                threshold = std::stod(argv[i + 1]);
+            else if (!std::strcmp(argv[i], "-a"))
+                alpha = std::stod(argv[i + 1]);
+            else if (!std::strcmp(argv[i], "-f"))
+                filter = argv[i + 1];
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+
+    FunctionCatalog catalog;
+    // Minima of the catalog in its areas. The 3-D quadratic has the term 3y, its minimum is at y = -3 / 0.985, z = -0.5.
+    const double optima[] = {2, 0, -1, 0, 1.75 - 4.5 / 0.985, 0};
+    std::vector<std::unique_ptr<F_ND::ScalableFunction>> scalable;
+
+    for (size_t dim : {10, 100})
+    {
+        scalable.emplace_back(new F_ND::FuncRosenbrock(dim));
+        scalable.emplace_back(new F_ND::FuncRastrigin(dim));
+        scalable.emplace_back(new F_ND::FuncAckley(dim));
+        scalable.emplace_back(new F_ND::FuncGriewank(dim));
+        scalable.emplace_back(new F_ND::FuncStyblinskiTang(dim));
+        scalable.emplace_back(new F_ND::FuncQuadratic(dim));
+        scalable.emplace_back(new F_ND::FuncQuadraticChain(dim));
+    }
+
+    struct Problem
+    {
+        std::string name;
+        GeneralFunction<double>* f;
+        CubicArea<double> area;
+        Point<double> start;
+        double optimum;
+        size_t maxStep;
+    };
+
+    std::vector<Problem> problems;
+
+    for (size_t i{}; i < catalog.getFunctions().size(); ++i)
+    {
+        const FunctionData<double>& fd = catalog.getFunctions()[i];
+        problems.push_back({fd.name, &fd.f, {fd.minArea, fd.maxArea}, fd.start, optima[i], 200});
+    }
+
+    for (auto& f : scalable)
+    {
+        // The start is in the middle between the optimum and the corner of the area.
+        const CubicArea<double> area = f->getArea();
+        Point<double> start = f->getOptimum();
+
+        for (size_t i{}; i < start.size(); ++i)
+            start[i] = (start[i] + area.maxArea[i]) / 2;
+
+        problems.push_back({std::string(f->getName()) + " " + std::to_string(f->getDimension()), f.get(), area, start,
+                            f->getOptimumValue(), f->getDimension() > 10 ? size_t{30} : size_t{100}});
+    }
+
+    std::vector<Case> cases;
+
+    for (const char* method : {"determ", "stochast", "newton"})
+        for (const char* stop : {"num", "abs", "grad", "rel"})
+            for (const Problem& p : problems)
+            {
+                const std::string id = std::string(method) + "/" + stop + "/" + p.name;
+
+                if (id.find(filter) != std::string::npos)
+                    cases.push_back({id, method, stop, p.name, p.f, p.area, p.start, p.optimum, p.maxStep});
+            }
+
+    std::ofstream out(output);
+
+    if (!out.is_open())
+    {
+        std::cerr << "Cannot open " << output << "." << std::endl;
+        return 2;
+    }
+
+    out << "{\"benchmark\":\"SolverBench\",\"repetitions\":" << repetitions << ",\"cases\":[\n";
+
+    for (size_t i{}; i < cases.size(); ++i)
+    {
+        const Measurement m = Measure(cases[i], repetitions);
+
+        std::cout << std::left << std::setw(48) << cases[i].id << std::right << std::setw(10) << std::setprecision(4) << Median(m.samples) / 1e3
+                  << " us, iterations " << m.iterations << ", values " << m.values << ", gradients " << m.gradients
+                  << ", gap " << m.gap << std::endl;
+        Write(out, cases[i], m, i + 1 == cases.size());
+    }
+
+    out << "]}\n";
+    out.close();
+
+    std::cout << "Results are written to " << output << std::endl;
+
+    if (baseline)
+        try
+        {
+            return Compare(ReadSamples(baseline), ReadSamples(output), threshold, alpha) ? 1 : 0;
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 2;
+        }
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+/// @file
+/// @brief Benchmark of statically dispatched optimization.
+/// @details The Conjugate Vector Method is run on the functions of MathFunc.h through the virtual interface
+/// on std::vector points, through the virtual interface on std::array points (OptimizeFixed)
+/// and with static formulas (OptimizeStatic). The program checks that the pathways are equal
+/// and prints the time of one run.
+#include <chrono>
+#include <iostream>
+#include "StaticOptim.h"
+
+template <class Run>
+double Measure(size_t iterations, Run run)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i{}; i < iterations; ++i)
+        run();
+
+    std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - start;
+
+    return time.count() / iterations;
+}
+
+void Compare(const char* name, GeneralFunction<double>& f, const CubicArea<double>& area, const Point<double>& start)
+{
+    const size_t maxStep = 50, iterations = 200;
+    const double epsilon = 1e-6, epsilonStep = 1e-2;
+    NumStop<double> stop(maxStep);
+    DetermOptimization<double> opt(f, stop, epsilon, epsilonStep);
+
+    opt.SetArea(area.minArea, area.maxArea);
+    opt.DoOptimize(start);
+
+    Pathway<double> fixed = OptimizeFixed<DetermOptimization>(f, stop, area, start, 0, epsilon, epsilonStep).pathway,
+                    fast = OptimizeStatic(f, stop, area, start, 0, epsilon, epsilonStep).pathway;
+    double maxError = 0;
+
+    for (size_t i{}; i < fast.size(); ++i)
+        for (size_t j{}; j < start.size(); ++j)
+            maxError = std::max(maxError, std::abs(fast[i][j] - fixed[i][j]));
+
+    const double virt = Measure(iterations, [&]
+    {
+        opt.SetArea(area.minArea, area.maxArea);
+        opt.DoOptimize(start);
+    });
+    const double arr = Measure(iterations, [&] { fixed = OptimizeFixed<DetermOptimization>(f, stop, area, start, 0, epsilon, epsilonStep).pathway; });
+    const double stat = Measure(iterations, [&] { fast = OptimizeStatic(f, stop, area, start, 0, epsilon, epsilonStep).pathway; });
+
+    std::cout << name << ": max difference of pathways " << maxError << (fast.size() == fixed.size() ? "" : " (lengths differ)") << std::endl;
+    std::cout << "    virtual, vector: " << virt << " us" << std::endl;
+    std::cout << "    virtual, array:  " << arr << " us" << std::endl;
+    std::cout << "    static, array:   " << stat << " us (x" << virt / stat << ")" << std::endl;
+}
+
+int main()
+{
+    F_2D::FuncQuadratic1 quadratic;
+    F_2D::FuncRosenbrock rosenbrock;
+    F_2D::FuncHimmelblau himmelblau;
+    F_4D::FuncQuadratic1 quadratic4;
+
+    Compare("Quadratic 2D", quadratic, {Point<double>({-1, -1}), Point<double>({1, 1})}, Point<double>({0.5, 0.5}));
+    Compare("Rosenbrock", rosenbrock, {Point<double>({-1, -0.1}), Point<double>({1.1, 1.1})}, Point<double>({-0.5, 0.5}));
+    Compare("Himmelblau", himmelblau, {Point<double>({-5, -5}), Point<double>({5, 5})}, Point<double>({0, 0}));
+    Compare("Quadratic 4D", quadratic4, {Point<double>({0, 0, 0, 0}), Point<double>({2, 2, 2, 2})}, Point<double>({0.5, 0.5, 0.5, 0.5}));
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+/// @file
+/// @brief Search of parameters of the Conjugate Vector Method and of the Random Search on the functions of the catalog.
+/// @details The methods run from several start points of every function until they reach the minimum plus the tolerance.
+/// The program prints configurations ranked by evaluations to the tolerance, failed runs cost twice the budget.
+///
+/// Usage: SweepBench [-m determ|stochast] [-s grid|random|halving] [-n count] [-j workers] [-p starts] [-r rows] [-b budget] [-e tolerance]
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include "FunctionCatalog.h"
+#include "MultiStart.h"
+#include "OptMethod.h"
+#include "Sweep.h"
+
+constexpr char usage[] = "Usage: SweepBench [-m determ|stochast] [-s grid|random|halving] [-n count] [-j workers] [-p starts] [-r rows] "
+                         "[-b budget] [-e tolerance]\n";
+
+int main(int argc, char* argv[])
+{
+    std::string method = "determ", strategy = "halving";
+    size_t count = 27, workers = std::max(1u, std::thread::hardware_concurrency()), starts = 3, rows = 15, budget = 20000;
+    double tolerance = 1e-3;
+
+    for (int i{1}; i < argc; i += 2)
+    {
+        if (i + 1 == argc)
+        {
+            std::cerr << usage;
+            return 2;
+        }
+
+        if (!std::strcmp(argv[i], "-m"))
+            method = argv[i + 1];
+        else if (!std::strcmp(argv[i], "-s"))
+            strategy = argv[i + 1];
+        else if (!std::strcmp(argv[i], "-n"))
+            count = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (!std::strcmp(argv[i], "-j"))
+            workers = std::max(1ul, std::strtoul(argv[i + 1], nullptr, 10));
+        else if (!std::strcmp(argv[i], "-p"))
+            starts = std::max(1ul, std::strtoul(argv[i + 1], nullptr, 10));
+        else if (!std::strcmp(argv[i], "-r"))
+            rows = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (!std::strcmp(argv[i], "-b"))
+            budget = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (!std::strcmp(argv[i], "-e"))
+            tolerance = std::atof(argv[i + 1]);
+        else
+        {
+            std::cerr << usage;
+            return 2;
+        }
+    }
+
+    if ((method != "determ" && method != "stochast") || (strategy != "grid" && strategy != "random" && strategy != "halving"))
+    {
+        std::cerr << usage;
+        return 2;
+    }
+
+    FunctionCatalog catalog;
+    // Minima of the catalog in its areas. The 3-D quadratic has the term 3y, its minimum is at y = -3 / 0.985, z = -0.5.
+    const double optima[] = {2, 0, -1, 0, 1.75 - 4.5 / 0.985, 0};
+    std::vector<SweepProblem<double>> problems;
+
+    for (size_t i{}; i < catalog.getFunctions().size(); ++i)
+    {
+        const FunctionData<double>& fd = catalog.getFunctions()[i];
+        const CubicArea<double> area{fd.minArea, fd.maxArea};
+        std::vector<Point<double>> points = GenerateStarts(area, starts - 1, StartSampling::Sobol);
+
+        points.insert(points.begin(), fd.start);
+        problems.push_back({fd.name, &fd.f, area, std::move(points), optima[i]});
+    }
+
+    typename Sweep<double>::MethodFactory factory;
+    std::vector<SweepParam<double>> params;
+
+    if (method == "determ")
+    {
+        factory = [](GeneralFunction<double>& f, GeneralStop<double>& stop, const std::vector<double>& values)
+        {
+            return std::make_unique<DetermOptimization<double>>(f, stop, values[0], values[1]);
+        };
+        params = {{"epsilon", 1e-8, 1e-3, true}, {"epsilonStep", 1e-3, 0.3, true}};
+    }
+    else
+    {
+        factory = [](GeneralFunction<double>& f, GeneralStop<double>& stop, const std::vector<double>& values)
+        {
+            return std::make_unique<StochastOptimization<double>>(f, stop, values[0], values[1], 0, values[2]);
+        };
+        params = {{"probability", 0.1, 0.9, false, 3}, {"delta", 1e-2, 1, true, 3}, {"alpha", 0.05, 1, false, 3}};
+    }
+
+    try
+    {
+        // The calling thread runs configurations too, so the pool has one thread less than workers.
+        ThreadPool pool(workers - 1);
+        Sweep<double> sweep(factory, params, pool, tolerance, budget);
+        const SweepStrategy kind = strategy == "grid" ? SweepStrategy::Grid
+                                                      : strategy == "random" ? SweepStrategy::Random : SweepStrategy::SuccessiveHalving;
+
+        PrintSweep(std::cout, params, sweep.Search(problems, kind, count), rows);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+/// @file
+/// @brief Optimization in a worker thread with streaming of the pathway and cancellation.
+/// @details File contains the definition of a stopper which streams points of the pathway into a lock-free queue
+/// and stops on a request of cancellation, and of a runner of an optimization in a worker thread.
+/// The thread which starts runs is the consumer of the queue. While a run is active the method and the stopper
+/// belong to the worker thread and must not be used by other threads.
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <utility>
+#include "DiffStoper.h"
+#include "SpscQueue.h"
+
+/// @brief Stopper which streams points into a queue and stops on cancellation.
+/// @details Only points which differ from the previous one are streamed. Points are not waited for:
+/// if the queue is full the point is dropped and counted, so the consumer never slows the optimization down.
+/// Cancellation is checked once per iteration.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class StreamStop : public GeneralStop<T, Container>
+{
+private:
+    GeneralStop<T, Container>* stop;
+    SpscQueue<Point<T, Container>>* queue;
+    const std::atomic<bool>* cancel;
+    size_t dropped;
+public:
+    /// @brief Constructor of the Stream Stopper.
+    /// @param _stop Stopper which decides when the optimization converged.
+    /// @param _queue Queue of points.
+    /// @param _cancel Flag of cancellation.
+    StreamStop(GeneralStop<T, Container>& _stop, SpscQueue<Point<T, Container>>& _queue, const std::atomic<bool>& _cancel)
+        : GeneralStop<T, Container>(NOSTEPLIMIT), stop(&_stop), queue(&_queue), cancel(&_cancel), dropped(0) {}
+
+    void SetParam(GeneralStop<T, Container>& _stop);
+
+    size_t getMaxStep() const override { return stop->getMaxStep(); }
+
+    /// @brief Count of points which did not fit into the queue in the current run.
+    inline size_t getDropped() const { return dropped; }
+
+    void Reset() override;
+
+    bool condition(const IterationState<T, Container>& state) override;
+};
+
+template <typename T, class Container>
+void StreamStop<T, Container>::SetParam(GeneralStop<T, Container>& _stop)
+{
+    stop = &_stop;
+}
+
+template <typename T, class Container>
+void StreamStop<T, Container>::Reset()
+{
+    dropped = 0;
+    stop->Reset();
+}
+
+template <typename T, class Container>
+bool StreamStop<T, Container>::condition(const IterationState<T, Container>& state)
+{
+    // Iterations which stay in the same point add nothing to the drawn pathway.
+    if ((state.iteration == 1 || state.stepLength > 0) && !queue->TryPush(state.point))
+        ++dropped;
+
+    return !cancel->load(std::memory_order_relaxed) && stop->condition(state);
+}
+
+/// @brief Runner of an optimization in a worker thread.
+/// @tparam T Typename for a value of a function.
+template <typename T = double>
+class AsyncOptimization
+{
+private:
+    SpscQueue<Point<T>> queue;
+    std::atomic<bool> cancel;
+    std::atomic<bool> running;
+    /// @brief Stopper of the streaming one before the first run.
+    NumStop<T> placeholder;
+    StreamStop<T> stream;
+    std::thread worker;
+    std::exception_ptr error;
+public:
+    /// @brief Constructor of a runner.
+    /// @param capacity Count of points in the queue.
+    explicit AsyncOptimization(size_t capacity = 4096);
+
+    AsyncOptimization(const AsyncOptimization&) = delete;
+    AsyncOptimization& operator=(const AsyncOptimization&) = delete;
+
+    ~AsyncOptimization() { Cancel(); }
+
+    /// @brief Starts a run. The current run is cancelled first.
+    /// @details The stopper of the method is replaced by the streaming one, which calls the given stopper.
+    /// Exceptions of the run are kept and rethrown by Wait.
+    /// @param method Method with the set area.
+    /// @param stop Stopper of the run.
+    /// @param start Start point.
+    void Start(Optimization<T>& method, GeneralStop<T>& stop, const Point<T>& start);
+
+    /// @brief Starts a run of a callable. The current run is cancelled first.
+    /// @details The callable is called in the worker thread with the streaming stopper, which calls the given stopper.
+    /// It runs an optimization with that stopper, for example by OptimizeFixed. Exceptions of the run are kept and rethrown by Wait.
+    /// @param run Callable void(GeneralStop<T>& stop).
+    /// @param stop Stopper of the run.
+    template <class Run>
+    void Start(Run run, GeneralStop<T>& stop);
+
+    /// @brief Requests cancellation and waits for the end of the run. Points which are in the queue stay there.
+    void Cancel();
+
+    /// @brief Waits for the end of the run.
+    /// @throw Exception of the run.
+    void Wait();
+
+    /// @brief True from Start until the worker leaves the optimization.
+    inline bool IsRunning() const { return running.load(std::memory_order_acquire); }
+
+    /// @brief Calls f for every point which arrived since the last call.
+    /// @return Count of points.
+    template <class F>
+    size_t Drain(F&& f) { return queue.Drain(std::forward<F>(f)); }
+
+    /// @brief Count of points which did not fit into the queue in the last run. It is read after the end of the run.
+    inline size_t getDropped() const { return stream.getDropped(); }
+};
+
+template <typename T>
+AsyncOptimization<T>::AsyncOptimization(size_t capacity)
+    : queue(capacity), cancel(false), running(false), stream(placeholder, queue, cancel)
+{
+
+}
+
+template <typename T>
+void AsyncOptimization<T>::Start(Optimization<T>& method, GeneralStop<T>& stop, const Point<T>& start)
+{
+    Start([&method, start](GeneralStop<T>& stream)
+    {
+        method.SetStop(stream);
+        method.DoOptimize(start);
+    }, stop);
+}
+
+template <typename T>
+template <class Run>
+void AsyncOptimization<T>::Start(Run run, GeneralStop<T>& stop)
+{
+    Cancel();
+    queue.Drain([](const Point<T>&) {});
+
+    error = nullptr;
+    stream.SetParam(stop);
+    running.store(true, std::memory_order_release);
+
+    worker = std::thread([this, run = std::move(run)]() mutable
+    {
+        try
+        {
+            run(stream);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        running.store(false, std::memory_order_release);
+    });
+}
+
+template <typename T>
+void AsyncOptimization<T>::Cancel()
+{
+    cancel.store(true, std::memory_order_relaxed);
+
+    if (worker.joinable())
+        worker.join();
+
+    cancel.store(false, std::memory_order_relaxed);
+}
+
+template <typename T>
+void AsyncOptimization<T>::Wait()
+{
+    if (worker.joinable())
+        worker.join();
+
+    if (error)
+        std::rethrow_exception(std::exchange(error, nullptr));
+}
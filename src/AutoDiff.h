@@ -0,0 +1,286 @@
+/// @file
+/// @brief Realization of forward-mode automatic differentiation.
+/// @details File contains the definition of dual numbers and of a function which computes its gradient
+/// by automatic differentiation. A dual number carries a value and N derivatives (tangent lanes),
+/// so one pass of an objective over dual numbers yields the full gradient. Lanes are stored in a plain
+/// array and processed by fixed-length loops, which the compiler unrolls and vectorizes.
+///
+/// The objective is a functor with a template call operator. It is written once and used both for values
+/// and for gradients. Mathematical functions must be called unqualified after using std::sin etc.:
+/// @code
+/// struct Rosenbrock
+/// {
+///     template <class P>
+///     auto operator()(const P& p) const { return (1 - p[0]) * (1 - p[0]) + (p[1] - p[0] * p[0]) * (p[1] - p[0] * p[0]); }
+/// };
+///
+/// AutoDiffFunction<double, 2, Rosenbrock> f;
+/// @endcode
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include "Optimization.h"
+
+template <typename T, size_t N>
+class Dual;
+
+/// @brief Scalar under dual numbers: T itself, or the scalar of the values of a dual number.
+template <typename T>
+struct DualScalar
+{
+    using type = T;
+};
+
+template <typename T, size_t N>
+struct DualScalar<Dual<T, N>> : DualScalar<T> {};
+
+/// @brief Dual number with N tangent lanes.
+/// @tparam T Typename of a value.
+/// @tparam N Count of derivatives.
+template <typename T, size_t N>
+class Dual
+{
+private:
+    T value;
+    std::array<T, N> d;
+
+    /// @brief Dual number with a value and derivatives multiplied by a scalar: (value, k * d).
+    static Dual Chain(const T& value, const T& k, const Dual& a)
+    {
+        Dual res(value);
+
+        for (size_t i{}; i < N; ++i)
+            res.d[i] = k * a.d[i];
+
+        return res;
+    }
+public:
+    using value_type = T;
+    using scalar_type = typename DualScalar<T>::type;
+
+    /// @brief Constant: all derivatives are zero.
+    Dual(const T& _value = T{}) : value(_value), d{} {}
+
+    /// @brief Variable number i: its derivative by itself is one.
+    /// @param _value Value.
+    /// @param i Index of a variable.
+    Dual(const T& _value, size_t i) : value(_value), d{}
+    {
+        d[i] = static_cast<T>(1);
+    }
+
+    const T& Value() const { return value; }
+    const std::array<T, N>& Derivatives() const { return d; }
+
+    Dual& operator+=(const Dual& b)
+    {
+        value += b.value;
+
+        for (size_t i{}; i < N; ++i)
+            d[i] += b.d[i];
+
+        return *this;
+    }
+
+    Dual& operator-=(const Dual& b)
+    {
+        value -= b.value;
+
+        for (size_t i{}; i < N; ++i)
+            d[i] -= b.d[i];
+
+        return *this;
+    }
+
+    Dual& operator*=(const Dual& b)
+    {
+        for (size_t i{}; i < N; ++i)
+            d[i] = d[i] * b.value + value * b.d[i];
+
+        value *= b.value;
+
+        return *this;
+    }
+
+    Dual& operator/=(const Dual& b)
+    {
+        const T inv = static_cast<T>(1) / b.value;
+        value *= inv;
+
+        for (size_t i{}; i < N; ++i)
+            d[i] = (d[i] - value * b.d[i]) * inv;
+
+        return *this;
+    }
+
+    friend Dual operator+(Dual a, const Dual& b) { return a += b; }
+    friend Dual operator-(Dual a, const Dual& b) { return a -= b; }
+    friend Dual operator*(Dual a, const Dual& b) { return a *= b; }
+    friend Dual operator/(Dual a, const Dual& b) { return a /= b; }
+
+    friend Dual operator-(const Dual& a) { return Chain(-a.value, static_cast<T>(-1), a); }
+
+    // Operations with a scalar do not touch the zero derivatives of the scalar.
+    friend Dual operator+(Dual a, const T& b) { a.value += b; return a; }
+    friend Dual operator+(const T& a, Dual b) { b.value += a; return b; }
+    friend Dual operator-(Dual a, const T& b) { a.value -= b; return a; }
+    friend Dual operator-(const T& a, const Dual& b) { return Chain(a - b.value, static_cast<T>(-1), b); }
+    friend Dual operator*(const Dual& a, const T& b) { return Chain(a.value * b, b, a); }
+    friend Dual operator*(const T& a, const Dual& b) { return Chain(a * b.value, a, b); }
+    friend Dual operator/(const Dual& a, const T& b) { return Chain(a.value / b, static_cast<T>(1) / b, a); }
+    friend Dual operator/(const T& a, const Dual& b) { return Chain(a / b.value, -a / (b.value * b.value), b); }
+
+    friend bool operator<(const Dual& a, const Dual& b) { return a.value < b.value; }
+    friend bool operator>(const Dual& a, const Dual& b) { return a.value > b.value; }
+    friend bool operator<=(const Dual& a, const Dual& b) { return a.value <= b.value; }
+    friend bool operator>=(const Dual& a, const Dual& b) { return a.value >= b.value; }
+
+    // Functions of values are called unqualified, so a dual number can carry dual numbers (second derivatives).
+    // The exponent of pow is a scalar, so it stays a plain number at every level of nesting.
+    friend Dual sin(const Dual& a) { using std::sin, std::cos; return Chain(sin(a.value), cos(a.value), a); }
+    friend Dual cos(const Dual& a) { using std::sin, std::cos; return Chain(cos(a.value), -sin(a.value), a); }
+    friend Dual exp(const Dual& a) { using std::exp; const T e = exp(a.value); return Chain(e, e, a); }
+    friend Dual log(const Dual& a) { using std::log; return Chain(log(a.value), static_cast<T>(1) / a.value, a); }
+    friend Dual sqrt(const Dual& a) { using std::sqrt; const T s = sqrt(a.value); return Chain(s, static_cast<T>(0.5) / s, a); }
+    friend Dual abs(const Dual& a) { using std::abs; return Chain(abs(a.value), a.value < 0 ? static_cast<T>(-1) : static_cast<T>(1), a); }
+    friend Dual pow(const Dual& a, const scalar_type& b) { using std::pow; return Chain(pow(a.value, b), b * pow(a.value, b - 1), a); }
+};
+
+/// @brief Function which computes its gradient by forward-mode automatic differentiation.
+/// @details The product of the Hessian and a vector is computed by dual numbers over dual numbers:
+/// the inner lane carries the direction, so one pass yields the gradient and its derivative along the vector.
+/// @tparam T Typename for a value of a function.
+/// @tparam N Dimension of a function.
+/// @tparam Objective Functor with a template call operator over points of T and of Dual<T, N>.
+template <typename T, size_t N, class Objective>
+class AutoDiffFunction : public GeneralFunction<T>, public FunctionN<T, N>
+{
+private:
+    Objective objective;
+
+    template <class Container>
+    T ValueAndGradientImpl(const Point<T, Container>& p, Point<T, Container>& gradient) const;
+
+    template <class Container>
+    void HessianVectorImpl(const Point<T, Container>& p, const Point<T, Container>& v, Point<T, Container>& result) const;
+public:
+    /// @brief Constructor of a function.
+    /// @param[in] _objective Objective of a function.
+    AutoDiffFunction(const Objective& _objective = Objective()) : objective(_objective) {}
+
+    // Both bases declare blocks with the same signature, the blocks of GeneralFunction<T> resolve the ambiguity.
+    using GeneralFunction<T>::ValueBatch;
+    using GeneralFunction<T>::GradientBatch;
+
+    T Value(const Point<T>& p) const override;
+    T Value(const PointN<T, N>& p) const override;
+
+    Point<T> Gradient(const Point<T>& p) const override;
+    PointN<T, N> Gradient(const PointN<T, N>& p) const override;
+
+    T ValueAndGradient(const Point<T>& p, Point<T>& gradient) const override;
+    T ValueAndGradient(const PointN<T, N>& p, PointN<T, N>& gradient) const override;
+
+    void HessianVectorProduct(const Point<T>& p, const Point<T>& v, Point<T>& result) const override;
+    void HessianVectorProduct(const PointN<T, N>& p, const PointN<T, N>& v, PointN<T, N>& result) const override;
+};
+
+template <typename T, size_t N, class Objective>
+template <class Container>
+T AutoDiffFunction<T, N, Objective>::ValueAndGradientImpl(const Point<T, Container>& p, Point<T, Container>& gradient) const
+{
+    if (p.size() != N)
+        throw std::invalid_argument("Size of point is not equal dimension.");
+
+    PointN<Dual<T, N>, N> x;
+
+    for (size_t i{}; i < N; ++i)
+        x[i] = Dual<T, N>(p[i], i);
+
+    const Dual<T, N> res = objective(x);
+
+    gradient.Resize(N);
+    std::copy(res.Derivatives().begin(), res.Derivatives().end(), gradient.begin());
+
+    return res.Value();
+}
+
+template <typename T, size_t N, class Objective>
+template <class Container>
+void AutoDiffFunction<T, N, Objective>::HessianVectorImpl(const Point<T, Container>& p, const Point<T, Container>& v, Point<T, Container>& result) const
+{
+    if (p.size() != N || v.size() != N)
+        throw std::invalid_argument("Size of point is not equal dimension.");
+
+    using Inner = Dual<T, 1>;
+    PointN<Dual<Inner, N>, N> x;
+
+    for (size_t i{}; i < N; ++i)
+        x[i] = Dual<Inner, N>(Inner(p[i]) + v[i] * Inner(T{}, 0), i);
+
+    const Dual<Inner, N> res = objective(x);
+
+    result.Resize(N);
+
+    for (size_t i{}; i < N; ++i)
+        result[i] = res.Derivatives()[i].Derivatives()[0];
+}
+
+template <typename T, size_t N, class Objective>
+T AutoDiffFunction<T, N, Objective>::Value(const Point<T>& p) const
+{
+    if (p.size() != N)
+        throw std::invalid_argument("Size of point is not equal dimension.");
+
+    return objective(p);
+}
+
+template <typename T, size_t N, class Objective>
+T AutoDiffFunction<T, N, Objective>::Value(const PointN<T, N>& p) const
+{
+    return objective(p);
+}
+
+template <typename T, size_t N, class Objective>
+Point<T> AutoDiffFunction<T, N, Objective>::Gradient(const Point<T>& p) const
+{
+    Point<T> gradient;
+    ValueAndGradientImpl(p, gradient);
+
+    return gradient;
+}
+
+template <typename T, size_t N, class Objective>
+PointN<T, N> AutoDiffFunction<T, N, Objective>::Gradient(const PointN<T, N>& p) const
+{
+    PointN<T, N> gradient;
+    ValueAndGradientImpl(p, gradient);
+
+    return gradient;
+}
+
+template <typename T, size_t N, class Objective>
+T AutoDiffFunction<T, N, Objective>::ValueAndGradient(const Point<T>& p, Point<T>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+template <typename T, size_t N, class Objective>
+T AutoDiffFunction<T, N, Objective>::ValueAndGradient(const PointN<T, N>& p, PointN<T, N>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+template <typename T, size_t N, class Objective>
+void AutoDiffFunction<T, N, Objective>::HessianVectorProduct(const Point<T>& p, const Point<T>& v, Point<T>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+template <typename T, size_t N, class Objective>
+void AutoDiffFunction<T, N, Objective>::HessianVectorProduct(const PointN<T, N>& p, const PointN<T, N>& v, PointN<T, N>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
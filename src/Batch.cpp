@@ -0,0 +1,89 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "BatchOptim.h"
+#include "FunctionCatalog.h"
+
+constexpr char usage[] = "Usage: OptimBatch [-j workers] [-f csv|jsonl] [-o output] jobs\n"
+                         "Runs optimization jobs of the file (\"-\" is the standard input) and writes results.\n"
+                         "Workers are threads of the pool, by default one per core.\n";
+
+int main(int argc, char* argv[])
+{
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    Batch::Format format = Batch::Format::Csv;
+    const char* input = nullptr;
+    const char* output = nullptr;
+
+    for (int i{1}; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+
+        if (!std::strcmp(argv[i], "-j") && hasValue)
+            workers = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "-f") && hasValue && !std::strcmp(argv[i + 1], "csv"))
+            format = Batch::Format::Csv, ++i;
+        else if (!std::strcmp(argv[i], "-f") && hasValue && !std::strcmp(argv[i + 1], "jsonl"))
+            format = Batch::Format::JsonLines, ++i;
+        else if (!std::strcmp(argv[i], "-o") && hasValue)
+            output = argv[++i];
+        else if (!input && (argv[i][0] != '-' || !std::strcmp(argv[i], "-")))
+            input = argv[i];
+        else
+        {
+            std::cerr << usage;
+            return 2;
+        }
+    }
+
+    if (!input)
+    {
+        std::cerr << usage;
+        return 2;
+    }
+
+    FunctionCatalog catalog;
+    std::vector<Batch::Job> jobs;
+
+    try
+    {
+        std::ifstream file;
+
+        if (std::strcmp(input, "-"))
+        {
+            file.open(input);
+
+            if (!file.is_open())
+                throw std::invalid_argument(std::string("Cannot open ") + input + ".");
+        }
+
+        jobs = Batch::ReadJobs(file.is_open() ? file : std::cin, catalog.getFunctions());
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << '\n';
+        return 2;
+    }
+
+    std::ofstream file;
+
+    if (output)
+    {
+        file.open(output);
+
+        if (!file.is_open())
+        {
+            std::cerr << "Cannot open " << output << ".\n";
+            return 2;
+        }
+    }
+
+    // The calling thread runs jobs too, so the pool has one thread less than workers.
+    ThreadPool pool(workers - 1);
+    const size_t failed = Batch::Run(jobs, pool, output ? file : std::cout, format);
+
+    if (failed)
+        std::cerr << failed << " of " << jobs.size() << " jobs failed.\n";
+
+    return failed ? 1 : 0;
+}
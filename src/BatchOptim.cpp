@@ -0,0 +1,422 @@
+#include <cmath>
+#include <iomanip>
+#include <istream>
+#include <limits>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include "BatchOptim.h"
+#include "DiffStoper.h"
+#include "NewtonOptim.h"
+#include "OptMethod.h"
+#include "StaticOptim.h"
+
+namespace
+{
+    std::string LineError(size_t line, const std::string& message)
+    {
+        return "Line " + std::to_string(line) + ": " + message;
+    }
+
+    double ParseDouble(const std::string& value, size_t line)
+    {
+        size_t pos = 0;
+        double res = 0;
+
+        try
+        {
+            res = std::stod(value, &pos);
+        }
+        catch (const std::exception&)
+        {
+            pos = 0;
+        }
+
+        if (!pos || pos != value.size())
+            throw std::invalid_argument(LineError(line, "\"" + value + "\" is not a number."));
+
+        return res;
+    }
+
+    size_t ParseSize(const std::string& value, size_t line)
+    {
+        size_t pos = 0;
+        unsigned long long res = 0;
+
+        try
+        {
+            res = value[0] != '-' ? std::stoull(value, &pos) : 0;
+        }
+        catch (const std::exception&)
+        {
+            pos = 0;
+        }
+
+        if (!pos || pos != value.size())
+            throw std::invalid_argument(LineError(line, "\"" + value + "\" is not a count."));
+
+        return static_cast<size_t>(res);
+    }
+
+    Point<double> ParsePoint(const std::string& value, size_t line)
+    {
+        std::vector<double> coords;
+        std::stringstream ss(value);
+        std::string coord;
+
+        while (std::getline(ss, coord, ','))
+            coords.push_back(ParseDouble(coord, line));
+
+        if (coords.empty())
+            throw std::invalid_argument(LineError(line, "Point has no coordinates."));
+
+        return Point<double>(coords);
+    }
+
+    /// @brief Text field of CSV. It is always quoted, quotes are doubled.
+    std::string CsvText(const std::string& text)
+    {
+        std::string res = "\"";
+
+        for (const char c : text)
+            res += c == '"' ? "\"\"" : std::string(1, c);
+
+        return res + "\"";
+    }
+
+    std::string JsonText(const std::string& text)
+    {
+        std::ostringstream res;
+        res << '"';
+
+        for (const char c : text)
+            switch (c)
+            {
+            case '"':
+                res << "\\\"";
+                break;
+            case '\\':
+                res << "\\\\";
+                break;
+            case '\n':
+                res << "\\n";
+                break;
+            case '\t':
+                res << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                    res << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+                else
+                    res << c;
+            }
+
+        res << '"';
+
+        return res.str();
+    }
+
+    /// @brief Number of JSON. JSON has no infinities and NaN, they are written as null.
+    std::string JsonNumber(double value)
+    {
+        if (!std::isfinite(value))
+            return "null";
+
+        std::ostringstream res;
+        res << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+
+        return res.str();
+    }
+}
+
+namespace Batch
+{
+    std::vector<Job> ReadJobs(std::istream& in, const std::vector<FunctionData<double>>& functions)
+    {
+        std::vector<Job> jobs;
+        std::string text;
+
+        for (size_t line{1}; std::getline(in, text); ++line)
+        {
+            text = text.substr(0, text.find('#'));
+
+            std::stringstream ss(text);
+            std::string field;
+            Job job;
+            bool minSet = false, maxSet = false, startSet = false, cacheSet = false, empty = true;
+
+            job.line = line;
+
+            while (ss >> field)
+            {
+                empty = false;
+
+                const size_t eq = field.find('=');
+
+                if (eq == std::string::npos || !eq || eq + 1 == field.size())
+                    throw std::invalid_argument(LineError(line, "\"" + field + "\" is not key=value."));
+
+                const std::string key = field.substr(0, eq), value = field.substr(eq + 1);
+
+                if (key == "name")
+                    job.name = value;
+                else if (key == "function")
+                {
+                    const FunctionData<double>* data = nullptr;
+
+                    for (const auto& fd : functions)
+                        if (fd.name == value)
+                            data = &fd;
+
+                    if (!data && value.find_first_not_of("0123456789") == std::string::npos)
+                    {
+                        const size_t number = ParseSize(value, line);
+
+                        if (number >= 1 && number <= functions.size())
+                            data = &functions[number - 1];
+                    }
+
+                    if (!data)
+                        throw std::invalid_argument(LineError(line, "Unknown function \"" + value + "\"."));
+
+                    job.function = data->name;
+                    job.f = &data->f;
+                    job.expression.reset();
+
+                    if (!minSet)
+                        job.minArea = data->minArea;
+
+                    if (!maxSet)
+                        job.maxArea = data->maxArea;
+
+                    if (!startSet)
+                        job.start = data->start;
+                }
+                else if (key == "expr")
+                {
+                    try
+                    {
+                        job.expression = std::make_shared<ExpressionFunction>(value);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        throw std::invalid_argument(LineError(line, e.what()));
+                    }
+
+                    job.function = value;
+                    job.f = job.expression.get();
+                }
+                else if (key == "method")
+                {
+                    if (value != "determ" && value != "stochast" && value != "newton")
+                        throw std::invalid_argument(LineError(line, "Unknown method \"" + value + "\"."));
+
+                    job.method = value;
+                }
+                else if (key == "search")
+                {
+                    if (value != "brent" && value != "wolfe" && value != "armijo" && value != "scan")
+                        throw std::invalid_argument(LineError(line, "Unknown line search \"" + value + "\"."));
+
+                    job.search = value;
+                }
+                else if (key == "stop")
+                {
+                    if (value != "num" && value != "abs" && value != "grad" && value != "rel")
+                        throw std::invalid_argument(LineError(line, "Unknown stopper \"" + value + "\"."));
+
+                    job.stop = value;
+                }
+                else if (key == "iter")
+                    job.numIter = ParseSize(value, line);
+                else if (key == "eps")
+                    job.epsilon = ParseDouble(value, line);
+                else if (key == "epsAbs")
+                    job.epsilonAbs = ParseDouble(value, line);
+                else if (key == "epsGrad")
+                    job.epsilonGrad = ParseDouble(value, line);
+                else if (key == "step")
+                    job.epsilonStep = ParseDouble(value, line);
+                else if (key == "prob")
+                    job.prob = ParseDouble(value, line);
+                else if (key == "delta")
+                    job.delta = ParseDouble(value, line);
+                else if (key == "alpha")
+                    job.alpha = ParseDouble(value, line);
+                else if (key == "radius")
+                    job.radius = ParseDouble(value, line);
+                else if (key == "relTol")
+                    job.relTolerance = ParseDouble(value, line);
+                else if (key == "newtonTol")
+                    job.newtonTolerance = ParseDouble(value, line);
+                else if (key == "seed")
+                    job.seed = ParseSize(value, line);
+                else if (key == "cache")
+                    job.cache = ParseSize(value, line), cacheSet = true;
+                else if (key == "min")
+                    job.minArea = ParsePoint(value, line), minSet = true;
+                else if (key == "max")
+                    job.maxArea = ParsePoint(value, line), maxSet = true;
+                else if (key == "start")
+                    job.start = ParsePoint(value, line), startSet = true;
+                else
+                    throw std::invalid_argument(LineError(line, "Unknown key \"" + key + "\"."));
+            }
+
+            if (empty)
+                continue;
+
+            if (!job.f)
+                throw std::invalid_argument(LineError(line, "Job has no function."));
+
+            const size_t dim = job.expression ? job.expression->getDimension() : job.minArea.size();
+
+            if (job.minArea.size() != dim || job.maxArea.size() != dim || job.start.size() != dim)
+                throw std::invalid_argument(LineError(line, "Area and start must have the dimension of the function " + std::to_string(dim) + "."));
+
+            if (!cacheSet)
+                job.cache = job.expression ? CACHESIZE : 0;
+
+            if (job.name.empty())
+                job.name = "job" + std::to_string(jobs.size() + 1);
+
+            jobs.push_back(std::move(job));
+        }
+
+        return jobs;
+    }
+
+    Result RunJob(const Job& job, size_t index)
+    {
+        Result res;
+        res.index = index;
+        res.job = &job;
+
+        try
+        {
+            // Stoppers live on the stack of the job, combinations are built from constructed stoppers.
+            NumStop<double> num(job.numIter);
+            AbsStop<double> abs(job.numIter, job.epsilonAbs);
+            GradStop<double> grad(job.epsilonGrad);
+            RelStop<double> rel(job.relTolerance);
+            AnyOf<double> numGrad({&num, &grad}), numRel({&num, &rel});
+            GeneralStop<double>* stop = &num;
+
+            if (job.stop == "abs")
+                stop = &abs;
+            else if (job.stop == "grad")
+                stop = &numGrad;
+            else if (job.stop == "rel")
+                stop = &numRel;
+
+            // Functions of 2, 3 and 4 variables with fixed-dimension formulas run on points in std::array,
+            // the Conjugate Vector Method evaluates functions of MathFunc.h by their static formulas.
+            const CubicArea<double> area{job.minArea, job.maxArea};
+            RunResult<double> run;
+
+            if (job.method == "stochast")
+                run = OptimizeFixed<StochastOptimization>(*job.f, *stop, area, job.start, job.cache, job.prob, job.delta, job.seed, job.alpha);
+            else if (job.method == "newton")
+                run = OptimizeFixed<NewtonOptimization>(*job.f, *stop, area, job.start, job.cache, job.radius, job.newtonTolerance);
+            else
+            {
+                const LineSearchMode search = job.search == "scan"   ? LineSearchMode::Scan
+                                              : job.search == "wolfe"  ? LineSearchMode::StrongWolfe
+                                              : job.search == "armijo" ? LineSearchMode::Armijo
+                                                                       : LineSearchMode::Brent;
+
+                run = OptimizeStatic(*job.f, *stop, area, job.start, job.cache, job.epsilon, job.epsilonStep, search);
+            }
+
+            const RunSummary<double> summary = run.summary;
+
+            res.point = run.pathway.back();
+            res.value = summary.valueEnd;
+            res.iterations = summary.iterations;
+            res.evaluations = summary.evaluations;
+            res.cacheHits = summary.cacheHits;
+            res.time = summary.time;
+        }
+        catch (const std::exception& e)
+        {
+            res.error = e.what();
+        }
+
+        return res;
+    }
+
+    size_t Run(const std::vector<Job>& jobs, ThreadPool& pool, std::ostream& out, Format format)
+    {
+        std::vector<Result> results(jobs.size());
+        std::vector<char> done(jobs.size(), 0);
+        std::mutex mutex;
+        size_t next = 0, failed = 0;
+
+        WriteHeader(out, format);
+        out.flush();
+
+        pool.ParallelFor(jobs.size(), [&](size_t i)
+        {
+            Result res = RunJob(jobs[i], i);
+            std::lock_guard<std::mutex> lock(mutex);
+
+            results[i] = std::move(res);
+            done[i] = 1;
+
+            // Results are written in order of jobs, so the output does not depend on the schedule.
+            for (; next < jobs.size() && done[next]; ++next)
+            {
+                failed += !results[next].error.empty();
+                WriteResult(out, format, results[next]);
+                results[next] = Result();
+            }
+
+            out.flush();
+        });
+
+        return failed;
+    }
+
+    void WriteHeader(std::ostream& out, Format format)
+    {
+        if (format == Format::Csv)
+            out << "job,line,name,function,method,stop,iterations,evaluations,cache_hits,value,time_ms,point,error\n";
+    }
+
+    void WriteResult(std::ostream& out, Format format, const Result& result)
+    {
+        const Job& job = *result.job;
+        std::ostringstream point;
+        point << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+        for (size_t i{}; i < result.point.size(); ++i)
+        {
+            if (i)
+                point << (format == Format::Csv ? " " : ",");
+
+            if (format == Format::Csv)
+                point << result.point[i];
+            else
+                point << JsonNumber(result.point[i]);
+        }
+
+        if (format == Format::Csv)
+            out << result.index + 1 << ',' << job.line << ',' << CsvText(job.name) << ',' << CsvText(job.function) << ','
+                << job.method << ',' << job.stop << ',' << result.iterations << ',' << result.evaluations << ',' << result.cacheHits << ','
+                << std::setprecision(std::numeric_limits<double>::max_digits10) << result.value << ','
+                << std::setprecision(6) << result.time / 1e6 << ',' << point.str() << ',' << CsvText(result.error) << '\n';
+        else
+        {
+            out << "{\"job\":" << result.index + 1 << ",\"line\":" << job.line << ",\"name\":" << JsonText(job.name)
+                << ",\"function\":" << JsonText(job.function) << ",\"method\":" << JsonText(job.method)
+                << ",\"stop\":" << JsonText(job.stop) << ",\"iterations\":" << result.iterations
+                << ",\"evaluations\":" << result.evaluations << ",\"cache_hits\":" << result.cacheHits << ",\"value\":" << JsonNumber(result.value)
+                << ",\"time_ms\":" << JsonNumber(result.time / 1e6) << ",\"point\":[" << point.str() << "]";
+
+            if (!result.error.empty())
+                out << ",\"error\":" << JsonText(result.error);
+
+            out << "}\n";
+        }
+    }
+}
@@ -0,0 +1,114 @@
+/// @file
+/// @brief Batch runner of optimization jobs without a user interface.
+/// @details File contains the reader of a job file, the runner of jobs on a pool of threads and writers of results.
+///
+/// A job file has one job per line. Fields of a job are pairs key=value separated by spaces, '#' starts a comment.
+/// Keys:
+/// - name: label of the job;
+/// - function: name or number (from 1) of a function of the catalog;
+/// - expr: expression of a function instead of the catalog (see Expression.h), it needs min, max and start;
+/// - method: determ (conjugate gradients), stochast (random search) or newton (Newton-CG);
+/// - search: line search of determ: brent (bracketing and Brent's method), wolfe (strong Wolfe), armijo (backtracking)
+///   or scan (global scan of the segment);
+/// - stop: num (count of iterations), abs (decrease of the value), grad (norm of the gradient) or rel (relative change of the value),
+///   grad and rel are limited by the count of iterations;
+/// - iter, eps, epsAbs, epsGrad, step, prob, delta, alpha, radius, seed: parameters of methods and stoppers;
+/// - relTol: relative change of the value which stops rel;
+/// - newtonTol: relative residual which stops conjugate gradients of newton (see NewtonOptim.h);
+/// - cache: capacity of the cache of evaluations (see CachedFunction.h), 0 disables it. Jobs of expressions cache CACHESIZE points
+///   by default, because their evaluations are expensive;
+/// - min, max, start: points with coordinates separated by commas.
+///
+/// Omitted keys take the defaults of Job and the area and the start point of the function. Unlike the console program,
+/// jobs search lines by brent and stop by abs by default.
+/// Jobs do not share methods and stoppers, only functions, so functions must be thread-safe.
+#pragma once
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Expression.h"
+#include "Optimization.h"
+#include "ThreadPool.h"
+
+namespace Batch
+{
+    /// @brief Format of results: comma-separated values with a header or one JSON object per line.
+    enum class Format { Csv, JsonLines };
+
+    /// @brief Job of the batch.
+    struct Job
+    {
+        /// @brief Line of the job in the file.
+        size_t line = 0;
+        std::string name;
+        std::string function;
+        GeneralFunction<double>* f = nullptr;
+        /// @brief Function of an expression. It is shared by copies of the job.
+        std::shared_ptr<ExpressionFunction> expression;
+        std::string method = "determ";
+        std::string search = "brent";
+        std::string stop = "abs";
+        size_t numIter = 100;
+        double epsilon = 1e-6;
+        double epsilonAbs = 1e-6;
+        double epsilonGrad = 1e-6;
+        double epsilonStep = 1e-2;
+        double prob = 0.6;
+        double delta = 0.1;
+        double alpha = 0.2;
+        double radius = 1;
+        double relTolerance = 1e-8;
+        double newtonTolerance = 0.1;
+        size_t seed = 0;
+        size_t cache = 0;
+        Point<double> minArea;
+        Point<double> maxArea;
+        Point<double> start;
+    };
+
+    /// @brief Result of a job.
+    struct Result
+    {
+        /// @brief Index of the job in the batch.
+        size_t index = 0;
+        const Job* job = nullptr;
+        Point<double> point;
+        double value = 0;
+        size_t iterations = 0;
+        size_t evaluations = 0;
+        size_t cacheHits = 0;
+        /// @brief Time of the optimization in nanoseconds.
+        double time = 0;
+        /// @brief Message of the exception of the job. It is empty if the job succeeded.
+        std::string error;
+    };
+
+    /// @brief Reads jobs.
+    /// @param[in] in Stream of the job file.
+    /// @param[in] functions Catalog of functions. Jobs refer to its functions.
+    /// @return Jobs in order of lines.
+    /// @throw std::invalid_argument If a line has an unknown key, a wrong value or points of wrong dimensions.
+    std::vector<Job> ReadJobs(std::istream& in, const std::vector<FunctionData<double>>& functions);
+
+    /// @brief Runs a job. Exceptions of the optimization are stored in the result.
+    /// @param[in] job Job.
+    /// @param[in] index Index of the job in the batch.
+    Result RunJob(const Job& job, size_t index);
+
+    /// @brief Runs jobs on a pool of threads.
+    /// @details Results are written in order of jobs, every one as soon as it and all previous jobs are finished,
+    /// and the stream is flushed after every result, so consumers read results while the batch runs.
+    /// @param[in] jobs Jobs.
+    /// @param[in] pool Pool of threads.
+    /// @param[out] out Stream of results.
+    /// @param[in] format Format of results.
+    /// @return Count of failed jobs.
+    size_t Run(const std::vector<Job>& jobs, ThreadPool& pool, std::ostream& out, Format format);
+
+    /// @brief Writes the header of results. JSON lines have no header.
+    void WriteHeader(std::ostream& out, Format format);
+
+    void WriteResult(std::ostream& out, Format format, const Result& result);
+}
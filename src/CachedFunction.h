@@ -0,0 +1,395 @@
+/// @file
+/// @brief Realization of a function with a cache of evaluations.
+/// @details File contains the definition of a wrapper which remembers values and gradients of a function
+/// in the last evaluated points. Points are compared by exact bits of coordinates.
+/// The count of remembered points is bounded, the least recently used point is evicted.
+/// All memory is allocated on the first evaluation, later evaluations do not allocate.
+/// The cache is not thread-safe: use one wrapper per thread.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "GeneralFunction.h"
+
+static const size_t CACHESIZE = 1024;
+
+/// @brief Function with a cache of evaluations.
+/// @tparam T Typename for a value of a function.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class CachedFunction : public GeneralFunction<T, Container>
+{
+private:
+    static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+    enum State : unsigned char { Empty = 0, HasValue = 1, HasGradient = 2 };
+
+    GeneralFunction<T, Container>* f;
+    size_t capacity;
+    // Evaluations are const, so the state of the cache is mutable.
+    mutable size_t dim;
+    mutable size_t used;
+    mutable size_t head;
+    mutable size_t tail;
+    mutable size_t hits;
+    mutable size_t misses;
+
+    /// @brief Coordinates, values and gradients of remembered points. Point i has coordinates keys[i * dim, (i + 1) * dim).
+    mutable std::vector<T> keys;
+    mutable std::vector<T> values;
+    mutable std::vector<T> gradients;
+    mutable std::vector<unsigned char> states;
+    mutable std::vector<size_t> hashes;
+    /// @brief Doubly linked list of points from the most recently used (head) to the least recently used (tail).
+    mutable std::vector<size_t> prev;
+    mutable std::vector<size_t> next;
+    /// @brief Open addressing hash table of indexes of points.
+    mutable std::vector<size_t> table;
+
+    /// @brief Hash of exact bits of coordinates.
+    static size_t Hash(const Point<T, Container>& p);
+
+    bool Equal(size_t slot, const Point<T, Container>& p) const;
+
+    /// @brief Position of a point in the hash table or the empty position where it must be inserted.
+    size_t Position(const Point<T, Container>& p, size_t hash) const;
+
+    /// @brief Finds a point and marks it as the most recently used.
+    /// @return Index of a point or NONE.
+    size_t Find(const Point<T, Container>& p, size_t hash) const;
+
+    /// @brief Inserts a point. The least recently used point is evicted if the cache is full.
+    /// @return Index of a point.
+    size_t Insert(const Point<T, Container>& p, size_t hash) const;
+
+    void Unlink(size_t slot) const;
+    void PushFront(size_t slot) const;
+    void Erase(size_t slot) const;
+    void Reserve(size_t _dim) const;
+
+    void StoreGradient(size_t slot, const Point<T, Container>& gradient) const;
+    void LoadGradient(size_t slot, Point<T, Container>& gradient) const;
+public:
+    /// @brief Constructor of a function with a cache.
+    /// @param[in] _f Function for evaluation.
+    /// @param[in] _capacity Maximum count of remembered points. Zero disables the cache.
+    CachedFunction(GeneralFunction<T, Container>& _f, size_t _capacity = CACHESIZE);
+
+    void SetParam(GeneralFunction<T, Container>& _f, size_t _capacity = CACHESIZE);
+
+    /// @brief Forgets all points. Counters of hits and misses are not changed.
+    void Clear();
+
+    T Value(const Point<T, Container>& p) const override;
+    Point<T, Container> Gradient(const Point<T, Container>& p) const override;
+    T ValueAndGradient(const Point<T, Container>& p, Point<T, Container>& gradient) const override;
+
+    /// @brief Blocks of points are not cached, they are evaluated by the wrapped function.
+    void ValueBatch(std::span<const T* const> coords, std::span<T> values) const override;
+    void GradientBatch(std::span<const T* const> coords, std::span<T> gradients) const override;
+
+    /// @brief Products are not cached, they are evaluated by the wrapped function.
+    void HessianVectorProduct(const Point<T, Container>& p, const Point<T, Container>& v, Point<T, Container>& result) const override;
+
+    inline GeneralFunction<T, Container>& getFunction() const { return *f; }
+    inline size_t getCapacity() const { return capacity; }
+    inline size_t getSize() const { return used; }
+    inline size_t getHits() const { return hits; }
+    inline size_t getMisses() const { return misses; }
+};
+
+template <typename T, class Container>
+CachedFunction<T, Container>::CachedFunction(GeneralFunction<T, Container>& _f, size_t _capacity)
+    : f(&_f), capacity(_capacity), dim(0), used(0), head(NONE), tail(NONE), hits(0), misses(0)
+{
+
+}
+
+template <typename T, class Container>
+void CachedFunction<T, Container>::SetParam(GeneralFunction<T, Container>& _f, size_t _capacity)
+{
+    f = &_f;
+    capacity = _capacity;
+    dim = 0;
+    hits = misses = 0;
+
+    Clear();
+}
+
+template <typename T, class Container>
+void CachedFunction<T, Container>::Clear()
+{
+    used = 0;
+    head = tail = NONE;
+    std::fill(table.begin(), table.end(), NONE);
+}
+
+template <typename T, class Container>
+size_t CachedFunction<T, Container>::Hash(const Point<T, Container>& p)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (const T& a : p)
+    {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &a, sizeof(T));
+
+        for (unsigned char b : bytes)
+            hash = (hash ^ b) * 1099511628211ull;
+    }
+
+    return static_cast<size_t>(hash ^ (hash >> 29));
+}
+
+template <typename T, class Container>
+bool CachedFunction<T, Container>::Equal(size_t slot, const Point<T, Container>& p) const
+{
+    return std::memcmp(keys.data() + slot * dim, p.Data(), dim * sizeof(T)) == 0;
+}
+
+template <typename T, class Container>
+size_t CachedFunction<T, Container>::Position(const Point<T, Container>& p, size_t hash) const
+{
+    const size_t mask = table.size() - 1;
+    size_t i = hash & mask;
+
+    while (table[i] != NONE && !(hashes[table[i]] == hash && Equal(table[i], p)))
+        i = (i + 1) & mask;
+
+    return i;
+}
+
+template <typename T, class Container>
+void CachedFunction<T, Container>::Unlink(size_t slot) const
+{
+    (prev[slot] != NONE ? next[prev[slot]] : head) = next[slot];
+    (next[slot] != NONE ? prev[next[slot]] : tail) = prev[slot];
+}
+
+template <typename T, class Container>
+void CachedFunction<T, Container>::PushFront(size_t slot) const
+{
+    prev[slot] = NONE;
+    next[slot] = head;
+    (head != NONE ? prev[head] : tail) = slot;
+    head = slot;
+}
+
+template <typename T, class Container>
+void CachedFunction<T, Container>::Erase(size_t slot) const
+{
+    // Backward shift deletion keeps probe sequences of the linear probing without tombstones.
+    const size_t mask = table.size() - 1;
+    size_t i, j;
+
+    for (i = hashes[slot] & mask; table[i] != slot; i = (i + 1) & mask);
+
+    for (j = (i + 1) & mask; table[j] != NONE; j = (j + 1) & mask)
+    {
+        const size_t k = hashes[table[j]] & mask;
+
+        if ((j > i && (k <= i || k > j)) || (j < i && k <= i && k > j))
+        {
+            table[i] = table[j];
+            i = j;
+        }
+    }
+
+    table[i] = NONE;
+    Unlink(slot);
+}
+
+template <typename T, class Container>
+void CachedFunction<T, Container>::Reserve(size_t _dim) const
+{
+    size_t tableSize = 1;
+
+    while (tableSize < 2 * capacity)
+        tableSize *= 2;
+
+    dim = _dim;
+    keys.assign(capacity * dim, T{});
+    values.assign(capacity, T{});
+    gradients.assign(capacity * dim, T{});
+    states.assign(capacity, Empty);
+    hashes.assign(capacity, 0);
+    prev.assign(capacity, NONE);
+    next.assign(capacity, NONE);
+    table.assign(tableSize, NONE);
+    used = 0;
+    head = tail = NONE;
+}
+
+template <typename T, class Container>
+size_t CachedFunction<T, Container>::Find(const Point<T, Container>& p, size_t hash) const
+{
+    if (p.size() != dim || !used)
+        return NONE;
+
+    const size_t slot = table[Position(p, hash)];
+
+    if (slot != NONE && slot != head)
+    {
+        Unlink(slot);
+        PushFront(slot);
+    }
+
+    return slot;
+}
+
+template <typename T, class Container>
+size_t CachedFunction<T, Container>::Insert(const Point<T, Container>& p, size_t hash) const
+{
+    if (p.size() != dim)
+        Reserve(p.size());
+
+    size_t slot;
+
+    if (used < capacity)
+        slot = used++;
+    else
+    {
+        slot = tail;
+        Erase(slot);
+    }
+
+    std::copy(p.begin(), p.end(), keys.begin() + slot * dim);
+    hashes[slot] = hash;
+    states[slot] = Empty;
+    table[Position(p, hash)] = slot;
+    PushFront(slot);
+
+    return slot;
+}
+
+template <typename T, class Container>
+void CachedFunction<T, Container>::StoreGradient(size_t slot, const Point<T, Container>& gradient) const
+{
+    std::copy(gradient.begin(), gradient.end(), gradients.begin() + slot * dim);
+    states[slot] |= HasGradient;
+}
+
+template <typename T, class Container>
+void CachedFunction<T, Container>::LoadGradient(size_t slot, Point<T, Container>& gradient) const
+{
+    gradient.Resize(dim);
+    std::copy(gradients.begin() + slot * dim, gradients.begin() + (slot + 1) * dim, gradient.begin());
+}
+
+template <typename T, class Container>
+T CachedFunction<T, Container>::Value(const Point<T, Container>& p) const
+{
+    if (!capacity)
+    {
+        ++misses;
+
+        return f->Value(p);
+    }
+
+    const size_t hash = Hash(p);
+    size_t slot = Find(p, hash);
+
+    if (slot != NONE && (states[slot] & HasValue))
+    {
+        ++hits;
+
+        return values[slot];
+    }
+
+    ++misses;
+    const T value = f->Value(p);
+
+    if (slot == NONE)
+        slot = Insert(p, hash);
+
+    values[slot] = value;
+    states[slot] |= HasValue;
+
+    return value;
+}
+
+template <typename T, class Container>
+Point<T, Container> CachedFunction<T, Container>::Gradient(const Point<T, Container>& p) const
+{
+    if (!capacity)
+    {
+        ++misses;
+
+        return f->Gradient(p);
+    }
+
+    const size_t hash = Hash(p);
+    size_t slot = Find(p, hash);
+    Point<T, Container> gradient;
+
+    if (slot != NONE && (states[slot] & HasGradient))
+    {
+        ++hits;
+        LoadGradient(slot, gradient);
+
+        return gradient;
+    }
+
+    ++misses;
+    gradient = f->Gradient(p);
+
+    if (slot == NONE)
+        slot = Insert(p, hash);
+
+    StoreGradient(slot, gradient);
+
+    return gradient;
+}
+
+template <typename T, class Container>
+T CachedFunction<T, Container>::ValueAndGradient(const Point<T, Container>& p, Point<T, Container>& gradient) const
+{
+    if (!capacity)
+    {
+        ++misses;
+
+        return f->ValueAndGradient(p, gradient);
+    }
+
+    const size_t hash = Hash(p);
+    size_t slot = Find(p, hash);
+
+    if (slot != NONE && states[slot] == (HasValue | HasGradient))
+    {
+        ++hits;
+        LoadGradient(slot, gradient);
+
+        return values[slot];
+    }
+
+    ++misses;
+    const T value = f->ValueAndGradient(p, gradient);
+
+    if (slot == NONE)
+        slot = Insert(p, hash);
+
+    values[slot] = value;
+    states[slot] |= HasValue;
+    StoreGradient(slot, gradient);
+
+    return value;
+}
+
+template <typename T, class Container>
+void CachedFunction<T, Container>::ValueBatch(std::span<const T* const> coords, std::span<T> values) const
+{
+    f->ValueBatch(coords, values);
+}
+
+template <typename T, class Container>
+void CachedFunction<T, Container>::GradientBatch(std::span<const T* const> coords, std::span<T> gradients) const
+{
+    f->GradientBatch(coords, gradients);
+}
+
+template <typename T, class Container>
+void CachedFunction<T, Container>::HessianVectorProduct(const Point<T, Container>& p, const Point<T, Container>& v, Point<T, Container>& result) const
+{
+    f->HessianVectorProduct(p, v, result);
+}
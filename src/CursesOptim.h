@@ -7,7 +7,10 @@
 #include <sstream>
 #include <vector>
 #include <memory>
+#include <type_traits>
 #include "Point.h"
+#include "Expression.h"
+#include "FixedOptim.h"
 #include "OptMethod.h"
 #include "DiffStoper.h"
 #include "Optimization.h"
@@ -28,7 +31,7 @@ private:
 
     struct MenuParam
     {
-        enum Cond {Function, Method, Stoper, Param} condition;
+        enum Cond {Function, Method, Search, Stoper, Param} condition;
         bool choose;
         size_t numIter;
         T epsilon;
@@ -40,25 +43,27 @@ private:
         T prob;
         T delta;
         T alpha;
+        size_t cache;
         GeneralStop<T>* stoper;
         GeneralFunction<T>* f;
-        Optimization<T>* Opt;
         WindowParam wp;
         int numF;
         int numStoper;
         int numMethod;
+        /// @brief Line search of the Conjugate Vector Method, options are in order of LineSearchMode.
+        int numSearch;
         int numParam;
         int countF;
     } MyMenuParam;
 
     std::vector<FunctionData<T>> f;
+    /// @brief Functions entered by the user. They are owned here and referenced by f.
+    std::vector<std::unique_ptr<ExpressionFunction>> expressions;
     std::vector<WindowParam*> allWin;
     std::mt19937 generator;
     WindowParam MyWin, MyMenu, MyResult, MyFunction;
     NumStop<T> numStop;
     AbsStop<T> absStop;
-    DetermOptimization<T> determOptimization;
-    StochastOptimization<T> stochastOptimization;
 
     void PrintHeading(const WindowParam& wp);
 
@@ -68,10 +73,13 @@ private:
 
     void PrintFunction(WindowParam& Function, const Point<T>& min, const Point<T>& max, const Point<T>& res, const GeneralFunction<T>& f);
 
-    void PrintResult(WindowParam& Result, const Optimization<T>& Opt);
+    void PrintResult(WindowParam& Result, const RunResult<T>& run);
 
     void PrintError(WindowParam& Result, const std::string& message);
 
+    /// @brief Reads an expression in the result window, compiles it and adds it to the functions.
+    void ScanExpression(WindowParam& Result);
+
     void PrintCondition(int y, int x, typename MenuParam::Cond condition, const MenuParam& MyMenuParam, const WindowParam& Menu, const char* str);
 
     void PrintOption(int y, int x, int numOption, int valueOption, const MenuParam& MyMenuParam, const WindowParam& Menu, const char* str);
@@ -98,8 +106,12 @@ private:
     static constexpr T prob = 0.6;
     static constexpr T delta = 0.1;
     static constexpr T alpha = 0.2;
-    static const int countParam = 10;
+    static const size_t cache = 0;
+    static constexpr LineSearchMode lineSearch = LineSearchMode::Scan;
+    static const int countCondition = 5;
+    static const int countParam = 11;
     static const int countMethod = 2;
+    static const int countSearch = 4;
     static const int countStoper = 2;
 };
 
@@ -107,9 +119,7 @@ template <typename T>
 CursesOptim<T>::CursesOptim(std::vector<FunctionData<T>>& _f) : f(_f),
                                                           generator(std::chrono::system_clock::now().time_since_epoch().count()),
                                                           numStop(),
-                                                          absStop(_f[1].f),
-                                                          determOptimization(_f[1].f, numStop, epsilon, epsilonStep),
-                                                          stochastOptimization(_f[1].f, numStop, prob, delta)
+                                                          absStop()
 {
     int raw, col;
 
@@ -137,7 +147,7 @@ CursesOptim<T>::CursesOptim(std::vector<FunctionData<T>>& _f) : f(_f),
     PrintAllWin(allWin);
 
     MyMenuParam = {MenuParam::Function, false, numIter, epsilon, epsilonStep, generator(), Point<T>({-1.0, -1.0}), Point<T>({1.0, 1.0}),
-                   Point<T>({0.5, 0.5}), prob, delta, alpha, nullptr, &f[0].f, nullptr, MyMenu, 0, 0, 0, 0, int(f.size())};
+                   Point<T>({0.5, 0.5}), prob, delta, alpha, cache, nullptr, &f[0].f, MyMenu, 0, 0, 0, static_cast<int>(lineSearch), 0, int(f.size())};
 }
 
 template <typename T>
@@ -193,20 +203,30 @@ void CursesOptim<T>::PrintFunction(WindowParam& Function, const Point<T>& min, c
     }
 
     Point<T> width = max + (-min);
-    T maxValue = f.Value(Point<T>({min[0] + width[0] * (1.0 / (Function.col - 2)), min[1] + width[1] * (1.0 / (Function.raw - 2))}));
-    T minValue = maxValue, value;
+    const size_t cols = Function.col - 2, raws = Function.raw - 2;
+    std::vector<T> gridX(cols * raws), gridY(cols * raws), values(cols * raws);
 
-    for (int i{1}; i <= (Function.col - 2); ++i)
+    for (size_t i{1}; i <= cols; ++i)
     {
-        for (int j{1}; j <= (Function.raw - 2); ++j)
+        for (size_t j{1}; j <= raws; ++j)
         {
-            value = f.Value(Point<T>({min[0] + width[0] * (T(i) / (Function.col - 2)), min[1] + width[1] * (T(j) / (Function.raw - 2))}));
-
-            maxValue = std::max(maxValue, value);
-            minValue = std::min(minValue, value); 
+            gridX[(i - 1) * raws + j - 1] = min[0] + width[0] * (T(i) / cols);
+            gridY[(i - 1) * raws + j - 1] = min[1] + width[1] * (T(j) / raws);
         }
     }
 
+    const T* grid[] = {gridX.data(), gridY.data()};
+    f.ValueBatch(grid, values);
+
+    T maxValue = values[0];
+    T minValue = maxValue, value;
+
+    for (const T& v : values)
+    {
+        maxValue = std::max(maxValue, v);
+        minValue = std::min(minValue, v);
+    }
+
     maxValue += (maxValue - minValue) * epsilon;
 
     for (int i{1}; i <= (Function.col - 2); ++i)
@@ -219,7 +239,7 @@ void CursesOptim<T>::PrintFunction(WindowParam& Function, const Point<T>& min, c
                 std::abs(min[1] + width[1] * (T(j) / (Function.raw - 2)) - res[1]) < width[1] * (T(1) / (Function.raw - 2)) / 2)
                 MARKER = A_REVERSE;
 
-            value = f.Value(Point<T>({min[0] + width[0] * (T(i) / (Function.col - 2)), min[1] + width[1] * (T(j) / (Function.raw - 2))}));
+            value = values[(i - 1) * raws + j - 1];
             int letter = int((value - minValue) / (maxValue - minValue) * 52);
             mvwaddch(Function.win, Function.raw - 1 - j, i, (letter % 2 ? 'A' + letter / 2 : 'a' + letter / 2) | MARKER);
         }
@@ -229,19 +249,28 @@ void CursesOptim<T>::PrintFunction(WindowParam& Function, const Point<T>& min, c
 }
 
 template <typename T>
-void CursesOptim<T>::PrintResult(WindowParam& Result, const Optimization<T>& Opt)
+void CursesOptim<T>::PrintResult(WindowParam& Result, const RunResult<T>& run)
 {
     PrintWindow(Result);
 
     int x = 1, y = 1;
     std::stringstream ss;
-    ss << Opt.getPathway().back();
+    ss << run.pathway.back();
 
     mvwprintw(Result.win, y, x, "Point of min: %-.30s", ss.str().c_str());
     ss.str("");
-    ss << Opt.getValueLastPoint();
+    ss << run.summary.valueEnd;
     mvwprintw(Result.win, ++y, x, "Value in point: %-.30s", ss.str().c_str());
-    mvwprintw(Result.win, ++y, x, "Count of iterations: %lu", Opt.getPathway().size());
+    mvwprintw(Result.win, ++y, x, "Count of iterations: %lu", run.pathway.size());
+
+    const RunSummary<T>& summary = run.summary;
+    mvwprintw(Result.win, ++y, x, "Evaluations: %lu, cache hits: %lu, time: %.3f ms", summary.evaluations, summary.cacheHits, summary.time / 1e6);
+    mvwprintw(Result.win, ++y, x, "Decrease per evaluation: %g", static_cast<double>(summary.DecreasePerEvaluation()));
+
+    for (size_t i{}; i < summary.calls.size() && y < Result.raw - 2; ++i)
+        if (summary.calls[i].calls)
+            mvwprintw(Result.win, ++y, x, "%s: %lu calls, p50 %.0f ns, p99 %.0f ns", FunctionCallName(static_cast<FunctionCall>(i)),
+                      summary.calls[i].calls, summary.calls[i].p50, summary.calls[i].p99);
 
     wrefresh(Result.win);
 }
@@ -266,6 +295,55 @@ void CursesOptim<T>::PrintError(WindowParam& Result, const std::string& message)
     wrefresh(Result.win);
 }
 
+template <typename T>
+void CursesOptim<T>::ScanExpression(WindowParam& Result)
+{
+    PrintWindow(Result);
+
+    char buff[256];
+    int x = 1, y = 1;
+
+    mvwprintw(Result.win, y, x, "Function of x, y, z, w (2-4 variables):");
+    echo();
+    curs_set(1);
+    mvwgetnstr(Result.win, ++y, x, buff, sizeof(buff) - 1);
+    curs_set(0);
+    noecho();
+
+    if constexpr (!std::is_same_v<T, double>)
+        throw std::invalid_argument("Expressions are compiled for double only.");
+    else
+    {
+        auto expression = std::make_unique<ExpressionFunction>(buff);
+        const size_t dim = expression->getDimension();
+
+        if (dim < 2 || dim > 4)
+            throw std::invalid_argument("Dimension of the function must be from 2 to 4.");
+
+        Point<T> minArea, maxArea, start;
+        minArea.Resize(dim);
+        maxArea.Resize(dim);
+        start.Resize(dim);
+        minArea.Fill(-1);
+        maxArea.Fill(1);
+        start.Fill(0.5);
+
+        f.push_back({expression->getText(), *expression, minArea, maxArea, start});
+        expressions.push_back(std::move(expression));
+
+        MyMenuParam.countF = int(f.size());
+        MyMenuParam.numF = MyMenuParam.countF - 1;
+        MyMenuParam.minArea = minArea;
+        MyMenuParam.maxArea = maxArea;
+        MyMenuParam.start = start;
+
+        PrintWindow(Result);
+        mvwprintw(Result.win, 1, 1, "Function is added: %lu instructions, %lu with the gradient.",
+                  expressions.back()->getValueSize(), expressions.back()->getGradientSize());
+        wrefresh(Result.win);
+    }
+}
+
 template <typename T>
 void CursesOptim<T>::PrintCondition(int y, int x, typename MenuParam::Cond condition, const MenuParam& MyMenuParam, const WindowParam& Menu, const char* str)
 {
@@ -348,6 +426,7 @@ void CursesOptim<T>::PrintMenu(WindowParam& Menu, bool newparam)
 
     mvwprintw(Menu.win, y, x, "'q' - quit program");
     mvwprintw(Menu.win, --y, x, "'r' - start optimization");
+    mvwprintw(Menu.win, --y, x, "'f' - new function");
 
     if (!MyMenuParam.choose)
         mvwprintw(Menu.win, --y, x, "key right - choose option");
@@ -375,6 +454,12 @@ void CursesOptim<T>::PrintMenu(WindowParam& Menu, bool newparam)
         PrintOption(++y, x, MyMenuParam.numMethod, 0, MyMenuParam, Menu, "Deterministic");
         PrintOption(++y, x, MyMenuParam.numMethod, 1, MyMenuParam, Menu, "Stochastic");
 
+    PrintCondition(++y, x, MenuParam::Search, MyMenuParam, Menu, "Line searches");
+        PrintOption(++y, x, MyMenuParam.numSearch, 0, MyMenuParam, Menu, "Scan");
+        PrintOption(++y, x, MyMenuParam.numSearch, 1, MyMenuParam, Menu, "Brent");
+        PrintOption(++y, x, MyMenuParam.numSearch, 2, MyMenuParam, Menu, "Strong Wolfe");
+        PrintOption(++y, x, MyMenuParam.numSearch, 3, MyMenuParam, Menu, "Armijo");
+
     PrintCondition(++y, x, MenuParam::Stoper, MyMenuParam, Menu, "Stopers");
         PrintOption(++y, x, MyMenuParam.numStoper, 0, MyMenuParam, Menu, "Number");
         PrintOption(++y, x, MyMenuParam.numStoper, 1, MyMenuParam, Menu, "Abs");
@@ -400,6 +485,8 @@ void CursesOptim<T>::PrintMenu(WindowParam& Menu, bool newparam)
         ScanDoubleOption(y, x, MyMenuParam.numParam, 8, MyMenuParam.delta, Menu, newparam);
         PrintOption(++y, x, MyMenuParam.numParam, 9, MyMenuParam, Menu, "Alpha");
         ScanDoubleOption(y, x, MyMenuParam.numParam, 9, MyMenuParam.alpha, Menu, newparam);
+        PrintOption(++y, x, MyMenuParam.numParam, 10, MyMenuParam, Menu, "Cache");
+        ScanSizeTOption(y, x, MyMenuParam.numParam, 10, MyMenuParam.cache, Menu, newparam);
 
     noecho();
     wrefresh(Menu.win);
@@ -422,6 +509,10 @@ void CursesOptim<T>::changeOptim(int deltaOption)
         MyMenuParam.numMethod = (MyMenuParam.numMethod + countMethod + deltaOption) % countMethod;
         break;
 
+    case MenuParam::Search:
+        MyMenuParam.numSearch = (MyMenuParam.numSearch + countSearch + deltaOption) % countSearch;
+        break;
+
     case MenuParam::Stoper:
         MyMenuParam.numStoper = (MyMenuParam.numStoper + countStoper + deltaOption) % countStoper;
         break;
@@ -458,13 +549,13 @@ void CursesOptim<T>::main_loop()
             break;
         case KEY_UP:
             if (!MyMenuParam.choose)
-                MyMenuParam.condition = static_cast<typename MenuParam::Cond>((MyMenuParam.condition + 3) % 4);
+                MyMenuParam.condition = static_cast<typename MenuParam::Cond>((MyMenuParam.condition + countCondition - 1) % countCondition);
             else
                 changeOptim(-1);
             break;
         case KEY_DOWN:
             if (!MyMenuParam.choose)
-                MyMenuParam.condition = static_cast<typename MenuParam::Cond>((MyMenuParam.condition + 1) % 4);
+                MyMenuParam.condition = static_cast<typename MenuParam::Cond>((MyMenuParam.condition + 1) % countCondition);
             else
                 changeOptim(1);
             break;
@@ -488,26 +579,23 @@ void CursesOptim<T>::main_loop()
                 }
                 if (MyMenuParam.numStoper == 1)
                 {
-                    absStop.SetParam(*MyMenuParam.f, MyMenuParam.numIter, MyMenuParam.epsilon);
+                    absStop.SetParam(MyMenuParam.numIter, MyMenuParam.epsilon);
                     MyMenuParam.stoper = &absStop;
                 }
 
+                const CubicArea<T> area{MyMenuParam.minArea, MyMenuParam.maxArea};
+                RunResult<T> run;
+
                 if (MyMenuParam.numMethod == 0)
-                {
-                    determOptimization.SetParam(*MyMenuParam.f, *MyMenuParam.stoper, MyMenuParam.epsilon, MyMenuParam.epsilonStep);
-                    MyMenuParam.Opt = &determOptimization;
-                }
+                    run = OptimizeFixed<DetermOptimization>(*MyMenuParam.f, *MyMenuParam.stoper, area, MyMenuParam.start, MyMenuParam.cache,
+                                                            MyMenuParam.epsilon, MyMenuParam.epsilonStep,
+                                                            static_cast<LineSearchMode>(MyMenuParam.numSearch));
                 if (MyMenuParam.numMethod == 1)
-                {
-                    stochastOptimization.SetParam(*MyMenuParam.f, *MyMenuParam.stoper, MyMenuParam.prob, MyMenuParam.delta, MyMenuParam.seed, MyMenuParam.alpha);
-                    MyMenuParam.Opt = &stochastOptimization;
-                }
-
-                MyMenuParam.Opt->SetArea(MyMenuParam.minArea, MyMenuParam.maxArea);
-                MyMenuParam.Opt->DoOptimize(MyMenuParam.start);
+                    run = OptimizeFixed<StochastOptimization>(*MyMenuParam.f, *MyMenuParam.stoper, area, MyMenuParam.start, MyMenuParam.cache,
+                                                              MyMenuParam.prob, MyMenuParam.delta, MyMenuParam.seed, MyMenuParam.alpha);
 
-                PrintResult(MyResult, *MyMenuParam.Opt);
-                PrintFunction(MyFunction, MyMenuParam.minArea, MyMenuParam.maxArea, MyMenuParam.Opt->getPathway().back(), *MyMenuParam.f);
+                PrintResult(MyResult, run);
+                PrintFunction(MyFunction, MyMenuParam.minArea, MyMenuParam.maxArea, run.pathway.back(), *MyMenuParam.f);
 
                 MyMenuParam.seed = generator();
             }
@@ -517,6 +605,17 @@ void CursesOptim<T>::main_loop()
                 PrintWindow(MyFunction);
             }
 
+            break;
+        case 'f':
+            try
+            {
+                ScanExpression(MyResult);
+            }
+            catch(const std::exception& e)
+            {
+                PrintError(MyResult, e.what());
+            }
+
             break;
         case 'q':
             process = false;
@@ -1,89 +1,478 @@
 /// @file
-/// @brief Realization of the Number Stopper and the Absolute Stopper.
-/// @details File contains the definition of classes of the Number Stopper and the Absolute Stopper.
+/// @brief Realization of stoppers.
+/// @details File contains the definition of classes of the Number Stopper and the Absolute Stopper,
+/// of stoppers by the gradient norm, by relative changes of the value and of the point, by budgets of evaluations and of time,
+/// and of stoppers which combine other stoppers. Stoppers except NumStop and AbsStop do not bound the count of iterations,
+/// combine them with NumStop for it.
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
 #include <vector>
 #include "Optimization.h"
 
+/// @brief Count of steps for stoppers which do not bound the count of iterations.
+static const size_t NOSTEPLIMIT = std::numeric_limits<size_t>::max();
+
 /// @brief Class of the Number Stopper.
 /// @tparam T Typename of a point's coordinate.
-template <typename T>
-class NumStop : public GeneralStop<T>
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class NumStop : public GeneralStop<T, Container>
 {
 public:
     /// @brief Constructor of the Number Stopper.
     /// @param _maxStep Maximum count of a step of iteration.
-    NumStop(size_t _maxStep = MAXSTEP) : GeneralStop<T>(_maxStep) {};
+    NumStop(size_t _maxStep = MAXSTEP) : GeneralStop<T, Container>(_maxStep) {};
 
     void SetParam(size_t _maxStep = MAXSTEP);
 
     /// @brief Function of a condition for stoping.
-    /// @param[in] pathway Pathway of a optimization.
+    /// @param[in] state State of the last iteration.
     /// @return Result of a condition.
-    bool condition(const std::vector<Point<T>>& pathway) const override;
+    bool condition(const IterationState<T, Container>& state) override;
 };
 
-template <typename T>
-void NumStop<T>::SetParam(size_t _maxStep)
+template <typename T, class Container>
+void NumStop<T, Container>::SetParam(size_t _maxStep)
 {
     this->maxStep = _maxStep;
 }
 
-template <typename T>
-bool NumStop<T>::condition(const std::vector<Point<T>>& pathway) const
+template <typename T, class Container>
+bool NumStop<T, Container>::condition(const IterationState<T, Container>& state)
 {
-    return pathway.size() < this->maxStep;
+    return state.iteration < this->maxStep;
 }
 
 /// @brief Class of the Absolute Stopper.
+/// @details The optimization stops when the last decrease of the value of the function is less than epsilon.
+/// Iterations which do not change the value keep the last decrease, an increase of the value does not stop the optimization.
 /// @tparam T Typename of a point's coordinate.
-template <typename T>
-class AbsStop : public GeneralStop<T>
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class AbsStop : public GeneralStop<T, Container>
 {
 private:
-    GeneralFunction<T>& f;
     T epsilon;
+    /// @brief Value in the previous point and the last decrease of the value.
+    T previous;
+    T decrease;
 public:
     /// @brief Constructor of the Absolute Stopper.
-    /// @param _f Function for optimization.
     /// @param _maxStep Maximum count of a step of iteration.
     /// @param _epsilon Condition of stopping.
-    AbsStop(GeneralFunction<T>& _f, size_t _maxStep = MAXSTEP, T _epsilon = 0.001)
-        : GeneralStop<T>(_maxStep), f(_f), epsilon(_epsilon)
+    AbsStop(size_t _maxStep = MAXSTEP, T _epsilon = 0.001) : GeneralStop<T, Container>(_maxStep), epsilon(_epsilon)
     {
         if (epsilon <= 0)
             throw std::invalid_argument("Epsilon must be greater than zero.");
+
+        Reset();
     }
 
-    void SetParam(GeneralFunction<T>& _f, size_t _maxStep = MAXSTEP, T _epsilon = 0.001);
+    void SetParam(size_t _maxStep = MAXSTEP, T _epsilon = 0.001);
+
+    void Reset() override;
 
     /// @brief Function of a condition for stoping.
-    /// @param[in] pathway Pathway of a optimization.
+    /// @param[in] state State of the last iteration.
     /// @return Result of a condition.
-    bool condition(const std::vector<Point<T>>& pathway) const override;
+    bool condition(const IterationState<T, Container>& state) override;
 };
 
-template <typename T>
-void AbsStop<T>::SetParam(GeneralFunction<T>& _f, size_t _maxStep, T _epsilon)
+template <typename T, class Container>
+void AbsStop<T, Container>::SetParam(size_t _maxStep, T _epsilon)
 {
-    if (epsilon <= 0)
+    if (_epsilon <= 0)
         throw std::invalid_argument("Epsilon must be greater than zero.");
 
-    f = _f;
     this->maxStep = _maxStep;
     epsilon = _epsilon;
 }
 
-template <typename T>
-bool AbsStop<T>::condition(const std::vector<Point<T>>& pathway) const
+template <typename T, class Container>
+void AbsStop<T, Container>::Reset()
+{
+    previous = std::numeric_limits<T>::max();
+    decrease = std::numeric_limits<T>::max();
+}
+
+template <typename T, class Container>
+bool AbsStop<T, Container>::condition(const IterationState<T, Container>& state)
 {
-    if (pathway.size() >= this->maxStep)
+    if (state.iteration >= this->maxStep)
         return false;
 
-    for (auto it = pathway.rbegin() + 1; it < pathway.rend(); ++it)
-        if (f.Value(pathway.back()) < f.Value(*it))
-            return !(f.Value(*it) - f.Value(pathway.back()) < epsilon);
-    
-    return true;
-}
\ No newline at end of file
+    if (state.iteration > 1)
+    {
+        if (state.value < previous)
+            decrease = previous - state.value;
+        else if (state.value > previous)
+            decrease = std::numeric_limits<T>::max();
+    }
+
+    previous = state.value;
+
+    return !(decrease < epsilon);
+}
+
+/// @brief Class of the Gradient Stopper.
+/// @details The optimization stops when the norm of the gradient is not greater than epsilon.
+/// Methods which do not know the gradient (the Stochastic Method) are not stopped.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class GradStop : public GeneralStop<T, Container>
+{
+private:
+    T epsilon;
+public:
+    /// @brief Constructor of the Gradient Stopper.
+    /// @param _epsilon Norm of the gradient for stopping.
+    GradStop(T _epsilon = 1e-6) : GeneralStop<T, Container>(NOSTEPLIMIT), epsilon(_epsilon)
+    {
+        if (epsilon <= 0)
+            throw std::invalid_argument("Epsilon must be greater than zero.");
+    }
+
+    void SetParam(T _epsilon = 1e-6);
+
+    bool condition(const IterationState<T, Container>& state) override;
+};
+
+template <typename T, class Container>
+void GradStop<T, Container>::SetParam(T _epsilon)
+{
+    if (_epsilon <= 0)
+        throw std::invalid_argument("Epsilon must be greater than zero.");
+
+    epsilon = _epsilon;
+}
+
+template <typename T, class Container>
+bool GradStop<T, Container>::condition(const IterationState<T, Container>& state)
+{
+    return !state.hasGradient || state.gradientNorm > epsilon;
+}
+
+/// @brief Class of the Target Stopper.
+/// @details The optimization stops when the value is not greater than the target, for example the known minimum plus a tolerance.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class TargetStop : public GeneralStop<T, Container>
+{
+private:
+    T target;
+public:
+    /// @brief Constructor of the Target Stopper.
+    /// @param _target Value for stopping.
+    TargetStop(T _target) : GeneralStop<T, Container>(NOSTEPLIMIT), target(_target) {}
+
+    void SetParam(T _target) { target = _target; }
+
+    bool condition(const IterationState<T, Container>& state) override { return state.value > target; }
+};
+
+/// @brief Class of the Relative Stopper.
+/// @details An iteration makes no progress if the change of the value is not greater than
+/// tolerance * max(|previous value|, |value|, 1). The optimization stops after patience iterations in a row without progress.
+/// The patience greater than 1 suits the Stochastic Method, which often stays in the same point.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class RelStop : public GeneralStop<T, Container>
+{
+private:
+    T tolerance;
+    size_t patience;
+    T previous;
+    size_t stalled;
+public:
+    /// @brief Constructor of the Relative Stopper.
+    /// @param _tolerance Relative change of the value.
+    /// @param _patience Count of iterations in a row without progress for stopping.
+    RelStop(T _tolerance = 1e-8, size_t _patience = 1) : GeneralStop<T, Container>(NOSTEPLIMIT)
+    {
+        SetParam(_tolerance, _patience);
+        Reset();
+    }
+
+    void SetParam(T _tolerance = 1e-8, size_t _patience = 1);
+
+    void Reset() override { stalled = 0; }
+
+    bool condition(const IterationState<T, Container>& state) override;
+};
+
+template <typename T, class Container>
+void RelStop<T, Container>::SetParam(T _tolerance, size_t _patience)
+{
+    if (_tolerance < 0)
+        throw std::invalid_argument("Tolerance must not be less than zero.");
+
+    if (!_patience)
+        throw std::invalid_argument("Patience must be greater than zero.");
+
+    tolerance = _tolerance;
+    patience = _patience;
+}
+
+template <typename T, class Container>
+bool RelStop<T, Container>::condition(const IterationState<T, Container>& state)
+{
+    using std::abs;
+
+    if (state.iteration > 1)
+    {
+        const T scale = std::max({abs(previous), abs(state.value), static_cast<T>(1)});
+
+        stalled = abs(previous - state.value) <= tolerance * scale ? stalled + 1 : 0;
+    }
+
+    previous = state.value;
+
+    return stalled < patience;
+}
+
+/// @brief Class of the Step Stopper.
+/// @details An iteration makes no progress if the length of the step is not greater than tolerance * max(|point|, 1).
+/// The optimization stops after patience iterations in a row without progress.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class StepStop : public GeneralStop<T, Container>
+{
+private:
+    T tolerance;
+    size_t patience;
+    size_t stalled;
+public:
+    /// @brief Constructor of the Step Stopper.
+    /// @param _tolerance Relative length of the step.
+    /// @param _patience Count of iterations in a row without progress for stopping.
+    StepStop(T _tolerance = 1e-8, size_t _patience = 1) : GeneralStop<T, Container>(NOSTEPLIMIT)
+    {
+        SetParam(_tolerance, _patience);
+        Reset();
+    }
+
+    void SetParam(T _tolerance = 1e-8, size_t _patience = 1);
+
+    void Reset() override { stalled = 0; }
+
+    bool condition(const IterationState<T, Container>& state) override;
+};
+
+template <typename T, class Container>
+void StepStop<T, Container>::SetParam(T _tolerance, size_t _patience)
+{
+    if (_tolerance < 0)
+        throw std::invalid_argument("Tolerance must not be less than zero.");
+
+    if (!_patience)
+        throw std::invalid_argument("Patience must be greater than zero.");
+
+    tolerance = _tolerance;
+    patience = _patience;
+}
+
+template <typename T, class Container>
+bool StepStop<T, Container>::condition(const IterationState<T, Container>& state)
+{
+    if (state.iteration > 1)
+    {
+        // The norm of the point is needed only for short steps.
+        const bool shortStep = state.stepLength <= tolerance * std::max(Norm(state.point), static_cast<T>(1));
+
+        stalled = shortStep ? stalled + 1 : 0;
+    }
+
+    return stalled < patience;
+}
+
+/// @brief Class of the Evaluation Stopper.
+/// @details The optimization stops when the next iteration would exceed the budget of evaluations,
+/// assuming it costs as much as the last one. Only evaluations through the virtual interface are counted.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class EvalStop : public GeneralStop<T, Container>
+{
+private:
+    size_t budget;
+    size_t previous;
+public:
+    /// @brief Constructor of the Evaluation Stopper.
+    /// @param _budget Maximum count of evaluated points.
+    EvalStop(size_t _budget) : GeneralStop<T, Container>(NOSTEPLIMIT), budget(_budget), previous(0) {}
+
+    void SetParam(size_t _budget) { budget = _budget; }
+
+    void Reset() override { previous = 0; }
+
+    bool condition(const IterationState<T, Container>& state) override;
+};
+
+template <typename T, class Container>
+bool EvalStop<T, Container>::condition(const IterationState<T, Container>& state)
+{
+    const size_t last = state.evaluations - previous;
+    previous = state.evaluations;
+
+    return state.evaluations < budget && last <= budget - state.evaluations;
+}
+
+/// @brief Class of the Time Stopper.
+/// @details The optimization stops when the next iteration would end after the deadline,
+/// assuming it takes as much time as the last one. So a run returns on time unless one iteration is slower than the previous one.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class TimeStop : public GeneralStop<T, Container>
+{
+private:
+    /// @brief Budget and the time of the previous point in nanoseconds.
+    double budget;
+    double previous;
+public:
+    /// @brief Constructor of the Time Stopper.
+    /// @param _budget Maximum wall time of a run.
+    TimeStop(std::chrono::nanoseconds _budget) : GeneralStop<T, Container>(NOSTEPLIMIT), budget(static_cast<double>(_budget.count())), previous(0) {}
+
+    void SetParam(std::chrono::nanoseconds _budget) { budget = static_cast<double>(_budget.count()); }
+
+    void Reset() override { previous = 0; }
+
+    bool condition(const IterationState<T, Container>& state) override;
+};
+
+template <typename T, class Container>
+bool TimeStop<T, Container>::condition(const IterationState<T, Container>& state)
+{
+    const double last = state.elapsed - previous;
+    previous = state.elapsed;
+
+    return state.elapsed + last < budget;
+}
+
+/// @brief Stopper which stops when any of its stoppers stops.
+/// @details Every stopper sees every state, so running aggregates of all stoppers are correct.
+/// Stoppers are stored by pointers and must live as long as the combination.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class AnyOf : public GeneralStop<T, Container>
+{
+private:
+    std::vector<GeneralStop<T, Container>*> stoppers;
+public:
+    /// @brief Constructor of a combination.
+    /// @param _stoppers Stoppers.
+    AnyOf(std::initializer_list<GeneralStop<T, Container>*> _stoppers);
+
+    /// @brief The least maximum step of the stoppers. It is read on every call, so changes of the stoppers are seen.
+    size_t getMaxStep() const override;
+
+    void Reset() override;
+
+    bool condition(const IterationState<T, Container>& state) override;
+};
+
+template <typename T, class Container>
+AnyOf<T, Container>::AnyOf(std::initializer_list<GeneralStop<T, Container>*> _stoppers) : GeneralStop<T, Container>(NOSTEPLIMIT), stoppers(_stoppers)
+{
+    if (stoppers.empty())
+        throw std::invalid_argument("Combination must have stoppers.");
+}
+
+template <typename T, class Container>
+size_t AnyOf<T, Container>::getMaxStep() const
+{
+    size_t res = NOSTEPLIMIT;
+
+    for (const auto stopper : stoppers)
+        res = std::min(res, stopper->getMaxStep());
+
+    return res;
+}
+
+template <typename T, class Container>
+void AnyOf<T, Container>::Reset()
+{
+    for (auto stopper : stoppers)
+        stopper->Reset();
+}
+
+template <typename T, class Container>
+bool AnyOf<T, Container>::condition(const IterationState<T, Container>& state)
+{
+    bool res = true;
+
+    for (auto stopper : stoppers)
+        res = stopper->condition(state) && res;
+
+    return res;
+}
+
+/// @brief Stopper which stops when all of its stoppers stop.
+/// @details Every stopper sees every state, so running aggregates of all stoppers are correct.
+/// Stoppers are stored by pointers and must live as long as the combination.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class AllOf : public GeneralStop<T, Container>
+{
+private:
+    std::vector<GeneralStop<T, Container>*> stoppers;
+public:
+    /// @brief Constructor of a combination.
+    /// @param _stoppers Stoppers.
+    AllOf(std::initializer_list<GeneralStop<T, Container>*> _stoppers);
+
+    /// @brief The greatest maximum step of the stoppers. It is read on every call, so changes of the stoppers are seen.
+    size_t getMaxStep() const override;
+
+    void Reset() override;
+
+    bool condition(const IterationState<T, Container>& state) override;
+};
+
+template <typename T, class Container>
+AllOf<T, Container>::AllOf(std::initializer_list<GeneralStop<T, Container>*> _stoppers) : GeneralStop<T, Container>(0), stoppers(_stoppers)
+{
+    if (stoppers.empty())
+        throw std::invalid_argument("Combination must have stoppers.");
+}
+
+template <typename T, class Container>
+size_t AllOf<T, Container>::getMaxStep() const
+{
+    size_t res = 0;
+
+    for (const auto stopper : stoppers)
+        res = std::max(res, stopper->getMaxStep());
+
+    return res;
+}
+
+template <typename T, class Container>
+void AllOf<T, Container>::Reset()
+{
+    for (auto stopper : stoppers)
+        stopper->Reset();
+}
+
+template <typename T, class Container>
+bool AllOf<T, Container>::condition(const IterationState<T, Container>& state)
+{
+    bool res = false;
+
+    for (auto stopper : stoppers)
+        res = stopper->condition(state) || res;
+
+    return res;
+}
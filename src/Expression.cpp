@@ -0,0 +1,739 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include "Expression.h"
+#include "PointKernels.h"
+
+using Expression::Instruction;
+using Expression::Op;
+using Expression::Program;
+
+namespace
+{
+    const uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    /// @brief Count of points in a block of the batch interpreter.
+    const size_t BLOCK = 64;
+
+    bool IsUnary(Op op)
+    {
+        return op == Op::Neg || op >= Op::Sin;
+    }
+
+    double Apply(Op op, double a, double b)
+    {
+        switch (op)
+        {
+        case Op::Add: return a + b;
+        case Op::Sub: return a - b;
+        case Op::Mul: return a * b;
+        case Op::Div: return a / b;
+        case Op::Neg: return -a;
+        case Op::Pow: return std::pow(a, b);
+        case Op::Sin: return std::sin(a);
+        case Op::Cos: return std::cos(a);
+        case Op::Tan: return std::tan(a);
+        case Op::Exp: return std::exp(a);
+        case Op::Log: return std::log(a);
+        case Op::Sqrt: return std::sqrt(a);
+        case Op::Abs: return std::abs(a);
+        case Op::Sign: return (a > 0) - (a < 0);
+        default: return a;
+        }
+    }
+
+    /// @brief One instruction over a block of points: every case is a vectorized loop.
+    VECTORIZED
+    void Execute(Op op, double* dst, const double* a, const double* b, size_t n)
+    {
+        switch (op)
+        {
+        case Op::Add: for (size_t i{}; i < n; ++i) dst[i] = a[i] + b[i]; break;
+        case Op::Sub: for (size_t i{}; i < n; ++i) dst[i] = a[i] - b[i]; break;
+        case Op::Mul: for (size_t i{}; i < n; ++i) dst[i] = a[i] * b[i]; break;
+        case Op::Div: for (size_t i{}; i < n; ++i) dst[i] = a[i] / b[i]; break;
+        case Op::Neg: for (size_t i{}; i < n; ++i) dst[i] = -a[i]; break;
+        case Op::Sqrt: for (size_t i{}; i < n; ++i) dst[i] = std::sqrt(a[i]); break;
+        case Op::Abs: for (size_t i{}; i < n; ++i) dst[i] = std::abs(a[i]); break;
+        case Op::Sign: for (size_t i{}; i < n; ++i) dst[i] = (a[i] > 0) - (a[i] < 0); break;
+        default: for (size_t i{}; i < n; ++i) dst[i] = Apply(op, a[i], b[i]); break;
+        }
+    }
+
+    /// @brief Node of a graph of an expression. Var keeps the index of a variable in a, Const keeps value.
+    struct Node
+    {
+        Op op;
+        uint32_t a;
+        uint32_t b;
+        double value;
+
+        bool operator==(const Node& other) const
+        {
+            return op == other.op && a == other.a && b == other.b && std::memcmp(&value, &other.value, sizeof(double)) == 0;
+        }
+    };
+
+    struct NodeHash
+    {
+        size_t operator()(const Node& node) const
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &node.value, sizeof(double));
+
+            uint64_t hash = static_cast<uint64_t>(node.op);
+            hash = hash * 1099511628211ull ^ node.a;
+            hash = hash * 1099511628211ull ^ node.b;
+            hash = hash * 1099511628211ull ^ bits;
+
+            return static_cast<size_t>(hash ^ (hash >> 29));
+        }
+    };
+
+    /// @brief Graph of an expression. Equal nodes are created once, so equal subexpressions are shared.
+    /// A node is created after its arguments, so the order of nodes is topological.
+    class Graph
+    {
+    private:
+        std::vector<Node> nodes;
+        std::unordered_map<Node, uint32_t, NodeHash> table;
+
+        uint32_t Insert(const Node& node)
+        {
+            auto [it, inserted] = table.try_emplace(node, static_cast<uint32_t>(nodes.size()));
+
+            if (inserted)
+                nodes.push_back(node);
+
+            return it->second;
+        }
+
+        bool IsConst(uint32_t i, double value) const
+        {
+            return nodes[i].op == Op::Const && nodes[i].value == value;
+        }
+    public:
+        const Node& operator[](uint32_t i) const { return nodes[i]; }
+        size_t size() const { return nodes.size(); }
+
+        uint32_t Constant(double value)
+        {
+            return Insert({Op::Const, NONE, NONE, value});
+        }
+
+        uint32_t Variable(size_t i)
+        {
+            return Insert({Op::Var, static_cast<uint32_t>(i), NONE, 0});
+        }
+
+        /// @brief Node of an operation. Operations on constants are folded, identities are simplified.
+        uint32_t Make(Op op, uint32_t a, uint32_t b = NONE)
+        {
+            if (nodes[a].op == Op::Const && (IsUnary(op) || nodes[b].op == Op::Const))
+                return Constant(Apply(op, nodes[a].value, IsUnary(op) ? 0 : nodes[b].value));
+
+            switch (op)
+            {
+            case Op::Add:
+                if (IsConst(a, 0))
+                    return b;
+                if (IsConst(b, 0))
+                    return a;
+                if (a > b)
+                    std::swap(a, b);
+                break;
+            case Op::Sub:
+                if (IsConst(b, 0))
+                    return a;
+                if (IsConst(a, 0))
+                    return Make(Op::Neg, b);
+                if (a == b)
+                    return Constant(0);
+                break;
+            case Op::Mul:
+                if (IsConst(a, 0) || IsConst(b, 0))
+                    return Constant(0);
+                if (IsConst(a, 1))
+                    return b;
+                if (IsConst(b, 1))
+                    return a;
+                if (IsConst(a, -1))
+                    return Make(Op::Neg, b);
+                if (IsConst(b, -1))
+                    return Make(Op::Neg, a);
+                if (a > b)
+                    std::swap(a, b);
+                break;
+            case Op::Div:
+                if (IsConst(b, 1))
+                    return a;
+                if (IsConst(a, 0))
+                    return Constant(0);
+                break;
+            case Op::Neg:
+                if (nodes[a].op == Op::Neg)
+                    return nodes[a].a;
+                break;
+            case Op::Pow:
+                if (IsConst(b, 1))
+                    return a;
+                if (IsConst(b, 0))
+                    return Constant(1);
+                if (IsConst(b, 2))
+                    return Make(Op::Mul, a, a);
+                break;
+            default:
+                break;
+            }
+
+            return Insert({op, a, IsUnary(op) ? NONE : b, 0});
+        }
+    };
+
+    /// @brief Recursive descent parser of an expression into a graph.
+    class Parser
+    {
+    private:
+        const std::string& text;
+        size_t pos;
+        Graph& graph;
+        /// @brief Nodes of variables by index, NONE for unused variables.
+        std::vector<uint32_t>& variables;
+
+        [[noreturn]] void Error(const std::string& message) const
+        {
+            throw std::invalid_argument(message + " at position " + std::to_string(pos + 1) + " of \"" + text + "\".");
+        }
+
+        void Skip()
+        {
+            while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos])))
+                ++pos;
+        }
+
+        bool Accept(const char* token)
+        {
+            Skip();
+
+            const size_t length = std::strlen(token);
+
+            if (text.compare(pos, length, token) != 0)
+                return false;
+
+            pos += length;
+
+            return true;
+        }
+
+        bool StartsPrimary()
+        {
+            Skip();
+
+            if (pos >= text.size())
+                return false;
+
+            const char c = text[pos];
+
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '_' || c == '\\' || c == '(';
+        }
+
+        uint32_t Sum()
+        {
+            uint32_t res = Product();
+
+            for (;;)
+                if (Accept("+"))
+                    res = graph.Make(Op::Add, res, Product());
+                else if (Accept("-"))
+                    res = graph.Make(Op::Sub, res, Product());
+                else
+                    return res;
+        }
+
+        uint32_t Product()
+        {
+            uint32_t res = Unary();
+
+            for (;;)
+                if (Accept("*"))
+                    res = graph.Make(Op::Mul, res, Unary());
+                else if (Accept("/"))
+                    res = graph.Make(Op::Div, res, Unary());
+                else if (StartsPrimary())
+                    res = graph.Make(Op::Mul, res, Power());
+                else
+                    return res;
+        }
+
+        uint32_t Unary()
+        {
+            if (Accept("-"))
+                return graph.Make(Op::Neg, Unary());
+
+            if (Accept("+"))
+                return Unary();
+
+            return Power();
+        }
+
+        uint32_t Power()
+        {
+            const uint32_t base = Primary();
+
+            // The power is right associative and binds tighter than the unary minus on its left: -x^2 = -(x^2).
+            if (Accept("^") || Accept("**"))
+                return graph.Make(Op::Pow, base, Unary());
+
+            return base;
+        }
+
+        uint32_t Function(Op op)
+        {
+            if (!Accept("("))
+                Error("Expected '('");
+
+            const uint32_t arg = Sum();
+
+            if (!Accept(")"))
+                Error("Expected ')'");
+
+            return graph.Make(op, arg);
+        }
+
+        uint32_t Variable(size_t i)
+        {
+            if (i >= variables.size())
+                variables.resize(i + 1, NONE);
+
+            if (variables[i] == NONE)
+                variables[i] = graph.Variable(i);
+
+            return variables[i];
+        }
+
+        uint32_t Name()
+        {
+            if (text[pos] == '\\')
+                ++pos;
+
+            const size_t begin = pos;
+
+            while (pos < text.size() && (std::isalpha(static_cast<unsigned char>(text[pos])) || text[pos] == '_'))
+                ++pos;
+
+            const size_t letters = pos;
+
+            while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])))
+                ++pos;
+
+            const std::string name = text.substr(begin, letters - begin), index = text.substr(letters, pos - letters);
+
+            if (name.empty())
+                Error("Expected a name");
+
+            if (!index.empty())
+            {
+                if (name != "x" || std::stoul(index) == 0)
+                    Error("Unknown variable " + name + index);
+
+                return Variable(std::stoul(index) - 1);
+            }
+
+            static const std::pair<const char*, Op> functions[] = {{"sin", Op::Sin}, {"cos", Op::Cos}, {"tan", Op::Tan}, {"exp", Op::Exp},
+                                                                   {"log", Op::Log}, {"ln", Op::Log}, {"sqrt", Op::Sqrt}, {"abs", Op::Abs}};
+
+            for (const auto& [function, op] : functions)
+                if (name == function)
+                    return Function(op);
+
+            if (name == "pi")
+                return graph.Constant(M_PI);
+
+            if (name == "e")
+                return graph.Constant(M_E);
+
+            static const char* names[] = {"x", "y", "z", "w"};
+
+            for (size_t i{}; i < 4; ++i)
+                if (name == names[i])
+                    return Variable(i);
+
+            // A word of variable letters is their product: "xy" = x * y.
+            if (name.find_first_not_of("xyzw") == std::string::npos)
+            {
+                uint32_t res = Variable(std::string("xyzw").find(name[0]));
+
+                for (size_t i = 1; i < name.size(); ++i)
+                    res = graph.Make(Op::Mul, res, Variable(std::string("xyzw").find(name[i])));
+
+                return res;
+            }
+
+            pos = begin;
+            Error("Unknown name " + name);
+        }
+
+        uint32_t Primary()
+        {
+            Skip();
+
+            if (pos >= text.size())
+                Error("Unexpected end");
+
+            if (Accept("("))
+            {
+                const uint32_t res = Sum();
+
+                if (!Accept(")"))
+                    Error("Expected ')'");
+
+                return res;
+            }
+
+            if (std::isdigit(static_cast<unsigned char>(text[pos])) || text[pos] == '.')
+            {
+                const char* begin = text.c_str() + pos;
+                char* end;
+                const double value = std::strtod(begin, &end);
+
+                if (end == begin)
+                    Error("Expected a number");
+
+                pos += end - begin;
+
+                return graph.Constant(value);
+            }
+
+            if (std::isalpha(static_cast<unsigned char>(text[pos])) || text[pos] == '_' || text[pos] == '\\')
+                return Name();
+
+            Error(std::string("Unexpected symbol '") + text[pos] + "'");
+        }
+    public:
+        Parser(const std::string& _text, Graph& _graph, std::vector<uint32_t>& _variables)
+            : text(_text), pos(0), graph(_graph), variables(_variables) {}
+
+        uint32_t Parse()
+        {
+            const uint32_t res = Sum();
+
+            Skip();
+
+            if (pos < text.size())
+                Error(std::string("Unexpected symbol '") + text[pos] + "'");
+
+            return res;
+        }
+    };
+
+    /// @brief Builds the gradient of a node by the reverse accumulation on the graph.
+    /// @return Nodes of derivatives by variables.
+    std::vector<uint32_t> Differentiate(Graph& graph, uint32_t root, const std::vector<uint32_t>& variables, size_t dim)
+    {
+        std::vector<uint32_t> adjoint(root + 1, NONE);
+        adjoint[root] = graph.Constant(1);
+
+        auto add = [&](uint32_t target, uint32_t contribution)
+        {
+            adjoint[target] = adjoint[target] == NONE ? contribution : graph.Make(Op::Add, adjoint[target], contribution);
+        };
+
+        // Adjoints flow from a node to its arguments, which have smaller indexes.
+        for (uint32_t n = root + 1; n-- > 0;)
+        {
+            if (adjoint[n] == NONE)
+                continue;
+
+            const Node node = graph[n];
+            const uint32_t d = adjoint[n];
+
+            switch (node.op)
+            {
+            case Op::Add:
+                add(node.a, d);
+                add(node.b, d);
+                break;
+            case Op::Sub:
+                add(node.a, d);
+                add(node.b, graph.Make(Op::Neg, d));
+                break;
+            case Op::Mul:
+                add(node.a, graph.Make(Op::Mul, d, node.b));
+                add(node.b, graph.Make(Op::Mul, d, node.a));
+                break;
+            case Op::Div:
+                add(node.a, graph.Make(Op::Div, d, node.b));
+                add(node.b, graph.Make(Op::Neg, graph.Make(Op::Div, graph.Make(Op::Mul, d, n), node.b)));
+                break;
+            case Op::Neg:
+                add(node.a, graph.Make(Op::Neg, d));
+                break;
+            case Op::Pow:
+                add(node.a, graph.Make(Op::Mul, d, graph.Make(Op::Mul, node.b,
+                    graph.Make(Op::Pow, node.a, graph.Make(Op::Sub, node.b, graph.Constant(1))))));
+
+                if (graph[node.b].op != Op::Const)
+                    add(node.b, graph.Make(Op::Mul, d, graph.Make(Op::Mul, n, graph.Make(Op::Log, node.a))));
+                break;
+            case Op::Sin:
+                add(node.a, graph.Make(Op::Mul, d, graph.Make(Op::Cos, node.a)));
+                break;
+            case Op::Cos:
+                add(node.a, graph.Make(Op::Neg, graph.Make(Op::Mul, d, graph.Make(Op::Sin, node.a))));
+                break;
+            case Op::Tan:
+                add(node.a, graph.Make(Op::Mul, d, graph.Make(Op::Add, graph.Constant(1), graph.Make(Op::Mul, n, n))));
+                break;
+            case Op::Exp:
+                add(node.a, graph.Make(Op::Mul, d, n));
+                break;
+            case Op::Log:
+                add(node.a, graph.Make(Op::Div, d, node.a));
+                break;
+            case Op::Sqrt:
+                add(node.a, graph.Make(Op::Div, graph.Make(Op::Mul, d, graph.Constant(0.5)), n));
+                break;
+            case Op::Abs:
+                add(node.a, graph.Make(Op::Mul, d, graph.Make(Op::Sign, node.a)));
+                break;
+            default:
+                break;
+            }
+        }
+
+        std::vector<uint32_t> gradient(dim);
+
+        for (size_t i{}; i < dim; ++i)
+            gradient[i] = i < variables.size() && variables[i] != NONE && adjoint[variables[i]] != NONE ? adjoint[variables[i]] : graph.Constant(0);
+
+        return gradient;
+    }
+
+    /// @brief Generates a program which computes nodes of outputs.
+    Program Generate(const Graph& graph, const std::vector<uint32_t>& outputs, size_t dim)
+    {
+        Program program;
+        program.dim = dim;
+
+        std::vector<char> live(graph.size(), 0);
+        std::vector<uint32_t> stack(outputs), order;
+
+        while (!stack.empty())
+        {
+            const uint32_t n = stack.back();
+            stack.pop_back();
+
+            if (live[n])
+                continue;
+
+            live[n] = 1;
+
+            if (graph[n].op != Op::Const && graph[n].op != Op::Var)
+            {
+                stack.push_back(graph[n].a);
+
+                if (graph[n].b != NONE)
+                    stack.push_back(graph[n].b);
+            }
+        }
+
+        std::vector<uint32_t> reg(graph.size(), NONE);
+
+        for (uint32_t n{}; n < graph.size(); ++n)
+            if (live[n] && graph[n].op == Op::Var)
+                reg[n] = graph[n].a;
+            else if (live[n] && graph[n].op == Op::Const)
+            {
+                reg[n] = static_cast<uint32_t>(dim + program.constants.size());
+                program.constants.push_back(graph[n].value);
+            }
+            else if (live[n])
+                order.push_back(n);
+
+        // Last instruction which reads a node. Outputs are read after the program, their registers are never reused.
+        const size_t END = std::numeric_limits<size_t>::max();
+        std::vector<size_t> lastUse(graph.size(), 0);
+
+        for (size_t k{}; k < order.size(); ++k)
+        {
+            lastUse[graph[order[k]].a] = k;
+
+            if (graph[order[k]].b != NONE)
+                lastUse[graph[order[k]].b] = k;
+        }
+
+        for (uint32_t n : outputs)
+            lastUse[n] = END;
+
+        const uint32_t temporaries = static_cast<uint32_t>(dim + program.constants.size());
+        uint32_t next = temporaries;
+        std::vector<uint32_t> free;
+
+        for (size_t k{}; k < order.size(); ++k)
+        {
+            const Node& node = graph[order[k]];
+
+            // Arguments read for the last time are freed before the result is allocated, so an instruction may work in place.
+            for (uint32_t arg : {node.a, node.b})
+                if (arg != NONE && lastUse[arg] == k && reg[arg] >= temporaries && std::find(free.begin(), free.end(), reg[arg]) == free.end())
+                    free.push_back(reg[arg]);
+
+            if (free.empty())
+                reg[order[k]] = next++;
+            else
+            {
+                reg[order[k]] = free.back();
+                free.pop_back();
+            }
+
+            program.code.push_back({node.op, reg[order[k]], reg[node.a], node.b != NONE ? reg[node.b] : reg[node.a]});
+        }
+
+        program.registers = next;
+
+        for (uint32_t n : outputs)
+            program.outputs.push_back(reg[n]);
+
+        return program;
+    }
+}
+
+void Program::Run(const double* x, double* out) const
+{
+    // Small programs keep registers on the stack, large ones in a buffer of the thread.
+    const size_t STACK = 64;
+    double stack[STACK];
+    thread_local std::vector<double> scratch;
+
+    if (registers > STACK)
+        scratch.resize(registers);
+
+    double* r = registers > STACK ? scratch.data() : stack;
+
+    std::copy(x, x + dim, r);
+    std::copy(constants.begin(), constants.end(), r + dim);
+
+    for (const Instruction& in : code)
+        r[in.dst] = Apply(in.op, r[in.a], r[in.b]);
+
+    for (size_t k{}; k < outputs.size(); ++k)
+        out[k] = r[outputs[k]];
+}
+
+void Program::RunBatch(std::span<const double* const> coords, size_t count, double* out) const
+{
+    if (coords.size() != dim)
+        throw std::invalid_argument("Dimension of the block is not equal dimension of the function.");
+
+    thread_local std::vector<double> scratch;
+    scratch.resize(registers * BLOCK);
+    double* r = scratch.data();
+
+    // Constants are broadcast once, only coordinates and temporaries change from block to block.
+    for (size_t c{}; c < constants.size(); ++c)
+        std::fill(r + (dim + c) * BLOCK, r + (dim + c + 1) * BLOCK, constants[c]);
+
+    for (size_t start{}; start < count; start += BLOCK)
+    {
+        const size_t n = std::min(BLOCK, count - start);
+
+        for (size_t j{}; j < dim; ++j)
+            std::copy(coords[j] + start, coords[j] + start + n, r + j * BLOCK);
+
+        for (const Instruction& in : code)
+            Execute(in.op, r + in.dst * BLOCK, r + in.a * BLOCK, r + in.b * BLOCK, n);
+
+        for (size_t k{}; k < outputs.size(); ++k)
+            std::copy(r + outputs[k] * BLOCK, r + outputs[k] * BLOCK + n, out + k * count + start);
+    }
+}
+
+Expression::Compiled Expression::Compile(const std::string& text, size_t dim)
+{
+    Graph graph;
+    std::vector<uint32_t> variables;
+    const uint32_t root = Parser(text, graph, variables).Parse();
+
+    if (!dim)
+        dim = variables.size();
+    else if (variables.size() > dim)
+        throw std::invalid_argument("Expression \"" + text + "\" has a variable out of dimension " + std::to_string(dim) + ".");
+
+    if (!dim)
+        throw std::invalid_argument("Expression \"" + text + "\" has no variables.");
+
+    const std::vector<uint32_t> gradient = Differentiate(graph, root, variables, dim);
+    std::vector<uint32_t> both(1, root);
+    both.insert(both.end(), gradient.begin(), gradient.end());
+
+    Compiled res;
+    res.dim = dim;
+    res.value = Generate(graph, {root}, dim);
+    res.gradient = Generate(graph, gradient, dim);
+    res.valueAndGradient = Generate(graph, both, dim);
+
+    return res;
+}
+
+ExpressionFunction::ExpressionFunction(const std::string& _text, size_t _dim) : text(_text), compiled(Expression::Compile(_text, _dim))
+{
+
+}
+
+void ExpressionFunction::CheckPoint(const Point<double>& p) const
+{
+    if (p.size() != compiled.dim)
+        throw std::invalid_argument("Size of point is not equal dimension.");
+}
+
+double ExpressionFunction::Value(const Point<double>& p) const
+{
+    CheckPoint(p);
+
+    double res;
+    compiled.value.Run(p.Data(), &res);
+
+    return res;
+}
+
+Point<double> ExpressionFunction::Gradient(const Point<double>& p) const
+{
+    CheckPoint(p);
+
+    Point<double> gradient;
+    gradient.Resize(compiled.dim);
+    compiled.gradient.Run(p.Data(), gradient.Data());
+
+    return gradient;
+}
+
+double ExpressionFunction::ValueAndGradient(const Point<double>& p, Point<double>& gradient) const
+{
+    CheckPoint(p);
+
+    thread_local std::vector<double> out;
+    out.resize(compiled.dim + 1);
+    compiled.valueAndGradient.Run(p.Data(), out.data());
+
+    gradient.Resize(compiled.dim);
+    std::copy(out.begin() + 1, out.end(), gradient.begin());
+
+    return out[0];
+}
+
+void ExpressionFunction::ValueBatch(std::span<const double* const> coords, std::span<double> values) const
+{
+    compiled.value.RunBatch(coords, values.size(), values.data());
+}
+
+void ExpressionFunction::GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const
+{
+    if (gradients.size() % compiled.dim)
+        throw std::invalid_argument("Size of gradients is not a multiple of dimension.");
+
+    compiled.gradient.RunBatch(coords, gradients.size() / compiled.dim, gradients.data());
+}
@@ -0,0 +1,102 @@
+/// @file
+/// @brief Compiler of mathematical expressions into functions.
+/// @details File contains the definition of a function given by a string, for example "3x^2+0.5y^2+2".
+/// The expression is parsed into a graph where equal subexpressions are one node (common subexpression elimination)
+/// and operations on constants are folded. The gradient is built symbolically on the same graph, so the value
+/// and the gradient share subexpressions. The graph is compiled into a bytecode for a machine with registers.
+/// A block of points is interpreted instruction by instruction over many points, so every instruction is a vectorized loop.
+///
+/// Grammar: operators + - * / ^ (** is a synonym of ^), unary minus, parentheses, implicit multiplication ("3x", "2(x+y)", "xy"),
+/// functions sin, cos, tan, exp, log (ln), sqrt, abs, constants pi and e. Variables are x, y, z, w or x1, x2, ..., xN.
+/// A leading backslash of a name is ignored, so strings in the LaTeX style ("\\sin(\\pi*x)") are accepted.
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "Optimization.h"
+
+namespace Expression
+{
+    /// @brief Operations of the bytecode.
+    enum class Op : uint8_t { Const, Var, Add, Sub, Mul, Div, Neg, Pow, Sin, Cos, Tan, Exp, Log, Sqrt, Abs, Sign };
+
+    /// @brief Instruction: dst = op(a, b).
+    struct Instruction
+    {
+        Op op;
+        uint32_t dst;
+        uint32_t a;
+        uint32_t b;
+    };
+
+    /// @brief Program for a machine with registers.
+    /// @details Registers [0, dim) are coordinates of a point, next registers are constants, the rest are temporaries.
+    /// Temporaries are reused after the last read.
+    struct Program
+    {
+        size_t dim = 0;
+        size_t registers = 0;
+        std::vector<double> constants;
+        std::vector<Instruction> code;
+        /// @brief Registers of results.
+        std::vector<uint32_t> outputs;
+
+        /// @brief Evaluates results in a point.
+        /// @param x Coordinates of a point.
+        /// @param out Results, one per output.
+        void Run(const double* x, double* out) const;
+
+        /// @brief Evaluates results in a block of points.
+        /// @param coords Arrays of coordinates, one array per dimension.
+        /// @param count Count of points.
+        /// @param out Results as a structure of arrays: out[k * count + i] is the k-th result in the i-th point.
+        void RunBatch(std::span<const double* const> coords, size_t count, double* out) const;
+    };
+
+    /// @brief Compiled expression: programs of the value, of the gradient and of the value with the gradient.
+    /// @details The gradient program has outputs g_0, ..., g_{dim-1}, the last program has outputs f, g_0, ..., g_{dim-1}.
+    struct Compiled
+    {
+        size_t dim = 0;
+        Program value;
+        Program gradient;
+        Program valueAndGradient;
+    };
+
+    /// @brief Parses and compiles an expression.
+    /// @param text Expression.
+    /// @param dim Dimension of the function. Zero means the largest index of a variable in the expression.
+    /// @return Compiled expression.
+    /// @throw std::invalid_argument If the expression has a syntax error or a variable out of the dimension.
+    Compiled Compile(const std::string& text, size_t dim = 0);
+}
+
+/// @brief Function given by an expression compiled at runtime.
+class ExpressionFunction : public GeneralFunction<double>
+{
+private:
+    std::string text;
+    Expression::Compiled compiled;
+
+    void CheckPoint(const Point<double>& p) const;
+public:
+    /// @brief Constructor of a function.
+    /// @param[in] _text Expression.
+    /// @param[in] _dim Dimension of the function. Zero means the largest index of a variable in the expression.
+    ExpressionFunction(const std::string& _text, size_t _dim = 0);
+
+    double Value(const Point<double>& p) const override;
+    Point<double> Gradient(const Point<double>& p) const override;
+    double ValueAndGradient(const Point<double>& p, Point<double>& gradient) const override;
+    void ValueBatch(std::span<const double* const> coords, std::span<double> values) const override;
+    void GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const override;
+
+    inline const std::string& getText() const { return text; }
+    inline size_t getDimension() const { return compiled.dim; }
+
+    /// @brief Count of instructions of the value and of the value with the gradient.
+    inline size_t getValueSize() const { return compiled.value.code.size(); }
+    inline size_t getGradientSize() const { return compiled.valueAndGradient.code.size(); }
+};
@@ -0,0 +1,206 @@
+/// @file
+/// @brief Realization of a gradient by finite differences.
+/// @details File contains the definition of a wrapper which computes the gradient of a function which provides only Value.
+/// Forward differences need N + 1 evaluations, central differences 2N, the complex step N evaluations
+/// of the function extended to complex points. Steps are chosen by the scale of every coordinate.
+/// Perturbed points are evaluated in parallel by a pool of threads or by one call of ValueBatch.
+/// In the parallel mode the wrapped function must be safe to evaluate from several threads.
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <vector>
+#include "Optimization.h"
+#include "ThreadPool.h"
+
+/// @brief Scheme of finite differences.
+enum class FiniteDifference { Forward, Central, ComplexStep };
+
+/// @brief Function with a gradient by finite differences.
+/// @tparam T Typename for a value of a function.
+template <typename T>
+class FiniteDifferenceFunction : public GeneralFunction<T>
+{
+private:
+    GeneralFunction<T>* f;
+    const GeneralFunction<std::complex<T>>* fComplex;
+    FiniteDifference scheme;
+    ThreadPool* pool;
+    bool batched;
+
+    /// @brief Step for a coordinate. The step is exactly representable: (x + h) - x == h.
+    T Step(const T& x) const;
+
+    /// @brief Derivatives by coordinates from first to last with one copy of a point.
+    void Range(const Point<T>& p, const T& value, size_t first, size_t last, Point<T>& gradient) const;
+
+    /// @brief All perturbed points are evaluated by one call of ValueBatch.
+    void Batch(const Point<T>& p, const T& value, Point<T>& gradient) const;
+public:
+    /// @brief Constructor of a function with forward or central differences.
+    /// @param[in] _f Function for evaluation.
+    /// @param[in] _scheme Scheme of differences: Forward or Central.
+    /// @param[in] _pool Pool of threads for perturbed points. Without a pool they are evaluated serially.
+    FiniteDifferenceFunction(GeneralFunction<T>& _f, FiniteDifference _scheme = FiniteDifference::Central, ThreadPool* _pool = nullptr);
+
+    /// @brief Constructor of a function with the complex step.
+    /// @param[in] _f Function for evaluation.
+    /// @param[in] _fComplex The same function for complex points. It must be analytic.
+    /// @param[in] _pool Pool of threads for perturbed points. Without a pool they are evaluated serially.
+    FiniteDifferenceFunction(GeneralFunction<T>& _f, const GeneralFunction<std::complex<T>>& _fComplex, ThreadPool* _pool = nullptr);
+
+    /// @brief Sets the batched mode: perturbed points are evaluated by one call of ValueBatch of the function.
+    /// It is not used with the complex step.
+    void SetBatched(bool _batched) { batched = _batched; }
+
+    T Value(const Point<T>& p) const override;
+    Point<T> Gradient(const Point<T>& p) const override;
+    T ValueAndGradient(const Point<T>& p, Point<T>& gradient) const override;
+    void ValueBatch(std::span<const T* const> coords, std::span<T> values) const override;
+};
+
+template <typename T>
+FiniteDifferenceFunction<T>::FiniteDifferenceFunction(GeneralFunction<T>& _f, FiniteDifference _scheme, ThreadPool* _pool)
+    : f(&_f), fComplex(nullptr), scheme(_scheme), pool(_pool), batched(false)
+{
+    if (scheme == FiniteDifference::ComplexStep)
+        throw std::invalid_argument("The complex step needs a function of complex points.");
+}
+
+template <typename T>
+FiniteDifferenceFunction<T>::FiniteDifferenceFunction(GeneralFunction<T>& _f, const GeneralFunction<std::complex<T>>& _fComplex, ThreadPool* _pool)
+    : f(&_f), fComplex(&_fComplex), scheme(FiniteDifference::ComplexStep), pool(_pool), batched(false)
+{
+
+}
+
+template <typename T>
+T FiniteDifferenceFunction<T>::Step(const T& x) const
+{
+    const T eps = std::numeric_limits<T>::epsilon();
+    const T scale = std::max(static_cast<T>(1), std::abs(x));
+
+    // Optimal steps balance truncation and rounding errors: sqrt(eps) for forward and cbrt(eps) for central differences.
+    // The complex step has no subtraction, so the step can be tiny.
+    if (scheme == FiniteDifference::ComplexStep)
+        return static_cast<T>(1e-20) * scale;
+
+    volatile T shifted = x + (scheme == FiniteDifference::Forward ? std::sqrt(eps) : std::cbrt(eps)) * scale;
+
+    return shifted - x;
+}
+
+template <typename T>
+void FiniteDifferenceFunction<T>::Range(const Point<T>& p, const T& value, size_t first, size_t last, Point<T>& gradient) const
+{
+    if (scheme == FiniteDifference::ComplexStep)
+    {
+        Point<std::complex<T>> z(std::vector<std::complex<T>>(p.begin(), p.end()));
+
+        for (size_t i = first; i < last; ++i)
+        {
+            const T h = Step(p[i]);
+
+            z[i] = std::complex<T>(p[i], h);
+            gradient[i] = fComplex->Value(z).imag() / h;
+            z[i] = p[i];
+        }
+
+        return;
+    }
+
+    Point<T> x = p;
+
+    for (size_t i = first; i < last; ++i)
+    {
+        const T h = Step(p[i]);
+
+        x[i] = p[i] + h;
+        const T right = f->Value(x);
+
+        if (scheme == FiniteDifference::Forward)
+            gradient[i] = (right - value) / h;
+        else
+        {
+            x[i] = p[i] - h;
+            gradient[i] = (right - f->Value(x)) / (2 * h);
+        }
+
+        x[i] = p[i];
+    }
+}
+
+template <typename T>
+void FiniteDifferenceFunction<T>::Batch(const Point<T>& p, const T& value, Point<T>& gradient) const
+{
+    // Column k of the block is the point shifted along coordinate k (and k - dim for the backward shifts).
+    const size_t dim = p.size(), count = scheme == FiniteDifference::Forward ? dim : 2 * dim;
+    std::vector<T> block(dim * count), values(count), steps(dim);
+    std::vector<const T*> coords(dim);
+
+    for (size_t j{}; j < dim; ++j)
+    {
+        T* row = block.data() + j * count;
+
+        std::fill(row, row + count, p[j]);
+        steps[j] = Step(p[j]);
+        row[j] += steps[j];
+
+        if (scheme == FiniteDifference::Central)
+            row[dim + j] -= steps[j];
+
+        coords[j] = row;
+    }
+
+    f->ValueBatch(coords, values);
+
+    for (size_t j{}; j < dim; ++j)
+        gradient[j] = scheme == FiniteDifference::Forward ? (values[j] - value) / steps[j]
+                                                          : (values[j] - values[dim + j]) / (2 * steps[j]);
+}
+
+template <typename T>
+T FiniteDifferenceFunction<T>::Value(const Point<T>& p) const
+{
+    return f->Value(p);
+}
+
+template <typename T>
+Point<T> FiniteDifferenceFunction<T>::Gradient(const Point<T>& p) const
+{
+    Point<T> gradient;
+    ValueAndGradient(p, gradient);
+
+    return gradient;
+}
+
+template <typename T>
+T FiniteDifferenceFunction<T>::ValueAndGradient(const Point<T>& p, Point<T>& gradient) const
+{
+    const T value = f->Value(p);
+    gradient.Resize(p.size());
+
+    if (batched && scheme != FiniteDifference::ComplexStep)
+        Batch(p, value, gradient);
+    else if (!pool || pool->getSize() == 1)
+        Range(p, value, 0, p.size(), gradient);
+    else
+    {
+        // Several chunks per thread balance the load, one copy of the point is made per chunk.
+        const size_t chunks = std::min(p.size(), 4 * pool->getSize()), chunk = (p.size() + chunks - 1) / chunks;
+
+        pool->ParallelFor(chunks, [this, &p, &value, &gradient, chunk](size_t i)
+        {
+            Range(p, value, i * chunk, std::min(p.size(), (i + 1) * chunk), gradient);
+        });
+    }
+
+    return value;
+}
+
+template <typename T>
+void FiniteDifferenceFunction<T>::ValueBatch(std::span<const T* const> coords, std::span<T> values) const
+{
+    f->ValueBatch(coords, values);
+}
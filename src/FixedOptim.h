@@ -0,0 +1,151 @@
+/// @file
+/// @brief Runtime dispatch of an optimization to a fixed-dimension instantiation.
+/// @details File contains functions which run an optimization method on points stored in std::array
+/// if the dimension of the start point is 2, 3 or 4 and the function implements FunctionN for this dimension.
+/// Otherwise the optimization is run on points stored in std::vector. The stopper of the caller sees points
+/// in std::vector in every instantiation, so callers choose stoppers without knowing the dimension.
+#pragma once
+
+#include <vector>
+#include "Optimization.h"
+#include "DiffStoper.h"
+
+/// @brief Converts a point to a point of a dimension known at compile time.
+/// @tparam N Dimension of a point.
+/// @tparam T Typename of a point's coordinate.
+/// @param p Point.
+/// @return Point with coordinates in std::array.
+template <size_t N, typename T>
+PointN<T, N> ToFixed(const Point<T>& p)
+{
+    if (p.size() != N)
+        throw std::invalid_argument("Size of point is not equal dimension.");
+
+    PointN<T, N> res;
+    std::copy(p.begin(), p.end(), res.begin());
+
+    return res;
+}
+
+/// @brief Converts a point of a dimension known at compile time to a point of a runtime dimension.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam N Dimension of a point.
+/// @param p Point.
+/// @return Point with coordinates in std::vector.
+template <typename T, size_t N>
+Point<T> ToDynamic(const PointN<T, N>& p)
+{
+    return Point<T>(std::vector<T>(p.begin(), p.end()));
+}
+
+/// @brief Result of an optimization in a dimension chosen at runtime.
+/// @tparam T Typename of a point's coordinate.
+template <typename T>
+struct RunResult
+{
+    Pathway<T> pathway;
+    RunSummary<T> summary;
+};
+
+/// @brief Stopper of points of a fixed dimension which calls a stopper of points of a runtime dimension.
+/// @details The state is passed as a view of the same coordinates, so nothing is copied.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam N Dimension of a point.
+template <typename T, size_t N>
+class DynamicStop : public GeneralStop<T, std::array<T, N>>
+{
+private:
+    GeneralStop<T>* stop;
+public:
+    /// @brief Constructor of the Dynamic Stopper.
+    /// @param _stop Stopper of points in std::vector.
+    explicit DynamicStop(GeneralStop<T>& _stop) : GeneralStop<T, std::array<T, N>>(NOSTEPLIMIT), stop(&_stop) {}
+
+    size_t getMaxStep() const override { return stop->getMaxStep(); }
+
+    void Reset() override { stop->Reset(); }
+
+    bool condition(const IterationState<T, std::array<T, N>>& state) override
+    {
+        return stop->condition({state.iteration, PointView<T>(state.point.Data(), N), state.value, state.gradientNorm, state.hasGradient,
+                                state.stepLength, state.elapsed, state.evaluations});
+    }
+};
+
+/// @brief Runs an optimization and collects its result.
+template <typename T, class Container>
+RunResult<T> Collect(Optimization<T, Container>& opt, size_t cache, const Point<T, Container>& minArea, const Point<T, Container>& maxArea,
+                     const Point<T, Container>& start)
+{
+    opt.SetCacheCapacity(cache);
+    opt.SetArea(minArea, maxArea);
+    opt.DoOptimize(start);
+
+    const PathwayView<T, Container> view = opt.getPathway();
+    RunResult<T> res;
+    res.pathway.Reserve(view.size(), view.dimension());
+
+    for (const auto p : view)
+        res.pathway.PushBack(p);
+
+    res.summary = opt.getSummary();
+
+    return res;
+}
+
+/// @brief Runs an optimization in a fixed dimension and converts the pathway.
+/// @tparam Method Template of an optimization method.
+/// @tparam N Dimension of a function.
+/// @param f Function for optimization.
+/// @param stop Stopper. It sees states of points in std::vector.
+/// @param area Area for optimization.
+/// @param start Start point of a pathway.
+/// @param cache Capacity of the cache of evaluations, 0 disables it.
+/// @param params Parameters of a method after the function and the stopper.
+/// @return Pathway and summary of the optimization.
+template <template <typename, class> class Method, size_t N, typename T, typename... Params>
+RunResult<T> OptimizeInDimension(FunctionN<T, N>& f, GeneralStop<T>& stop, const CubicArea<T>& area, const Point<T>& start, size_t cache,
+                                 const Params&... params)
+{
+    DynamicStop<T, N> fixedStop(stop);
+    Method<T, std::array<T, N>> opt(f, fixedStop, params...);
+
+    return Collect(opt, cache, ToFixed<N>(area.minArea), ToFixed<N>(area.maxArea), ToFixed<N>(start));
+}
+
+/// @brief Runs an optimization choosing the instantiation by dimension of the start point.
+/// @tparam Method Template of an optimization method (DetermOptimization, StochastOptimization or NewtonOptimization).
+/// @param f Function for optimization.
+/// @param stop Stopper. It sees states of points in std::vector in every dimension.
+/// @param area Area for optimization.
+/// @param start Start point of a pathway.
+/// @param cache Capacity of the cache of evaluations, 0 disables it.
+/// @param params Parameters of a method after the function and the stopper.
+/// @return Pathway and summary of the optimization.
+template <template <typename, class> class Method, typename T, typename... Params>
+RunResult<T> OptimizeFixed(GeneralFunction<T>& f, GeneralStop<T>& stop, const CubicArea<T>& area, const Point<T>& start, size_t cache,
+                           const Params&... params)
+{
+    switch (start.size())
+    {
+    case 2:
+        if (auto fixed = dynamic_cast<FunctionN<T, 2>*>(&f))
+            return OptimizeInDimension<Method, 2>(*fixed, stop, area, start, cache, params...);
+
+        break;
+    case 3:
+        if (auto fixed = dynamic_cast<FunctionN<T, 3>*>(&f))
+            return OptimizeInDimension<Method, 3>(*fixed, stop, area, start, cache, params...);
+
+        break;
+    case 4:
+        if (auto fixed = dynamic_cast<FunctionN<T, 4>*>(&f))
+            return OptimizeInDimension<Method, 4>(*fixed, stop, area, start, cache, params...);
+
+        break;
+    }
+
+    Method<T, std::vector<T>> opt(f, stop, params...);
+
+    return Collect(opt, cache, area.minArea, area.maxArea, start);
+}
@@ -0,0 +1,47 @@
+/// @file
+/// @brief Catalog of functions of the programs.
+/// @details File contains the definition of the list of functions which the GUI, the console program and the batch runner offer,
+/// with their areas and start points.
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "MathFunc.h"
+
+/// @brief Owner of the functions of the programs.
+class FunctionCatalog
+{
+private:
+    std::vector<std::unique_ptr<GeneralFunction<double>>> functions;
+    std::vector<FunctionData<double>> data;
+
+    GeneralFunction<double>& Add(std::unique_ptr<GeneralFunction<double>> function)
+    {
+        functions.push_back(std::move(function));
+
+        return *functions.back();
+    }
+public:
+    FunctionCatalog()
+    {
+        // Elements are not assignable because of the reference, so they are appended one by one.
+        data.push_back({"3x^2+0.5y^2+2", Add(std::make_unique<F_2D::FuncQuadratic1>()),
+                        Point<double>({-1, -1}), Point<double>({1, 1}), Point<double>({0.5, 0.5})});
+        data.push_back({"Rosenbrock", Add(std::make_unique<F_2D::FuncRosenbrock>()),
+                        Point<double>({-1, -0.1}), Point<double>({1.1, 1.1}), Point<double>({-0.5, 0.5})});
+        data.push_back({"\\sin(\\pi*sin(x)+\\pi*\\sin(y))", Add(std::make_unique<F_2D::FuncSinSin>()),
+                        Point<double>({0, 0}), Point<double>({5, 5}), Point<double>({0.5, 0.5})});
+        data.push_back({"Himmelblau", Add(std::make_unique<F_2D::FuncHimmelblau>()),
+                        Point<double>({-5, -5}), Point<double>({5, 5}), Point<double>({0, 0})});
+        data.push_back({"3x^2+0.5y^2+z^2+0.3xy+z+4y+2", Add(std::make_unique<F_3D::FuncQuadratic1>()),
+                        Point<double>({-4, -4, -4}), Point<double>({1, 1, 1}), Point<double>({0.5, 0.5, 0.5})});
+        data.push_back({"(1-x)^2+(x-y)^2+(y-z)^2+(z-w)^2", Add(std::make_unique<F_4D::FuncQuadratic1>()),
+                        Point<double>({0, 0, 0, 0}), Point<double>({2, 2, 2, 2}), Point<double>({0.5, 0.5, 0.5, 0.5})});
+    }
+
+    FunctionCatalog(const FunctionCatalog&) = delete;
+    FunctionCatalog& operator=(const FunctionCatalog&) = delete;
+
+    /// @brief Functions. The reference is valid while the catalog lives.
+    inline std::vector<FunctionData<double>>& getFunctions() { return data; }
+};
@@ -0,0 +1,138 @@
+/// @file
+/// @brief Abstract class for functions.
+/// @details File contains the definition of the abstract class of functions which optimization methods minimize,
+/// with default realizations of evaluations in blocks of points and of the Hessian-vector product.
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "Point.h"
+
+/// @brief Abstract class for function.
+/// @tparam T Typename for a value of a function.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class GeneralFunction
+{
+public:
+    /// @brief Default constructor.
+    GeneralFunction() = default;
+
+    /// @brief Function culculated a value of function.
+    /// @param[in] _ Point of a argument of a function.
+    /// @return Value of a function.
+    virtual T Value(const Point<T, Container>&) const = 0;
+    virtual Point<T, Container> Gradient(const Point<T, Container>&) const = 0;
+
+    /// @brief Function culculated a value and a gradient of function in one pass.
+    /// @details By default it calls Gradient and Value. Override it if they have common subexpressions.
+    /// @param[in] p Point of a argument of a function.
+    /// @param[out] gradient Gradient of a function. Its storage is reused if the dimension is not changed.
+    /// @return Value of a function.
+    virtual T ValueAndGradient(const Point<T, Container>& p, Point<T, Container>& gradient) const
+    {
+        gradient = Gradient(p);
+
+        return Value(p);
+    }
+
+    /// @brief Function culculated values of function in a block of points.
+    /// @details The block is a structure of arrays: coords[j][i] is the j-th coordinate of the i-th point.
+    /// By default it calls Value for every point. Override it to evaluate the block in vectorized loops.
+    /// @param[in] coords Arrays of coordinates, one array per dimension.
+    /// @param[out] values Values of function. Its size is the count of points.
+    virtual void ValueBatch(std::span<const T* const> coords, std::span<T> values) const;
+
+    /// @brief Function culculated gradients of function in a block of points.
+    /// @details Gradients are stored as a structure of arrays: gradients[j * count + i] is the j-th coordinate
+    /// of the gradient in the i-th point. By default it calls Gradient for every point.
+    /// @param[in] coords Arrays of coordinates, one array per dimension.
+    /// @param[out] gradients Gradients of function. Its size is the dimension multiplied by the count of points.
+    virtual void GradientBatch(std::span<const T* const> coords, std::span<T> gradients) const;
+
+    /// @brief Function culculated a product of the Hessian of function and a vector.
+    /// @details By default it is the central difference of gradients along the vector, it costs two gradients.
+    /// Override it with an analytic product or with automatic differentiation.
+    /// @param[in] p Point of a argument of a function.
+    /// @param[in] v Vector.
+    /// @param[out] result Product H(p) v. Its storage is reused if the dimension is not changed.
+    virtual void HessianVectorProduct(const Point<T, Container>& p, const Point<T, Container>& v, Point<T, Container>& result) const;
+
+    /// @brief Virtual destructor.
+    virtual ~GeneralFunction() {}
+};
+
+template <typename T, class Container>
+void GeneralFunction<T, Container>::ValueBatch(std::span<const T* const> coords, std::span<T> values) const
+{
+    Point<T, Container> p;
+    p.Resize(coords.size());
+
+    for (size_t i{}; i < values.size(); ++i)
+    {
+        for (size_t j{}; j < coords.size(); ++j)
+            p[j] = coords[j][i];
+
+        values[i] = Value(p);
+    }
+}
+
+template <typename T, class Container>
+void GeneralFunction<T, Container>::GradientBatch(std::span<const T* const> coords, std::span<T> gradients) const
+{
+    if (coords.empty() || gradients.size() % coords.size())
+        throw std::invalid_argument("Size of gradients is not a multiple of dimension.");
+
+    const size_t count = gradients.size() / coords.size();
+    Point<T, Container> p, gradient;
+    p.Resize(coords.size());
+
+    for (size_t i{}; i < count; ++i)
+    {
+        for (size_t j{}; j < coords.size(); ++j)
+            p[j] = coords[j][i];
+
+        gradient = Gradient(p);
+
+        for (size_t j{}; j < coords.size(); ++j)
+            gradients[j * count + i] = gradient[j];
+    }
+}
+
+template <typename T, class Container>
+void GeneralFunction<T, Container>::HessianVectorProduct(const Point<T, Container>& p, const Point<T, Container>& v, Point<T, Container>& result) const
+{
+    if (p.size() != v.size())
+        throw std::invalid_argument("Size of the vector is not equal size of the point.");
+
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        const T norm = std::sqrt(v * v);
+
+        if (!norm)
+        {
+            result = v;
+
+            return;
+        }
+
+        // The step balances truncation and rounding errors of central differences and is relative to the point.
+        const T h = std::cbrt(std::numeric_limits<T>::epsilon()) * std::max(static_cast<T>(1), std::sqrt(p * p)) / norm;
+        const Point<T, Container> right = Gradient(p + h * v), left = Gradient(p + (-h) * v);
+
+        result = (static_cast<T>(0.5) / h) * (right + (-left));
+    }
+    else
+        throw std::invalid_argument("Hessian-vector product by differences needs a floating point type.");
+}
+
+/// @brief Function of a dimension known at compile time.
+/// @tparam T Typename for a value of a function.
+/// @tparam N Dimension of a function.
+template <typename T, size_t N>
+using FunctionN = GeneralFunction<T, std::array<T, N>>;
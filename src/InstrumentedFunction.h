@@ -0,0 +1,307 @@
+/// @file
+/// @brief Realization of a function with counters of calls.
+/// @details File contains the definition of a wrapper which counts calls of a function and measures their latency.
+/// Every call is counted, but only every n-th call of a kind is timed, because reading the clock costs more
+/// than an evaluation of a cheap function. Totals of latencies are extrapolated from the timed calls.
+/// Latencies are stored in a log-linear histogram: every power of two is split into equal sub-buckets,
+/// so the relative error of a percentile is bounded and recording is one increment without allocation.
+/// Counters are atomic, so one wrapper can be shared by several threads.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "GeneralFunction.h"
+
+/// @brief Histogram of latencies in nanoseconds with log-linear buckets.
+class LatencyHistogram
+{
+private:
+    /// @brief Every power of two is split into 2^SUBBITS buckets, the relative error is below 1/2^SUBBITS.
+    static constexpr unsigned SUBBITS = 3;
+    static constexpr unsigned MAXBITS = 40;
+    static constexpr size_t COUNT = (MAXBITS - SUBBITS + 1) << SUBBITS;
+
+    std::array<std::atomic<uint64_t>, COUNT> buckets;
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> total;
+
+    static size_t Bucket(uint64_t ns)
+    {
+        ns = std::min(ns, (uint64_t{1} << MAXBITS) - 1);
+        const unsigned width = std::bit_width(ns);
+
+        if (width <= SUBBITS)
+            return static_cast<size_t>(ns);
+
+        // The leading bit is dropped, the next SUBBITS bits select the sub-bucket.
+        const unsigned shift = width - SUBBITS - 1;
+        return (static_cast<size_t>(shift + 1) << SUBBITS) | static_cast<size_t>((ns >> shift) & ((1u << SUBBITS) - 1));
+    }
+
+    /// @brief Middle of a bucket.
+    static double Middle(size_t bucket)
+    {
+        if (bucket < (size_t{1} << SUBBITS))
+            return static_cast<double>(bucket);
+
+        const unsigned shift = static_cast<unsigned>(bucket >> SUBBITS) - 1;
+        const uint64_t low = ((uint64_t{1} << SUBBITS) | (bucket & ((1u << SUBBITS) - 1))) << shift;
+
+        return static_cast<double>(low) + static_cast<double>(uint64_t{1} << shift) / 2;
+    }
+public:
+    LatencyHistogram() { Reset(); }
+
+    void Record(uint64_t ns)
+    {
+        buckets[Bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(ns, std::memory_order_relaxed);
+    }
+
+    void Reset()
+    {
+        for (auto& bucket : buckets)
+            bucket.store(0, std::memory_order_relaxed);
+
+        count.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+    }
+
+    inline uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+    inline uint64_t getTotal() const { return total.load(std::memory_order_relaxed); }
+
+    /// @brief Percentile of latencies.
+    /// @param q Level of a percentile from 0 to 1.
+    /// @return Latency in nanoseconds or zero if nothing is recorded.
+    double Percentile(double q) const
+    {
+        if (q < 0 || q > 1)
+            throw std::invalid_argument("Level of percentile must be from 0 to 1.");
+
+        const uint64_t n = getCount();
+
+        if (!n)
+            return 0;
+
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(n))));
+        uint64_t sum{};
+
+        for (size_t i{}; i < COUNT; ++i)
+            if ((sum += buckets[i].load(std::memory_order_relaxed)) >= rank)
+                return Middle(i);
+
+        return Middle(COUNT - 1);
+    }
+};
+
+/// @brief Kinds of calls of a function.
+enum class FunctionCall { Value, Gradient, ValueAndGradient, ValueBatch, GradientBatch, HessianVector };
+
+inline const char* FunctionCallName(FunctionCall kind)
+{
+    static const char* names[] = {"Value", "Gradient", "Value and gradient", "Value batch", "Gradient batch", "Hessian-vector"};
+
+    return names[static_cast<size_t>(kind)];
+}
+
+/// @brief Statistics of one kind of calls.
+struct CallStats
+{
+    /// @brief Count of calls.
+    size_t calls = 0;
+    /// @brief Count of evaluated points. It is larger than the count of calls for blocks of points.
+    size_t points = 0;
+    /// @brief Total latency in nanoseconds.
+    double total = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+};
+
+/// @brief Period of timed calls of the optimization methods: one call of every kind in SAMPLINGPERIOD is timed.
+static const size_t SAMPLINGPERIOD = 64;
+
+/// @brief Function with counters of calls and histograms of latencies.
+/// @tparam T Typename for a value of a function.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class InstrumentedFunction : public GeneralFunction<T, Container>
+{
+private:
+    static constexpr size_t KINDS = 6;
+
+    GeneralFunction<T, Container>* f;
+    // Evaluations are const, so counters are mutable.
+    mutable std::array<LatencyHistogram, KINDS> histograms;
+    mutable std::array<std::atomic<size_t>, KINDS> calls;
+    /// @brief Points of blocks. Other kinds evaluate one point per call, so their points are their calls.
+    mutable std::array<std::atomic<size_t>, KINDS> points;
+    mutable std::atomic<size_t> dim;
+    size_t sampling;
+
+    static bool IsBlock(FunctionCall kind) { return kind == FunctionCall::ValueBatch || kind == FunctionCall::GradientBatch; }
+
+    /// @brief Measures a call of a function and records it.
+    template <class Call>
+    auto Measure(FunctionCall kind, size_t count, size_t _dim, Call call) const;
+public:
+    /// @brief Constructor of a function with counters.
+    /// @param[in] _f Function for evaluation.
+    /// @param[in] _sampling Period of timed calls: 1 times every call, 0 only counts calls.
+    InstrumentedFunction(GeneralFunction<T, Container>& _f, size_t _sampling = 1) : f(&_f), sampling(_sampling) { Reset(); }
+
+    void SetParam(GeneralFunction<T, Container>& _f)
+    {
+        f = &_f;
+        Reset();
+    }
+
+    /// @brief Sets the period of timed calls: 1 times every call, 0 only counts calls.
+    inline void SetSampling(size_t _sampling) { sampling = _sampling; }
+    inline size_t getSampling() const { return sampling; }
+
+    /// @brief Sets all counters to zero.
+    void Reset();
+
+    /// @brief Counts calls of one point which did not pass through the wrapper, for example calls of static formulas.
+    /// They are not timed.
+    /// @param[in] kind Kind of calls. It is not a kind of blocks.
+    /// @param[in] count Count of calls.
+    void AddCalls(FunctionCall kind, size_t count) const { calls[static_cast<size_t>(kind)].fetch_add(count, std::memory_order_relaxed); }
+
+    T Value(const Point<T, Container>& p) const override;
+    Point<T, Container> Gradient(const Point<T, Container>& p) const override;
+    T ValueAndGradient(const Point<T, Container>& p, Point<T, Container>& gradient) const override;
+    void ValueBatch(std::span<const T* const> coords, std::span<T> values) const override;
+    void GradientBatch(std::span<const T* const> coords, std::span<T> gradients) const override;
+    void HessianVectorProduct(const Point<T, Container>& p, const Point<T, Container>& v, Point<T, Container>& result) const override;
+
+    inline GeneralFunction<T, Container>& getFunction() const { return *f; }
+
+    /// @brief Dimension of the last timed point.
+    inline size_t getDimension() const { return dim.load(std::memory_order_relaxed); }
+
+    CallStats getStats(FunctionCall kind) const;
+
+    /// @brief Count of evaluated points by all kinds of calls.
+    size_t getEvaluations() const;
+
+    /// @brief Total latency of all calls in nanoseconds.
+    double getTotal() const;
+};
+
+template <typename T, class Container>
+void InstrumentedFunction<T, Container>::Reset()
+{
+    for (size_t i{}; i < KINDS; ++i)
+    {
+        histograms[i].Reset();
+        calls[i].store(0, std::memory_order_relaxed);
+        points[i].store(0, std::memory_order_relaxed);
+    }
+
+    dim.store(0, std::memory_order_relaxed);
+}
+
+template <typename T, class Container>
+template <class Call>
+auto InstrumentedFunction<T, Container>::Measure(FunctionCall kind, size_t count, size_t _dim, Call call) const
+{
+    const size_t i = static_cast<size_t>(kind);
+    const size_t number = calls[i].fetch_add(1, std::memory_order_relaxed);
+
+    if (IsBlock(kind))
+        points[i].fetch_add(count, std::memory_order_relaxed);
+
+    if (!sampling || number % sampling)
+        return call();
+
+    const auto start = std::chrono::steady_clock::now();
+    auto res = call();
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    histograms[i].Record(static_cast<uint64_t>(ns));
+    dim.store(_dim, std::memory_order_relaxed);
+
+    return res;
+}
+
+template <typename T, class Container>
+T InstrumentedFunction<T, Container>::Value(const Point<T, Container>& p) const
+{
+    return Measure(FunctionCall::Value, 1, p.size(), [&] { return f->Value(p); });
+}
+
+template <typename T, class Container>
+Point<T, Container> InstrumentedFunction<T, Container>::Gradient(const Point<T, Container>& p) const
+{
+    return Measure(FunctionCall::Gradient, 1, p.size(), [&] { return f->Gradient(p); });
+}
+
+template <typename T, class Container>
+T InstrumentedFunction<T, Container>::ValueAndGradient(const Point<T, Container>& p, Point<T, Container>& gradient) const
+{
+    return Measure(FunctionCall::ValueAndGradient, 1, p.size(), [&] { return f->ValueAndGradient(p, gradient); });
+}
+
+template <typename T, class Container>
+void InstrumentedFunction<T, Container>::ValueBatch(std::span<const T* const> coords, std::span<T> values) const
+{
+    Measure(FunctionCall::ValueBatch, values.size(), coords.size(), [&] { f->ValueBatch(coords, values); return 0; });
+}
+
+template <typename T, class Container>
+void InstrumentedFunction<T, Container>::GradientBatch(std::span<const T* const> coords, std::span<T> gradients) const
+{
+    const size_t count = coords.empty() ? 0 : gradients.size() / coords.size();
+
+    Measure(FunctionCall::GradientBatch, count, coords.size(), [&] { f->GradientBatch(coords, gradients); return 0; });
+}
+
+template <typename T, class Container>
+void InstrumentedFunction<T, Container>::HessianVectorProduct(const Point<T, Container>& p, const Point<T, Container>& v,
+                                                             Point<T, Container>& result) const
+{
+    Measure(FunctionCall::HessianVector, 1, p.size(), [&] { f->HessianVectorProduct(p, v, result); return 0; });
+}
+
+template <typename T, class Container>
+CallStats InstrumentedFunction<T, Container>::getStats(FunctionCall kind) const
+{
+    const size_t i = static_cast<size_t>(kind);
+    const LatencyHistogram& h = histograms[i];
+    const size_t count = calls[i].load(std::memory_order_relaxed);
+    // The total of timed calls is scaled to all calls.
+    const double total = h.getCount() ? static_cast<double>(h.getTotal()) * static_cast<double>(count) / static_cast<double>(h.getCount()) : 0;
+
+    return {count, IsBlock(kind) ? points[i].load(std::memory_order_relaxed) : count, total, h.Percentile(0.5), h.Percentile(0.9), h.Percentile(0.99)};
+}
+
+template <typename T, class Container>
+size_t InstrumentedFunction<T, Container>::getEvaluations() const
+{
+    size_t res{};
+
+    for (size_t i{}; i < KINDS; ++i)
+        res += (IsBlock(static_cast<FunctionCall>(i)) ? points[i] : calls[i]).load(std::memory_order_relaxed);
+
+    return res;
+}
+
+template <typename T, class Container>
+double InstrumentedFunction<T, Container>::getTotal() const
+{
+    double res{};
+
+    for (size_t i{}; i < KINDS; ++i)
+        res += getStats(static_cast<FunctionCall>(i)).total;
+
+    return res;
+}
@@ -0,0 +1,269 @@
+/// @file
+/// @brief Local searches of a step along a line.
+/// @details File contains searches of the minimum of phi(alpha) = f(p + alpha * d) on [0, maxStep], where d is a descent direction.
+/// They find a local minimum near the initial step in a few probes, unlike the scan of the whole segment:
+/// - bracketing with Brent's method: the bracket is expanded from the initial step, then the minimum is refined
+///   by parabolic interpolation with golden-section steps. It uses values only;
+/// - strong Wolfe: the step with sufficient decrease and small derivative is found by extrapolation and cubic zoom.
+///   It uses derivatives, so every probe evaluates the gradient;
+/// - backtracking Armijo: the initial step is reduced by safeguarded quadratic interpolation until the decrease is sufficient.
+///   It uses values only.
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/// @brief Search of a step along a line.
+/// @details Scan is the global search of the whole segment by golden sections in every slice of epsilonStep.
+enum class LineSearchMode { Scan, Brent, StrongWolfe, Armijo };
+
+/// @brief Result of a line search.
+template <typename T>
+struct LineStep
+{
+    T alpha;
+    T value;
+    /// @brief The step is the last probe, so the gradient of that probe belongs to it.
+    bool last = false;
+};
+
+/// @brief Bracketing and Brent's method.
+/// @param phi Function of a step.
+/// @param value0 Value at zero.
+/// @param initial Initial step.
+/// @param maxStep Right border.
+/// @param tolerance Width of the final interval.
+/// @param maxProbes Maximum count of probes of Brent's method.
+/// @return Step of minimum. The step is zero if the search did not decrease the value.
+template <typename T, class OneF>
+LineStep<T> BrentSearch(const OneF& phi, const T& value0, const T& initial, const T& maxStep, const T& tolerance, size_t maxProbes = 100)
+{
+    // 2 - PHI, the golden section of the larger part.
+    constexpr T GOLD = static_cast<T>(0.3819660113);
+
+    if (maxStep <= 0)
+        return {T{}, value0};
+
+    T lo{}, mid = std::min(initial, maxStep), fMid = phi(mid), hi;
+
+    if (fMid >= value0)
+    {
+        // The minimum is inside the first step.
+        hi = mid;
+        mid = GOLD * hi, fMid = phi(mid);
+    }
+    else
+        for (;;)
+        {
+            if (mid >= maxStep)
+                return {mid, fMid};
+
+            hi = std::min(maxStep, mid + (1 / GOLD - 1) * (mid - lo));
+
+            const T fHi = phi(hi);
+
+            if (fHi >= fMid)
+                break;
+
+            lo = mid;
+            mid = hi, fMid = fHi;
+        }
+
+    T x = mid, w = mid, v = mid, fx = fMid, fw = fMid, fv = fMid, d{}, e{};
+
+    for (size_t i{}; i < maxProbes; ++i)
+    {
+        const T middle = (lo + hi) / 2;
+        const T tol1 = tolerance / 2 + std::numeric_limits<T>::epsilon() * std::abs(x), tol2 = 2 * tol1;
+
+        if (std::abs(x - middle) <= tol2 - (hi - lo) / 2)
+            break;
+
+        bool golden = true;
+
+        if (std::abs(e) > tol1)
+        {
+            // Parabola through x, w and v.
+            const T r = (x - w) * (fx - fv);
+            T q = (x - v) * (fx - fw), p = (x - v) * q - (x - w) * r;
+
+            q = 2 * (q - r);
+
+            if (q > 0)
+                p = -p;
+
+            q = std::abs(q);
+
+            const T eOld = e;
+            e = d;
+
+            if (std::abs(p) < std::abs(q * eOld / 2) && p > q * (lo - x) && p < q * (hi - x))
+            {
+                d = p / q;
+                golden = false;
+
+                if (x + d - lo < tol2 || hi - x - d < tol2)
+                    d = std::copysign(tol1, middle - x);
+            }
+        }
+
+        if (golden)
+        {
+            e = (x >= middle ? lo : hi) - x;
+            d = GOLD * e;
+        }
+
+        const T u = std::abs(d) >= tol1 ? x + d : x + std::copysign(tol1, d), fu = phi(u);
+
+        if (fu <= fx)
+        {
+            (u >= x ? lo : hi) = x;
+            v = w, fv = fw;
+            w = x, fw = fx;
+            x = u, fx = fu;
+        }
+        else
+        {
+            (u < x ? lo : hi) = u;
+
+            if (fu <= fw || w == x)
+            {
+                v = w, fv = fw;
+                w = u, fw = fu;
+            }
+            else if (fu <= fv || v == x || v == w)
+                v = u, fv = fu;
+        }
+    }
+
+    if (fx >= value0)
+        return {T{}, value0};
+
+    return {x, fx};
+}
+
+/// @brief Search of a step with the strong Wolfe conditions.
+/// @param phi Function of a step: T phi(alpha, derivative).
+/// @param value0 Value at zero.
+/// @param slope0 Derivative at zero. It must be negative.
+/// @param initial Initial step.
+/// @param maxStep Right border.
+/// @param tolerance Width of an interval of the zoom, which stops the search.
+/// @param c1 Coefficient of sufficient decrease.
+/// @param c2 Coefficient of curvature. The Conjugate Vector Method needs c2 < 1/2.
+/// @param maxProbes Maximum count of probes.
+/// @return Step. The step is zero if the search did not decrease the value.
+template <typename T, class OneDF>
+LineStep<T> StrongWolfeSearch(const OneDF& phi, const T& value0, const T& slope0, const T& initial, const T& maxStep, const T& tolerance,
+                              const T& c1 = static_cast<T>(1e-4), const T& c2 = static_cast<T>(0.1), size_t maxProbes = 50)
+{
+    struct Probe
+    {
+        T alpha, value, slope;
+    };
+
+    if (maxStep <= 0 || slope0 >= 0)
+        return {T{}, value0};
+
+    const auto sufficient = [&](const Probe& probe) { return probe.value <= value0 + c1 * probe.alpha * slope0; };
+    const auto curvature = [&](const Probe& probe) { return std::abs(probe.slope) <= -c2 * slope0; };
+
+    // Zoom in the interval between lo, which has sufficient decrease, and hi.
+    const auto zoom = [&](Probe lo, Probe hi, size_t probes) -> LineStep<T>
+    {
+        for (; probes < maxProbes && std::abs(hi.alpha - lo.alpha) > tolerance; ++probes)
+        {
+            // Minimum of the cubic with values and derivatives at both ends, the midpoint if it is close to an end.
+            const T d1 = lo.slope + hi.slope - 3 * (lo.value - hi.value) / (lo.alpha - hi.alpha);
+            const T square = d1 * d1 - lo.slope * hi.slope;
+            const T left = std::min(lo.alpha, hi.alpha), width = std::abs(hi.alpha - lo.alpha);
+            T alpha = (lo.alpha + hi.alpha) / 2;
+
+            if (square >= 0)
+            {
+                const T d2 = std::copysign(std::sqrt(square), hi.alpha - lo.alpha);
+                const T cubic = hi.alpha - (hi.alpha - lo.alpha) * (hi.slope + d2 - d1) / (hi.slope - lo.slope + 2 * d2);
+
+                if (cubic >= left + width / 10 && cubic <= left + width * 9 / 10)
+                    alpha = cubic;
+            }
+
+            Probe probe{alpha, T{}, T{}};
+            probe.value = phi(alpha, probe.slope);
+
+            if (!sufficient(probe) || probe.value >= lo.value)
+                hi = probe;
+            else
+            {
+                if (curvature(probe))
+                    return {probe.alpha, probe.value, true};
+
+                if (probe.slope * (hi.alpha - lo.alpha) >= 0)
+                    hi = lo;
+
+                lo = probe;
+            }
+        }
+
+        return {lo.alpha, lo.value};
+    };
+
+    Probe previous{T{}, value0, slope0};
+    T alpha = std::min(initial, maxStep);
+
+    for (size_t probes{}; probes < maxProbes; ++probes)
+    {
+        Probe probe{alpha, T{}, T{}};
+        probe.value = phi(alpha, probe.slope);
+
+        if (!sufficient(probe) || (probes && probe.value >= previous.value))
+            return zoom(previous, probe, probes + 1);
+
+        if (curvature(probe))
+            return {probe.alpha, probe.value, true};
+
+        if (probe.slope >= 0)
+            return zoom(probe, previous, probes + 1);
+
+        if (alpha >= maxStep)
+            return {probe.alpha, probe.value, true};
+
+        previous = probe;
+        alpha = std::min(maxStep, 2 * alpha);
+    }
+
+    return {previous.alpha, previous.value};
+}
+
+/// @brief Backtracking search with the Armijo condition.
+/// @param phi Function of a step.
+/// @param value0 Value at zero.
+/// @param slope0 Derivative at zero. It must be negative.
+/// @param initial Initial step.
+/// @param maxStep Right border.
+/// @param tolerance Minimum step.
+/// @param c1 Coefficient of sufficient decrease.
+/// @return Step. The step is zero if no step is longer than the tolerance.
+template <typename T, class OneF>
+LineStep<T> ArmijoSearch(const OneF& phi, const T& value0, const T& slope0, const T& initial, const T& maxStep, const T& tolerance,
+                         const T& c1 = static_cast<T>(1e-4))
+{
+    if (maxStep <= 0 || slope0 >= 0)
+        return {T{}, value0};
+
+    for (T alpha = std::min(initial, maxStep); alpha > tolerance;)
+    {
+        const T value = phi(alpha);
+
+        if (value <= value0 + c1 * alpha * slope0)
+            return {alpha, value};
+
+        // Minimum of the parabola with the value and the derivative at zero and the value at alpha.
+        const T quadratic = -slope0 * alpha * alpha / (2 * (value - value0 - slope0 * alpha));
+
+        alpha = std::isfinite(quadratic) ? std::clamp(quadratic, alpha / 10, alpha / 2) : alpha / 2;
+    }
+
+    return {T{}, value0};
+}
@@ -1,75 +1,548 @@
+#include <algorithm>
 #include <cmath>
 #include "MathFunc.h"
+#include "PointKernels.h"
 
-double F_2D::FuncNull::Value(const Point<double>&) const
+namespace
 {
-    return 0; 
+    /// @brief Checks that a block of points has the dimension of a function.
+    void CheckBlock(std::span<const double* const> coords, size_t dim)
+    {
+        if (coords.size() != dim)
+            throw std::invalid_argument("Dimension of the block is not equal dimension of the function.");
+    }
+
+    /// @brief Checks a block of points and its gradients.
+    /// @return Count of points.
+    size_t GradientBlockCount(std::span<const double* const> coords, std::span<double> gradients, size_t dim)
+    {
+        CheckBlock(coords, dim);
+
+        if (gradients.size() % dim)
+            throw std::invalid_argument("Size of gradients is not a multiple of dimension.");
+
+        return gradients.size() / dim;
+    }
+
+    // Loops of the built-in functions over a block of points. Gradients are written as a structure of arrays.
+
+    VECTORIZED void RosenbrockValues(std::span<const double* const> coords, double* v, size_t count)
+    {
+        const double* x = coords[0];
+        const double* y = coords[1];
+
+        for (size_t i{}; i < count; ++i)
+        {
+            const double a = 1 - x[i], b = y[i] - x[i] * x[i];
+
+            v[i] = a * a + b * b;
+        }
+    }
+
+    VECTORIZED void RosenbrockGradients(std::span<const double* const> coords, double* gx, size_t count)
+    {
+        const double* x = coords[0];
+        const double* y = coords[1];
+        double* gy = gx + count;
+
+        for (size_t i{}; i < count; ++i)
+        {
+            const double b = y[i] - x[i] * x[i];
+
+            gx[i] = -2 * (1 - x[i]) - 4 * x[i] * b;
+            gy[i] = 2 * b;
+        }
+    }
+
+    VECTORIZED void Quadratic2DValues(std::span<const double* const> coords, double* v, size_t count)
+    {
+        const double* x = coords[0];
+        const double* y = coords[1];
+
+        for (size_t i{}; i < count; ++i)
+            v[i] = 3 * x[i] * x[i] + 0.5 * y[i] * y[i] + 2;
+    }
+
+    VECTORIZED void Quadratic2DGradients(std::span<const double* const> coords, double* gx, size_t count)
+    {
+        const double* x = coords[0];
+        const double* y = coords[1];
+        double* gy = gx + count;
+
+        for (size_t i{}; i < count; ++i)
+        {
+            gx[i] = 6 * x[i];
+            gy[i] = y[i];
+        }
+    }
+
+    VECTORIZED void SinSinValues(std::span<const double* const> coords, double* v, size_t count)
+    {
+        const double* x = coords[0];
+        const double* y = coords[1];
+
+        for (size_t i{}; i < count; ++i)
+            v[i] = std::sin(M_PI * std::sin(x[i]) + M_PI * std::sin(y[i]));
+    }
+
+    VECTORIZED void SinSinGradients(std::span<const double* const> coords, double* gx, size_t count)
+    {
+        const double* x = coords[0];
+        const double* y = coords[1];
+        double* gy = gx + count;
+
+        for (size_t i{}; i < count; ++i)
+        {
+            const double outer = std::cos(M_PI * std::sin(x[i]) + M_PI * std::sin(y[i])) * M_PI;
+
+            gx[i] = outer * std::cos(x[i]);
+            gy[i] = outer * std::cos(y[i]);
+        }
+    }
+
+    VECTORIZED void HimmelblauValues(std::span<const double* const> coords, double* v, size_t count)
+    {
+        const double* x = coords[0];
+        const double* y = coords[1];
+
+        for (size_t i{}; i < count; ++i)
+        {
+            const double a = x[i] * x[i] + y[i] - 11, b = x[i] + y[i] * y[i] - 7;
+
+            v[i] = a * a + b * b;
+        }
+    }
+
+    VECTORIZED void HimmelblauGradients(std::span<const double* const> coords, double* gx, size_t count)
+    {
+        const double* x = coords[0];
+        const double* y = coords[1];
+        double* gy = gx + count;
+
+        for (size_t i{}; i < count; ++i)
+        {
+            const double a = x[i] * x[i] + y[i] - 11, b = x[i] + y[i] * y[i] - 7;
+
+            gx[i] = 4 * x[i] * a + 2 * b;
+            gy[i] = 2 * a + 4 * y[i] * b;
+        }
+    }
+
+    VECTORIZED void Quadratic3DValues(std::span<const double* const> coords, double* v, size_t count)
+    {
+        const double* x = coords[0];
+        const double* y = coords[1];
+        const double* z = coords[2];
+
+        for (size_t i{}; i < count; ++i)
+            v[i] = 3 * x[i] * x[i] + 0.5 * y[i] * y[i] + z[i] * z[i] + 0.3 * x[i] * y[i] + z[i] + 3 * y[i] + 2;
+    }
+
+    VECTORIZED void Quadratic3DGradients(std::span<const double* const> coords, double* gx, size_t count)
+    {
+        const double* x = coords[0];
+        const double* y = coords[1];
+        const double* z = coords[2];
+        double* gy = gx + count;
+        double* gz = gy + count;
+
+        for (size_t i{}; i < count; ++i)
+        {
+            gx[i] = 6 * x[i] + 0.3 * y[i];
+            gy[i] = y[i] + 0.3 * x[i] + 3;
+            gz[i] = 2 * z[i] + 1;
+        }
+    }
+
+    VECTORIZED void Quadratic4DValues(std::span<const double* const> coords, double* v, size_t count)
+    {
+        const double* x = coords[0];
+        const double* y = coords[1];
+        const double* z = coords[2];
+        const double* w = coords[3];
+
+        for (size_t i{}; i < count; ++i)
+        {
+            const double d0 = 1 - x[i], d1 = x[i] - y[i], d2 = y[i] - z[i], d3 = z[i] - w[i];
+
+            v[i] = d0 * d0 + d1 * d1 + d2 * d2 + d3 * d3;
+        }
+    }
+}
+
+double F_2D::FuncNull::Value(const Point<double>& p) const
+{
+    return ValueImpl(p);
+}
+
+double F_2D::FuncNull::Value(const PointN<double, 2>& p) const
+{
+    return ValueImpl(p);
+}
+
+Point<double> F_2D::FuncNull::Gradient(const Point<double>& p) const
+{
+    return GradientImpl(p);
 }
 
-Point<double> F_2D::FuncNull::Gradient(const Point<double>&) const
+PointN<double, 2> F_2D::FuncNull::Gradient(const PointN<double, 2>& p) const
 {
-    return Point<double>({0, 0});
+    return GradientImpl(p);
+}
+
+double F_2D::FuncNull::ValueAndGradient(const Point<double>& p, Point<double>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+double F_2D::FuncNull::ValueAndGradient(const PointN<double, 2>& p, PointN<double, 2>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+void F_2D::FuncNull::HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+void F_2D::FuncNull::HessianVectorProduct(const PointN<double, 2>& p, const PointN<double, 2>& v, PointN<double, 2>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+void F_2D::FuncNull::ValueBatch(std::span<const double* const> coords, std::span<double> values) const
+{
+    CheckBlock(coords, 2);
+    std::fill(values.begin(), values.end(), 0);
+}
+
+void F_2D::FuncNull::GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const
+{
+    GradientBlockCount(coords, gradients, 2);
+    std::fill(gradients.begin(), gradients.end(), 0);
 }
 
 double F_2D::FuncRosenbrock::Value(const Point<double>& p) const
 {
-    return (1 - p[0]) * (1 - p[0]) + (p[1] - p[0] * p[0]) * (p[1] - p[0] * p[0]); 
+    return ValueImpl(p);
+}
+
+double F_2D::FuncRosenbrock::Value(const PointN<double, 2>& p) const
+{
+    return ValueImpl(p);
 }
 
 Point<double> F_2D::FuncRosenbrock::Gradient(const Point<double>& p) const
 {
-    return Point<double>({-2 * (1 - p[0]) - 4 * p[0] * (p[1] - p[0] * p[0]), 2 * (p[1] - p[0] * p[0])});
+    return GradientImpl(p);
+}
+
+PointN<double, 2> F_2D::FuncRosenbrock::Gradient(const PointN<double, 2>& p) const
+{
+    return GradientImpl(p);
+}
+
+double F_2D::FuncRosenbrock::ValueAndGradient(const Point<double>& p, Point<double>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+double F_2D::FuncRosenbrock::ValueAndGradient(const PointN<double, 2>& p, PointN<double, 2>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+void F_2D::FuncRosenbrock::HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+void F_2D::FuncRosenbrock::HessianVectorProduct(const PointN<double, 2>& p, const PointN<double, 2>& v, PointN<double, 2>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+void F_2D::FuncRosenbrock::ValueBatch(std::span<const double* const> coords, std::span<double> values) const
+{
+    CheckBlock(coords, 2);
+    RosenbrockValues(coords, values.data(), values.size());
+}
+
+void F_2D::FuncRosenbrock::GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const
+{
+    RosenbrockGradients(coords, gradients.data(), GradientBlockCount(coords, gradients, 2));
 }
 
 double F_2D::FuncQuadratic1::Value(const Point<double>& p) const
 {
-    return 3 * p[0] * p[0] + 0.5 * p[1] * p[1] + 2; 
+    return ValueImpl(p);
+}
+
+double F_2D::FuncQuadratic1::Value(const PointN<double, 2>& p) const
+{
+    return ValueImpl(p);
 }
 
 Point<double> F_2D::FuncQuadratic1::Gradient(const Point<double>& p) const
 {
-    return Point<double>({6 * p[0], p[1]});
+    return GradientImpl(p);
+}
+
+PointN<double, 2> F_2D::FuncQuadratic1::Gradient(const PointN<double, 2>& p) const
+{
+    return GradientImpl(p);
+}
+
+double F_2D::FuncQuadratic1::ValueAndGradient(const Point<double>& p, Point<double>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+double F_2D::FuncQuadratic1::ValueAndGradient(const PointN<double, 2>& p, PointN<double, 2>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+void F_2D::FuncQuadratic1::HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+void F_2D::FuncQuadratic1::HessianVectorProduct(const PointN<double, 2>& p, const PointN<double, 2>& v, PointN<double, 2>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+void F_2D::FuncQuadratic1::ValueBatch(std::span<const double* const> coords, std::span<double> values) const
+{
+    CheckBlock(coords, 2);
+    Quadratic2DValues(coords, values.data(), values.size());
+}
+
+void F_2D::FuncQuadratic1::GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const
+{
+    Quadratic2DGradients(coords, gradients.data(), GradientBlockCount(coords, gradients, 2));
 }
 
 double F_2D::FuncSinSin::Value(const Point<double>& p) const
 {
-    return std::sin(M_PI * std::sin(p[0]) + M_PI * std::sin(p[1])); 
+    return ValueImpl(p);
+}
+
+double F_2D::FuncSinSin::Value(const PointN<double, 2>& p) const
+{
+    return ValueImpl(p);
 }
 
 Point<double> F_2D::FuncSinSin::Gradient(const Point<double>& p) const
-{  
-    return Point<double>({std::cos(M_PI * std::sin(p[0]) + M_PI * std::sin(p[1])) * M_PI * std::cos(p[0]),
-                          std::cos(M_PI * std::sin(p[0]) + M_PI * std::sin(p[1])) * M_PI * std::cos(p[1])});
+{
+    return GradientImpl(p);
+}
+
+PointN<double, 2> F_2D::FuncSinSin::Gradient(const PointN<double, 2>& p) const
+{
+    return GradientImpl(p);
+}
+
+double F_2D::FuncSinSin::ValueAndGradient(const Point<double>& p, Point<double>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+double F_2D::FuncSinSin::ValueAndGradient(const PointN<double, 2>& p, PointN<double, 2>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+void F_2D::FuncSinSin::HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+void F_2D::FuncSinSin::HessianVectorProduct(const PointN<double, 2>& p, const PointN<double, 2>& v, PointN<double, 2>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+void F_2D::FuncSinSin::ValueBatch(std::span<const double* const> coords, std::span<double> values) const
+{
+    CheckBlock(coords, 2);
+    SinSinValues(coords, values.data(), values.size());
+}
+
+void F_2D::FuncSinSin::GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const
+{
+    SinSinGradients(coords, gradients.data(), GradientBlockCount(coords, gradients, 2));
 }
 
 double F_2D::FuncHimmelblau::Value(const Point<double>& p) const
 {
-    return (p[0] * p[0] + p[1] - 11) * (p[0] * p[0] + p[1] - 11) + (p[0] + p[1] * p[1] - 7) * (p[0] + p[1] * p[1] - 7); 
+    return ValueImpl(p);
+}
+
+double F_2D::FuncHimmelblau::Value(const PointN<double, 2>& p) const
+{
+    return ValueImpl(p);
 }
 
 Point<double> F_2D::FuncHimmelblau::Gradient(const Point<double>& p) const
 {
-    return Point<double>({4 * p[0] * (p[0] * p[0] + p[1] - 11) + 2 * (p[0] + p[1] * p[1] - 7),
-                          2 * (p[0] * p[0] + p[1] - 11) + 4 * p[1] * (p[0] + p[1] * p[1] - 7)});
+    return GradientImpl(p);
+}
+
+PointN<double, 2> F_2D::FuncHimmelblau::Gradient(const PointN<double, 2>& p) const
+{
+    return GradientImpl(p);
+}
+
+double F_2D::FuncHimmelblau::ValueAndGradient(const Point<double>& p, Point<double>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+double F_2D::FuncHimmelblau::ValueAndGradient(const PointN<double, 2>& p, PointN<double, 2>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+void F_2D::FuncHimmelblau::HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+void F_2D::FuncHimmelblau::HessianVectorProduct(const PointN<double, 2>& p, const PointN<double, 2>& v, PointN<double, 2>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+void F_2D::FuncHimmelblau::ValueBatch(std::span<const double* const> coords, std::span<double> values) const
+{
+    CheckBlock(coords, 2);
+    HimmelblauValues(coords, values.data(), values.size());
+}
+
+void F_2D::FuncHimmelblau::GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const
+{
+    HimmelblauGradients(coords, gradients.data(), GradientBlockCount(coords, gradients, 2));
 }
 
 double F_3D::FuncQuadratic1::Value(const Point<double>& p) const
 {
-    return 3 * p[0] * p[0] + 0.5 * p[1] * p[1] + p[2] * p[2] + 0.3 * p[0] * p[1] + p[2] + 3 * p[1] + 2; 
+    return ValueImpl(p);
+}
+
+double F_3D::FuncQuadratic1::Value(const PointN<double, 3>& p) const
+{
+    return ValueImpl(p);
 }
 
 Point<double> F_3D::FuncQuadratic1::Gradient(const Point<double>& p) const
 {
-    return Point<double>({6 * p[0] + 0.3 * p[1], p[1] + 0.3 * p[0] + 3, 2 * p[2] + 1});
+    return GradientImpl(p);
+}
+
+PointN<double, 3> F_3D::FuncQuadratic1::Gradient(const PointN<double, 3>& p) const
+{
+    return GradientImpl(p);
+}
+
+double F_3D::FuncQuadratic1::ValueAndGradient(const Point<double>& p, Point<double>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+double F_3D::FuncQuadratic1::ValueAndGradient(const PointN<double, 3>& p, PointN<double, 3>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+void F_3D::FuncQuadratic1::HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+void F_3D::FuncQuadratic1::HessianVectorProduct(const PointN<double, 3>& p, const PointN<double, 3>& v, PointN<double, 3>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+void F_3D::FuncQuadratic1::ValueBatch(std::span<const double* const> coords, std::span<double> values) const
+{
+    CheckBlock(coords, 3);
+    Quadratic3DValues(coords, values.data(), values.size());
+}
+
+void F_3D::FuncQuadratic1::GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const
+{
+    Quadratic3DGradients(coords, gradients.data(), GradientBlockCount(coords, gradients, 3));
 }
 
 double F_4D::FuncQuadratic1::Value(const Point<double>& p) const
 {
-    return  (1 - p[0]) * (1 - p[0]) + (p[0] - p[1]) * (p[0] - p[1]) + (p[1] - p[2]) * (p[1] - p[2]) + (p[2] - p[3]) * (p[2] - p[3]); 
+    return ValueImpl(p);
+}
+
+double F_4D::FuncQuadratic1::Value(const PointN<double, 4>& p) const
+{
+    return ValueImpl(p);
 }
 
 Point<double> F_4D::FuncQuadratic1::Gradient(const Point<double>& p) const
 {
-    return Point<double>({-2 * (1 - p[0]) + 2 * (p[0] - p[1]), -2 * (p[0] - p[1]) + 2 * (p[1] - p[2]),
-                          -2 * (p[1] - p[2]) + 2 * (p[2] - p[3]), -2 * (p[2] - p[3])});
+    return GradientImpl(p);
 }
+
+PointN<double, 4> F_4D::FuncQuadratic1::Gradient(const PointN<double, 4>& p) const
+{
+    return GradientImpl(p);
+}
+
+double F_4D::FuncQuadratic1::ValueAndGradient(const Point<double>& p, Point<double>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+double F_4D::FuncQuadratic1::ValueAndGradient(const PointN<double, 4>& p, PointN<double, 4>& gradient) const
+{
+    return ValueAndGradientImpl(p, gradient);
+}
+
+void F_4D::FuncQuadratic1::HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+void F_4D::FuncQuadratic1::HessianVectorProduct(const PointN<double, 4>& p, const PointN<double, 4>& v, PointN<double, 4>& result) const
+{
+    HessianVectorImpl(p, v, result);
+}
+
+void F_4D::FuncQuadratic1::ValueBatch(std::span<const double* const> coords, std::span<double> values) const
+{
+    CheckBlock(coords, 4);
+    Quadratic4DValues(coords, values.data(), values.size());
+}
+
+void F_4D::FuncQuadratic1::GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const
+{
+    const size_t count = GradientBlockCount(coords, gradients, 4);
+
+    const double* x = coords[0];
+    const double* y = coords[1];
+    const double* z = coords[2];
+    const double* w = coords[3];
+    double* gx = gradients.data();
+    double* gy = gx + count;
+    double* gz = gy + count;
+    double* gw = gz + count;
+
+    for (size_t i{}; i < count; ++i)
+    {
+        const double d0 = 1 - x[i], d1 = x[i] - y[i], d2 = y[i] - z[i], d3 = z[i] - w[i];
+
+        gx[i] = -2 * d0 + 2 * d1;
+        gy[i] = -2 * d1 + 2 * d2;
+        gz[i] = -2 * d2 + 2 * d3;
+        gw[i] = -2 * d3;
+    }
+}
\ No newline at end of file
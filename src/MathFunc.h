@@ -1,80 +1,488 @@
+#pragma once
+
 #include "Optimization.h"
 
+// Formulas of the functions (ValueImpl, GradientImpl, ValueAndGradientImpl) are static templates defined in this header,
+// so statically dispatched optimizers (StaticOptim.h) can inline them. Virtual members are defined in MathFunc.cpp.
+
 namespace F_2D
 {
-    class FuncNull : public GeneralFunction<double>
+    class FuncNull final : public GeneralFunction<double>, public FunctionN<double, 2>
     {
     public:
+        template <class Container>
+        static double ValueImpl(const Point<double, Container>& p);
+
+        template <class Container>
+        static Point<double, Container> GradientImpl(const Point<double, Container>& p);
+
+        template <class Container>
+        static double ValueAndGradientImpl(const Point<double, Container>& p, Point<double, Container>& gradient);
+
+        template <class Container>
+        static void HessianVectorImpl(const Point<double, Container>& p, const Point<double, Container>& v, Point<double, Container>& result);
+
         FuncNull() = default;
 
         double Value(const Point<double>& p) const override;
+        double Value(const PointN<double, 2>& p) const override;
 
         Point<double> Gradient(const Point<double>& p) const override;
+        PointN<double, 2> Gradient(const PointN<double, 2>& p) const override;
+
+        double ValueAndGradient(const Point<double>& p, Point<double>& gradient) const override;
+        double ValueAndGradient(const PointN<double, 2>& p, PointN<double, 2>& gradient) const override;
+
+        void HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const override;
+        void HessianVectorProduct(const PointN<double, 2>& p, const PointN<double, 2>& v, PointN<double, 2>& result) const override;
+
+        void ValueBatch(std::span<const double* const> coords, std::span<double> values) const override;
+        void GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const override;
     };
 
-    class FuncRosenbrock : public GeneralFunction<double>
+    class FuncRosenbrock final : public GeneralFunction<double>, public FunctionN<double, 2>
     {
     public:
+        template <class Container>
+        static double ValueImpl(const Point<double, Container>& p);
+
+        template <class Container>
+        static Point<double, Container> GradientImpl(const Point<double, Container>& p);
+
+        template <class Container>
+        static double ValueAndGradientImpl(const Point<double, Container>& p, Point<double, Container>& gradient);
+
+        template <class Container>
+        static void HessianVectorImpl(const Point<double, Container>& p, const Point<double, Container>& v, Point<double, Container>& result);
+
         FuncRosenbrock() = default;
 
         double Value(const Point<double>& p) const override;
+        double Value(const PointN<double, 2>& p) const override;
 
         Point<double> Gradient(const Point<double>& p) const override;
+        PointN<double, 2> Gradient(const PointN<double, 2>& p) const override;
+
+        double ValueAndGradient(const Point<double>& p, Point<double>& gradient) const override;
+        double ValueAndGradient(const PointN<double, 2>& p, PointN<double, 2>& gradient) const override;
+
+        void HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const override;
+        void HessianVectorProduct(const PointN<double, 2>& p, const PointN<double, 2>& v, PointN<double, 2>& result) const override;
+
+        void ValueBatch(std::span<const double* const> coords, std::span<double> values) const override;
+        void GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const override;
     };
 
-    class FuncQuadratic1 : public GeneralFunction<double>
+    class FuncQuadratic1 final : public GeneralFunction<double>, public FunctionN<double, 2>
     {
     public:
+        template <class Container>
+        static double ValueImpl(const Point<double, Container>& p);
+
+        template <class Container>
+        static Point<double, Container> GradientImpl(const Point<double, Container>& p);
+
+        template <class Container>
+        static double ValueAndGradientImpl(const Point<double, Container>& p, Point<double, Container>& gradient);
+
+        template <class Container>
+        static void HessianVectorImpl(const Point<double, Container>& p, const Point<double, Container>& v, Point<double, Container>& result);
+
         FuncQuadratic1() = default;
 
         double Value(const Point<double>& p) const override;
+        double Value(const PointN<double, 2>& p) const override;
 
         Point<double> Gradient(const Point<double>& p) const override;
+        PointN<double, 2> Gradient(const PointN<double, 2>& p) const override;
+
+        double ValueAndGradient(const Point<double>& p, Point<double>& gradient) const override;
+        double ValueAndGradient(const PointN<double, 2>& p, PointN<double, 2>& gradient) const override;
+
+        void HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const override;
+        void HessianVectorProduct(const PointN<double, 2>& p, const PointN<double, 2>& v, PointN<double, 2>& result) const override;
+
+        void ValueBatch(std::span<const double* const> coords, std::span<double> values) const override;
+        void GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const override;
     };
 
-    class FuncSinSin : public GeneralFunction<double>
+    class FuncSinSin final : public GeneralFunction<double>, public FunctionN<double, 2>
     {
     public:
+        template <class Container>
+        static double ValueImpl(const Point<double, Container>& p);
+
+        template <class Container>
+        static Point<double, Container> GradientImpl(const Point<double, Container>& p);
+
+        template <class Container>
+        static double ValueAndGradientImpl(const Point<double, Container>& p, Point<double, Container>& gradient);
+
+        template <class Container>
+        static void HessianVectorImpl(const Point<double, Container>& p, const Point<double, Container>& v, Point<double, Container>& result);
+
         FuncSinSin() = default;
 
         double Value(const Point<double>& p) const override;
+        double Value(const PointN<double, 2>& p) const override;
 
         Point<double> Gradient(const Point<double>& p) const override;
+        PointN<double, 2> Gradient(const PointN<double, 2>& p) const override;
+
+        double ValueAndGradient(const Point<double>& p, Point<double>& gradient) const override;
+        double ValueAndGradient(const PointN<double, 2>& p, PointN<double, 2>& gradient) const override;
+
+        void HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const override;
+        void HessianVectorProduct(const PointN<double, 2>& p, const PointN<double, 2>& v, PointN<double, 2>& result) const override;
+
+        void ValueBatch(std::span<const double* const> coords, std::span<double> values) const override;
+        void GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const override;
     };
 
-    class FuncHimmelblau : public GeneralFunction<double>
+    class FuncHimmelblau final : public GeneralFunction<double>, public FunctionN<double, 2>
     {
     public:
+        template <class Container>
+        static double ValueImpl(const Point<double, Container>& p);
+
+        template <class Container>
+        static Point<double, Container> GradientImpl(const Point<double, Container>& p);
+
+        template <class Container>
+        static double ValueAndGradientImpl(const Point<double, Container>& p, Point<double, Container>& gradient);
+
+        template <class Container>
+        static void HessianVectorImpl(const Point<double, Container>& p, const Point<double, Container>& v, Point<double, Container>& result);
+
         FuncHimmelblau() = default;
 
         double Value(const Point<double>& p) const override;
+        double Value(const PointN<double, 2>& p) const override;
 
         Point<double> Gradient(const Point<double>& p) const override;
+        PointN<double, 2> Gradient(const PointN<double, 2>& p) const override;
+
+        double ValueAndGradient(const Point<double>& p, Point<double>& gradient) const override;
+        double ValueAndGradient(const PointN<double, 2>& p, PointN<double, 2>& gradient) const override;
+
+        void HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const override;
+        void HessianVectorProduct(const PointN<double, 2>& p, const PointN<double, 2>& v, PointN<double, 2>& result) const override;
+
+        void ValueBatch(std::span<const double* const> coords, std::span<double> values) const override;
+        void GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const override;
     };
 }
 
 namespace F_3D
 {
-    class FuncQuadratic1 : public GeneralFunction<double>
+    class FuncQuadratic1 final : public GeneralFunction<double>, public FunctionN<double, 3>
     {
     public:
+        template <class Container>
+        static double ValueImpl(const Point<double, Container>& p);
+
+        template <class Container>
+        static Point<double, Container> GradientImpl(const Point<double, Container>& p);
+
+        template <class Container>
+        static double ValueAndGradientImpl(const Point<double, Container>& p, Point<double, Container>& gradient);
+
+        template <class Container>
+        static void HessianVectorImpl(const Point<double, Container>& p, const Point<double, Container>& v, Point<double, Container>& result);
+
         FuncQuadratic1() = default;
 
         double Value(const Point<double>& p) const override;
+        double Value(const PointN<double, 3>& p) const override;
 
         Point<double> Gradient(const Point<double>& p) const override;
+        PointN<double, 3> Gradient(const PointN<double, 3>& p) const override;
+
+        double ValueAndGradient(const Point<double>& p, Point<double>& gradient) const override;
+        double ValueAndGradient(const PointN<double, 3>& p, PointN<double, 3>& gradient) const override;
+
+        void HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const override;
+        void HessianVectorProduct(const PointN<double, 3>& p, const PointN<double, 3>& v, PointN<double, 3>& result) const override;
+
+        void ValueBatch(std::span<const double* const> coords, std::span<double> values) const override;
+        void GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const override;
     };
 }
 
 namespace F_4D
 {
-    class FuncQuadratic1 : public GeneralFunction<double>
+    class FuncQuadratic1 final : public GeneralFunction<double>, public FunctionN<double, 4>
     {
     public:
+        template <class Container>
+        static double ValueImpl(const Point<double, Container>& p);
+
+        template <class Container>
+        static Point<double, Container> GradientImpl(const Point<double, Container>& p);
+
+        template <class Container>
+        static double ValueAndGradientImpl(const Point<double, Container>& p, Point<double, Container>& gradient);
+
+        template <class Container>
+        static void HessianVectorImpl(const Point<double, Container>& p, const Point<double, Container>& v, Point<double, Container>& result);
+
         FuncQuadratic1() = default;
 
         double Value(const Point<double>& p) const override;
+        double Value(const PointN<double, 4>& p) const override;
 
         Point<double> Gradient(const Point<double>& p) const override;
+        PointN<double, 4> Gradient(const PointN<double, 4>& p) const override;
+
+        double ValueAndGradient(const Point<double>& p, Point<double>& gradient) const override;
+        double ValueAndGradient(const PointN<double, 4>& p, PointN<double, 4>& gradient) const override;
+
+        void HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const override;
+        void HessianVectorProduct(const PointN<double, 4>& p, const PointN<double, 4>& v, PointN<double, 4>& result) const override;
+
+        void ValueBatch(std::span<const double* const> coords, std::span<double> values) const override;
+        void GradientBatch(std::span<const double* const> coords, std::span<double> gradients) const override;
     };
-}
\ No newline at end of file
+}
+
+template <class Container>
+double F_2D::FuncNull::ValueImpl(const Point<double, Container>&)
+{
+    return 0; 
+}
+
+template <class Container>
+Point<double, Container> F_2D::FuncNull::GradientImpl(const Point<double, Container>&)
+{
+    return Point<double, Container>({0, 0});
+}
+
+template <class Container>
+double F_2D::FuncNull::ValueAndGradientImpl(const Point<double, Container>&, Point<double, Container>& gradient)
+{
+    gradient.Resize(2);
+    gradient.Fill(0);
+
+    return 0;
+}
+
+template <class Container>
+void F_2D::FuncNull::HessianVectorImpl(const Point<double, Container>&, const Point<double, Container>&, Point<double, Container>& result)
+{
+    result.Resize(2);
+    result.Fill(0);
+}
+
+template <class Container>
+double F_2D::FuncRosenbrock::ValueImpl(const Point<double, Container>& p)
+{
+    const double a = 1 - p[0], b = p[1] - p[0] * p[0];
+
+    return a * a + b * b;
+}
+
+template <class Container>
+Point<double, Container> F_2D::FuncRosenbrock::GradientImpl(const Point<double, Container>& p)
+{
+    const double b = p[1] - p[0] * p[0];
+
+    return Point<double, Container>({-2 * (1 - p[0]) - 4 * p[0] * b, 2 * b});
+}
+
+template <class Container>
+double F_2D::FuncRosenbrock::ValueAndGradientImpl(const Point<double, Container>& p, Point<double, Container>& gradient)
+{
+    const double a = 1 - p[0], b = p[1] - p[0] * p[0];
+
+    gradient.Resize(2);
+    gradient[0] = -2 * a - 4 * p[0] * b;
+    gradient[1] = 2 * b;
+
+    return a * a + b * b;
+}
+
+template <class Container>
+void F_2D::FuncRosenbrock::HessianVectorImpl(const Point<double, Container>& p, const Point<double, Container>& v, Point<double, Container>& result)
+{
+    const double xx = 2 - 4 * p[1] + 12 * p[0] * p[0], xy = -4 * p[0];
+
+    result.Resize(2);
+    result[0] = xx * v[0] + xy * v[1];
+    result[1] = xy * v[0] + 2 * v[1];
+}
+
+template <class Container>
+double F_2D::FuncQuadratic1::ValueImpl(const Point<double, Container>& p)
+{
+    return 3 * p[0] * p[0] + 0.5 * p[1] * p[1] + 2; 
+}
+
+template <class Container>
+Point<double, Container> F_2D::FuncQuadratic1::GradientImpl(const Point<double, Container>& p)
+{
+    return Point<double, Container>({6 * p[0], p[1]});
+}
+
+template <class Container>
+double F_2D::FuncQuadratic1::ValueAndGradientImpl(const Point<double, Container>& p, Point<double, Container>& gradient)
+{
+    gradient.Resize(2);
+    gradient[0] = 6 * p[0];
+    gradient[1] = p[1];
+
+    return 3 * p[0] * p[0] + 0.5 * p[1] * p[1] + 2;
+}
+
+template <class Container>
+void F_2D::FuncQuadratic1::HessianVectorImpl(const Point<double, Container>&, const Point<double, Container>& v, Point<double, Container>& result)
+{
+    result.Resize(2);
+    result[0] = 6 * v[0];
+    result[1] = v[1];
+}
+
+template <class Container>
+double F_2D::FuncSinSin::ValueImpl(const Point<double, Container>& p)
+{
+    return std::sin(M_PI * std::sin(p[0]) + M_PI * std::sin(p[1])); 
+}
+
+template <class Container>
+Point<double, Container> F_2D::FuncSinSin::GradientImpl(const Point<double, Container>& p)
+{  
+    const double outer = std::cos(M_PI * std::sin(p[0]) + M_PI * std::sin(p[1])) * M_PI;
+
+    return Point<double, Container>({outer * std::cos(p[0]), outer * std::cos(p[1])});
+}
+
+template <class Container>
+double F_2D::FuncSinSin::ValueAndGradientImpl(const Point<double, Container>& p, Point<double, Container>& gradient)
+{
+    const double inner = M_PI * std::sin(p[0]) + M_PI * std::sin(p[1]), outer = std::cos(inner) * M_PI;
+
+    gradient.Resize(2);
+    gradient[0] = outer * std::cos(p[0]);
+    gradient[1] = outer * std::cos(p[1]);
+
+    return std::sin(inner);
+}
+
+template <class Container>
+void F_2D::FuncSinSin::HessianVectorImpl(const Point<double, Container>& p, const Point<double, Container>& v, Point<double, Container>& result)
+{
+    const double inner = M_PI * std::sin(p[0]) + M_PI * std::sin(p[1]), s = std::sin(inner) * M_PI * M_PI, c = std::cos(inner) * M_PI;
+    const double cx = std::cos(p[0]), cy = std::cos(p[1]);
+    const double xx = -s * cx * cx - c * std::sin(p[0]), xy = -s * cx * cy, yy = -s * cy * cy - c * std::sin(p[1]);
+
+    result.Resize(2);
+    result[0] = xx * v[0] + xy * v[1];
+    result[1] = xy * v[0] + yy * v[1];
+}
+
+template <class Container>
+double F_2D::FuncHimmelblau::ValueImpl(const Point<double, Container>& p)
+{
+    const double a = p[0] * p[0] + p[1] - 11, b = p[0] + p[1] * p[1] - 7;
+
+    return a * a + b * b;
+}
+
+template <class Container>
+Point<double, Container> F_2D::FuncHimmelblau::GradientImpl(const Point<double, Container>& p)
+{
+    const double a = p[0] * p[0] + p[1] - 11, b = p[0] + p[1] * p[1] - 7;
+
+    return Point<double, Container>({4 * p[0] * a + 2 * b, 2 * a + 4 * p[1] * b});
+}
+
+template <class Container>
+double F_2D::FuncHimmelblau::ValueAndGradientImpl(const Point<double, Container>& p, Point<double, Container>& gradient)
+{
+    const double a = p[0] * p[0] + p[1] - 11, b = p[0] + p[1] * p[1] - 7;
+
+    gradient.Resize(2);
+    gradient[0] = 4 * p[0] * a + 2 * b;
+    gradient[1] = 2 * a + 4 * p[1] * b;
+
+    return a * a + b * b;
+}
+
+template <class Container>
+void F_2D::FuncHimmelblau::HessianVectorImpl(const Point<double, Container>& p, const Point<double, Container>& v, Point<double, Container>& result)
+{
+    const double a = p[0] * p[0] + p[1] - 11, b = p[0] + p[1] * p[1] - 7;
+    const double xx = 4 * a + 8 * p[0] * p[0] + 2, xy = 4 * p[0] + 4 * p[1], yy = 2 + 4 * b + 8 * p[1] * p[1];
+
+    result.Resize(2);
+    result[0] = xx * v[0] + xy * v[1];
+    result[1] = xy * v[0] + yy * v[1];
+}
+
+template <class Container>
+double F_3D::FuncQuadratic1::ValueImpl(const Point<double, Container>& p)
+{
+    return 3 * p[0] * p[0] + 0.5 * p[1] * p[1] + p[2] * p[2] + 0.3 * p[0] * p[1] + p[2] + 3 * p[1] + 2; 
+}
+
+template <class Container>
+Point<double, Container> F_3D::FuncQuadratic1::GradientImpl(const Point<double, Container>& p)
+{
+    return Point<double, Container>({6 * p[0] + 0.3 * p[1], p[1] + 0.3 * p[0] + 3, 2 * p[2] + 1});
+}
+
+template <class Container>
+double F_3D::FuncQuadratic1::ValueAndGradientImpl(const Point<double, Container>& p, Point<double, Container>& gradient)
+{
+    gradient.Resize(3);
+    gradient[0] = 6 * p[0] + 0.3 * p[1];
+    gradient[1] = p[1] + 0.3 * p[0] + 3;
+    gradient[2] = 2 * p[2] + 1;
+
+    return 3 * p[0] * p[0] + 0.5 * p[1] * p[1] + p[2] * p[2] + 0.3 * p[0] * p[1] + p[2] + 3 * p[1] + 2;
+}
+
+template <class Container>
+void F_3D::FuncQuadratic1::HessianVectorImpl(const Point<double, Container>&, const Point<double, Container>& v, Point<double, Container>& result)
+{
+    result.Resize(3);
+    result[0] = 6 * v[0] + 0.3 * v[1];
+    result[1] = 0.3 * v[0] + v[1];
+    result[2] = 2 * v[2];
+}
+
+template <class Container>
+double F_4D::FuncQuadratic1::ValueImpl(const Point<double, Container>& p)
+{
+    return  (1 - p[0]) * (1 - p[0]) + (p[0] - p[1]) * (p[0] - p[1]) + (p[1] - p[2]) * (p[1] - p[2]) + (p[2] - p[3]) * (p[2] - p[3]); 
+}
+
+template <class Container>
+Point<double, Container> F_4D::FuncQuadratic1::GradientImpl(const Point<double, Container>& p)
+{
+    return Point<double, Container>({-2 * (1 - p[0]) + 2 * (p[0] - p[1]), -2 * (p[0] - p[1]) + 2 * (p[1] - p[2]),
+                          -2 * (p[1] - p[2]) + 2 * (p[2] - p[3]), -2 * (p[2] - p[3])});
+}
+
+template <class Container>
+double F_4D::FuncQuadratic1::ValueAndGradientImpl(const Point<double, Container>& p, Point<double, Container>& gradient)
+{
+    const double d0 = 1 - p[0], d1 = p[0] - p[1], d2 = p[1] - p[2], d3 = p[2] - p[3];
+
+    gradient.Resize(4);
+    gradient[0] = -2 * d0 + 2 * d1;
+    gradient[1] = -2 * d1 + 2 * d2;
+    gradient[2] = -2 * d2 + 2 * d3;
+    gradient[3] = -2 * d3;
+
+    return d0 * d0 + d1 * d1 + d2 * d2 + d3 * d3;
+}
+
+template <class Container>
+void F_4D::FuncQuadratic1::HessianVectorImpl(const Point<double, Container>&, const Point<double, Container>& v, Point<double, Container>& result)
+{
+    result.Resize(4);
+    result[0] = 4 * v[0] - 2 * v[1];
+    result[1] = -2 * v[0] + 4 * v[1] - 2 * v[2];
+    result[2] = -2 * v[1] + 4 * v[2] - 2 * v[3];
+    result[3] = -2 * v[2] + 2 * v[3];
+}
@@ -0,0 +1,300 @@
+/// @file
+/// @brief Parallel optimization from many start points.
+/// @details File contains generators of start points (uniform, Latin hypercube and Sobol sequence)
+/// and the multi-start engine. The engine runs independent local optimizations on a pool of threads.
+/// Every thread has its own method and stopper, created by factories, because methods and stoppers keep the state of a run.
+/// The function is shared by threads, so its evaluations must be thread-safe.
+/// Every run is seeded by its index and starts from a clean state, so results do not depend on the count of threads.
+/// Last points of runs are merged into distinct minima ranked by value.
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "Optimization.h"
+#include "ThreadPool.h"
+
+/// @brief Method of generation of start points.
+enum class StartSampling { Uniform, LatinHypercube, Sobol };
+
+namespace MultiStartDetail
+{
+    /// @brief Maximum dimension of the Sobol sequence.
+    static constexpr size_t SOBOLDIM = 21;
+
+    /// @brief Primitive polynomials and initial direction numbers of the Sobol sequence for dimensions 2, ..., SOBOLDIM (Joe and Kuo).
+    struct SobolParam
+    {
+        unsigned degree;
+        uint32_t polynomial;
+        uint32_t m[7];
+    };
+
+    static constexpr SobolParam SOBOL[SOBOLDIM - 1] = {
+        {1, 0, {1}}, {2, 1, {1, 3}}, {3, 1, {1, 3, 1}}, {3, 2, {1, 1, 1}}, {4, 1, {1, 1, 3, 3}},
+        {4, 4, {1, 3, 5, 13}}, {5, 2, {1, 1, 5, 5, 17}}, {5, 4, {1, 1, 5, 5, 5}}, {5, 7, {1, 1, 7, 11, 19}},
+        {5, 11, {1, 1, 5, 1, 1}}, {5, 13, {1, 1, 1, 3, 11}}, {5, 14, {1, 3, 5, 5, 31}}, {6, 1, {1, 3, 3, 9, 7, 49}},
+        {6, 13, {1, 1, 1, 15, 21, 21}}, {6, 16, {1, 3, 1, 13, 27, 49}}, {6, 19, {1, 1, 1, 15, 7, 5}},
+        {6, 22, {1, 3, 1, 15, 13, 25}}, {6, 25, {1, 1, 5, 5, 19, 61}}, {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+        {7, 4, {1, 3, 7, 13, 13, 15, 69}}};
+
+    /// @brief Direction numbers of a dimension of the Sobol sequence as 32-bit fractions.
+    inline std::vector<uint32_t> SobolDirections(size_t d)
+    {
+        std::vector<uint32_t> v(32);
+
+        if (!d)
+        {
+            for (unsigned k{}; k < 32; ++k)
+                v[k] = 1u << (31 - k);
+
+            return v;
+        }
+
+        const SobolParam& param = SOBOL[d - 1];
+
+        for (unsigned k{}; k < 32; ++k)
+            if (k < param.degree)
+                v[k] = param.m[k] << (31 - k);
+            else
+            {
+                v[k] = v[k - param.degree] ^ (v[k - param.degree] >> param.degree);
+
+                for (unsigned j{1}; j < param.degree; ++j)
+                    if ((param.polynomial >> (param.degree - 1 - j)) & 1)
+                        v[k] ^= v[k - j];
+            }
+
+        return v;
+    }
+}
+
+/// @brief Generates start points in an area.
+/// @details The Latin hypercube puts exactly one point in every of count slices of every coordinate.
+/// The Sobol sequence is scrambled by a random digital shift and skips its first point, the corner of the area.
+/// @param area Area of points.
+/// @param count Count of points.
+/// @param sampling Method of generation.
+/// @param seed Seed of the generator.
+/// @return Start points.
+/// @throw std::invalid_argument If the Sobol sequence is asked for a dimension greater than 21.
+template <typename T>
+std::vector<Point<T>> GenerateStarts(const CubicArea<T>& area, size_t count, StartSampling sampling, size_t seed = 0)
+{
+    const size_t dim = area.minArea.size();
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<T> unit(static_cast<T>(0), static_cast<T>(1));
+    std::vector<Point<T>> res(count, area.minArea);
+
+    // u is in [0, 1), it is mapped to the area.
+    auto set = [&area, &res](size_t i, size_t j, T u)
+    {
+        res[i][j] = std::min(area.minArea[j] + u * (area.maxArea[j] - area.minArea[j]), area.maxArea[j]);
+    };
+
+    switch (sampling)
+    {
+    case StartSampling::Uniform:
+        for (size_t i{}; i < count; ++i)
+            for (size_t j{}; j < dim; ++j)
+                set(i, j, unit(generator));
+
+        break;
+    case StartSampling::LatinHypercube:
+    {
+        std::vector<size_t> slices(count);
+
+        for (size_t j{}; j < dim; ++j)
+        {
+            std::iota(slices.begin(), slices.end(), size_t{});
+            std::shuffle(slices.begin(), slices.end(), generator);
+
+            for (size_t i{}; i < count; ++i)
+                set(i, j, (static_cast<T>(slices[i]) + unit(generator)) / static_cast<T>(count));
+        }
+
+        break;
+    }
+    case StartSampling::Sobol:
+    {
+        if (dim > MultiStartDetail::SOBOLDIM)
+            throw std::invalid_argument("Sobol sequence is defined for dimension up to 21.");
+
+        for (size_t j{}; j < dim; ++j)
+        {
+            const std::vector<uint32_t> v = MultiStartDetail::SobolDirections(j);
+            const uint32_t shift = static_cast<uint32_t>(generator());
+            uint32_t x = 0;
+
+            // Gray code order: the point n differs from the point n - 1 by the direction of the lowest zero bit of n - 1.
+            for (size_t i{}; i < count; ++i)
+            {
+                x ^= v[std::countr_one(static_cast<uint32_t>(i))];
+                set(i, j, static_cast<T>(x ^ shift) / static_cast<T>(4294967296.0));
+            }
+        }
+
+        break;
+    }
+    }
+
+    return res;
+}
+
+/// @brief Result of a run from one start point.
+template <typename T>
+struct StartResult
+{
+    Point<T> start;
+    Point<T> point;
+    T value{};
+    size_t iterations = 0;
+    size_t evaluations = 0;
+};
+
+/// @brief Distinct local minimum found by runs.
+template <typename T>
+struct LocalMinimum
+{
+    /// @brief The best last point of runs which came to the minimum.
+    Point<T> point;
+    T value{};
+    /// @brief Count of runs which came to the minimum and the index of the run with the best point.
+    size_t count = 0;
+    size_t run = 0;
+};
+
+/// @brief Engine of parallel optimization from many start points.
+/// @tparam T Typename for a value of a function.
+template <typename T = double>
+class MultiStart
+{
+public:
+    /// @brief Factory of a method. It gets the stopper of the same thread.
+    using MethodFactory = std::function<std::unique_ptr<Optimization<T>>(GeneralStop<T>&)>;
+    using StopFactory = std::function<std::unique_ptr<GeneralStop<T>>()>;
+private:
+    /// @brief Method and stopper of one thread.
+    struct Worker
+    {
+        std::unique_ptr<GeneralStop<T>> stop;
+        std::unique_ptr<Optimization<T>> method;
+    };
+
+    MethodFactory makeMethod;
+    StopFactory makeStop;
+    ThreadPool* pool;
+    T distance;
+    std::vector<Worker> workers;
+    std::vector<StartResult<T>> runs;
+
+    void CorrectField();
+public:
+    /// @brief Constructor of the engine.
+    /// @param[in] _makeMethod Factory of a method.
+    /// @param[in] _makeStop Factory of a stopper.
+    /// @param[in] _pool Pool of threads.
+    /// @param[in] _distance Last points closer than the distance belong to one minimum.
+    MultiStart(MethodFactory _makeMethod, StopFactory _makeStop, ThreadPool& _pool, const T& _distance);
+
+    void SetParam(MethodFactory _makeMethod, StopFactory _makeStop, ThreadPool& _pool, const T& _distance);
+
+    /// @brief Runs optimizations from all start points.
+    /// @param[in] area Area for optimization.
+    /// @param[in] starts Start points.
+    /// @param[in] seed Seed of runs: the run i gets the seed seed + i.
+    /// @return Distinct minima from the best one.
+    std::vector<LocalMinimum<T>> Run(const CubicArea<T>& area, const std::vector<Point<T>>& starts, size_t seed = 0);
+
+    /// @brief Results of runs of the last call of Run in order of start points.
+    inline const std::vector<StartResult<T>>& getRuns() const { return runs; }
+};
+
+template <typename T>
+void MultiStart<T>::CorrectField()
+{
+    if (!makeMethod || !makeStop)
+        throw std::invalid_argument("Factories must be set.");
+
+    if (distance <= 0)
+        throw std::invalid_argument("Distance must be greater than zero.");
+}
+
+template <typename T>
+MultiStart<T>::MultiStart(MethodFactory _makeMethod, StopFactory _makeStop, ThreadPool& _pool, const T& _distance)
+    : makeMethod(std::move(_makeMethod)), makeStop(std::move(_makeStop)), pool(&_pool), distance(_distance)
+{
+    CorrectField();
+}
+
+template <typename T>
+void MultiStart<T>::SetParam(MethodFactory _makeMethod, StopFactory _makeStop, ThreadPool& _pool, const T& _distance)
+{
+    makeMethod = std::move(_makeMethod);
+    makeStop = std::move(_makeStop);
+    pool = &_pool;
+    distance = _distance;
+    workers.clear();
+
+    CorrectField();
+}
+
+template <typename T>
+std::vector<LocalMinimum<T>> MultiStart<T>::Run(const CubicArea<T>& area, const std::vector<Point<T>>& starts, size_t seed)
+{
+    runs.assign(starts.size(), StartResult<T>());
+    workers.resize(pool->getSize());
+
+    pool->ParallelForSlot(starts.size(), [this, &area, &starts, seed](size_t i, size_t slot)
+    {
+        Worker& worker = workers[slot];
+
+        if (!worker.method)
+        {
+            worker.stop = makeStop();
+            worker.method = makeMethod(*worker.stop);
+        }
+
+        Optimization<T>& method = *worker.method;
+
+        method.SetArea(area.minArea, area.maxArea);
+        method.SetSeed(seed + i);
+        method.DoOptimize(starts[i]);
+
+        const RunSummary<T> summary = method.getSummary();
+        StartResult<T>& run = runs[i];
+
+        run.start = starts[i];
+        run.point = method.getPathway().back();
+        run.value = summary.valueEnd;
+        run.iterations = summary.iterations;
+        run.evaluations = summary.evaluations;
+    });
+
+    // Runs are merged from the best one, ties are broken by the index, so minima do not depend on the schedule.
+    std::vector<size_t> order(runs.size());
+    std::iota(order.begin(), order.end(), size_t{});
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return runs[a].value < runs[b].value; });
+
+    std::vector<LocalMinimum<T>> minima;
+
+    for (const size_t i : order)
+    {
+        auto same = std::find_if(minima.begin(), minima.end(), [this, i](const LocalMinimum<T>& minimum)
+        {
+            return Norm(minimum.point + (-runs[i].point)) < distance;
+        });
+
+        if (same != minima.end())
+            ++same->count;
+        else
+            minima.push_back({runs[i].point, runs[i].value, 1, i});
+    }
+
+    return minima;
+}
@@ -0,0 +1,267 @@
+/// @file
+/// @brief Realization of the truncated Newton method with a trust region.
+/// @details File contains the definition of a template class of the Newton-CG method. The step minimizes the quadratic model
+/// of the function by conjugate gradients (Steihaug-Toint), which need only products of the Hessian and vectors
+/// (GeneralFunction::HessianVectorProduct). Conjugate gradients stop on the boundary of the trust region,
+/// on the boundary of the area, on a direction of negative curvature or when the residual is small enough.
+/// Coordinates on the boundary of the area where the gradient points outside are fixed, so every point stays in the area.
+#pragma once
+
+#include <algorithm>
+#include "Optimization.h"
+
+/// @brief Class of the Newton-CG method with a trust region.
+/// @tparam T Typename for a value of a function.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class NewtonOptimization : public Optimization<T, Container>
+{
+private:
+    T radius;
+    T radiusStart;
+    T tolerance;
+    size_t maxInner;
+    /// @brief Value and gradient at the last point of the pathway.
+    T value;
+    Point<T, Container> gradient;
+    Point<T, Container> nextGradient;
+    /// @brief One for free coordinates and zero for fixed ones.
+    Point<T, Container> freeMask;
+    /// @brief Step, its product with the Hessian and vectors of conjugate gradients. Their storage is reused by all iterations.
+    Point<T, Container> step;
+    Point<T, Container> stepProduct;
+    Point<T, Container> residual;
+    Point<T, Container> direction;
+    Point<T, Container> product;
+    Point<T, Container> trial;
+    /// @brief Maximum count of reductions of the trust region in one iteration.
+    static constexpr size_t MAXATTEMPT = 30;
+    /// @brief Minimum ratio of the actual and the predicted decrease for accepting a step.
+    static constexpr T ETA = static_cast<T>(1e-4);
+
+    /// @brief Fixes coordinates on the boundary of the area where the gradient points outside.
+    /// @return Norm of the gradient by free coordinates.
+    T FreeCoordinates(const Point<T, Container>& point);
+
+    /// @brief The largest tau such that point + s + tau * d is in the trust region and in the area.
+    T MaxStep(const Point<T, Container>& point, const Point<T, Container>& s, const Point<T, Container>& d) const;
+
+    /// @brief Minimizes the quadratic model in the trust region by conjugate gradients. The result is in step.
+    /// @param point Center of the trust region.
+    /// @param gradientNorm Norm of the gradient by free coordinates.
+    /// @return Decrease of the quadratic model.
+    T Steihaug(const Point<T, Container>& point, const T& gradientNorm);
+
+    /// @brief Product of the Hessian and a vector by free coordinates.
+    void Product(const Point<T, Container>& point, const Point<T, Container>& v, Point<T, Container>& result);
+protected:
+    Point<T, Container> NextPoint(const Point<T, Container>& point) override;
+    void SetStart(const Point<T, Container>& startPoint) override;
+    void FillState(const Point<T, Container>& point, IterationState<T, Container>& state) const override;
+
+    /// @brief It checked correct of field.
+    void CorrectField() override;
+public:
+    /// @brief Constructor of optimization of the Newton-CG method.
+    /// @param[in] _f Function for optimization.
+    /// @param[in] _stopIteration Stopper for stoping.
+    /// @param[in] _radius Initial radius of the trust region.
+    /// @param[in] _tolerance Relative residual which stops conjugate gradients. Near the minimum it decreases
+    /// as the square root of the gradient norm, so the convergence is superlinear.
+    /// @param[in] _maxInner Maximum count of iterations of conjugate gradients. Zero means the dimension.
+    NewtonOptimization(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration, const T& _radius,
+                       const T& _tolerance = static_cast<T>(0.1), size_t _maxInner = 0);
+
+    void SetParam(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration, const T& _radius,
+                  const T& _tolerance = static_cast<T>(0.1), size_t _maxInner = 0);
+
+    /// @brief Radius of the trust region after the last iteration.
+    inline T getRadius() const { return radius; }
+};
+
+template <typename T, class Container>
+void NewtonOptimization<T, Container>::CorrectField()
+{
+    if (radiusStart <= 0)
+        throw std::invalid_argument("Radius must be greater than zero.");
+
+    if (tolerance <= 0 || tolerance >= 1)
+        throw std::invalid_argument("Tolerance must be greater than zero and less than 1.");
+}
+
+template <typename T, class Container>
+NewtonOptimization<T, Container>::NewtonOptimization(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration, const T& _radius,
+                                                     const T& _tolerance, size_t _maxInner)
+    : Optimization<T, Container>(_f, _stopIteration), radius(_radius), radiusStart(_radius), tolerance(_tolerance), maxInner(_maxInner)
+{
+    CorrectField();
+}
+
+template <typename T, class Container>
+void NewtonOptimization<T, Container>::SetParam(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration, const T& _radius,
+                                                const T& _tolerance, size_t _maxInner)
+{
+    Optimization<T, Container>::SetParam(_f, _stopIteration);
+    radiusStart = _radius;
+    tolerance = _tolerance;
+    maxInner = _maxInner;
+
+    CorrectField();
+}
+
+template <typename T, class Container>
+void NewtonOptimization<T, Container>::SetStart(const Point<T, Container>& startPoint)
+{
+    radius = radiusStart;
+    value = this->f->ValueAndGradient(startPoint, gradient);
+}
+
+template <typename T, class Container>
+void NewtonOptimization<T, Container>::FillState(const Point<T, Container>&, IterationState<T, Container>& state) const
+{
+    state.value = value;
+    state.gradientNorm = Norm(gradient);
+    state.hasGradient = true;
+}
+
+template <typename T, class Container>
+T NewtonOptimization<T, Container>::FreeCoordinates(const Point<T, Container>& point)
+{
+    T norm{};
+    freeMask = point;
+
+    for (size_t i{}; i < point.size(); ++i)
+    {
+        const bool fixed = (point[i] <= this->area.minArea[i] && gradient[i] > 0) || (point[i] >= this->area.maxArea[i] && gradient[i] < 0);
+
+        freeMask[i] = fixed ? T{} : static_cast<T>(1);
+
+        if (!fixed)
+            norm += gradient[i] * gradient[i];
+    }
+
+    return std::sqrt(norm);
+}
+
+template <typename T, class Container>
+void NewtonOptimization<T, Container>::Product(const Point<T, Container>& point, const Point<T, Container>& v, Point<T, Container>& result)
+{
+    this->f->HessianVectorProduct(point, v, result);
+
+    for (size_t i{}; i < result.size(); ++i)
+        result[i] *= freeMask[i];
+}
+
+template <typename T, class Container>
+T NewtonOptimization<T, Container>::MaxStep(const Point<T, Container>& point, const Point<T, Container>& s, const Point<T, Container>& d) const
+{
+    const T dd = d * d, sd = s * d, ss = s * s;
+
+    if (!dd)
+        return T{};
+
+    // Positive root of |s + tau * d| = radius.
+    T res = (-sd + std::sqrt(std::max(T{}, sd * sd + dd * (radius * radius - ss)))) / dd;
+
+    for (size_t i{}; i < d.size(); ++i)
+        if (d[i] > 0)
+            res = std::min(res, std::max(T{}, (this->area.maxArea[i] - point[i] - s[i]) / d[i]));
+        else if (d[i] < 0)
+            res = std::min(res, std::max(T{}, (this->area.minArea[i] - point[i] - s[i]) / d[i]));
+
+    return res;
+}
+
+template <typename T, class Container>
+T NewtonOptimization<T, Container>::Steihaug(const Point<T, Container>& point, const T& gradientNorm)
+{
+    const size_t limit = maxInner ? maxInner : point.size();
+    const T target = std::min(tolerance, std::sqrt(gradientNorm)) * gradientNorm;
+
+    step = point;
+    step.Fill(T{});
+    stepProduct = step;
+    residual = point;
+
+    for (size_t i{}; i < point.size(); ++i)
+        residual[i] = -gradient[i] * freeMask[i];
+
+    direction = residual;
+    T rr = residual * residual;
+
+    for (size_t k{}; k < limit; ++k)
+    {
+        Product(point, direction, product);
+
+        const T curvature = direction * product, boundary = MaxStep(point, step, direction);
+
+        // On a direction of negative curvature or beyond the boundary the model decreases up to the boundary.
+        if (curvature <= 0 || rr / curvature >= boundary)
+        {
+            step = step + boundary * direction;
+            stepProduct = stepProduct + boundary * product;
+
+            break;
+        }
+
+        const T alpha = rr / curvature;
+
+        step = step + alpha * direction;
+        stepProduct = stepProduct + alpha * product;
+        residual = residual + (-alpha) * product;
+
+        const T rrNext = residual * residual;
+
+        if (std::sqrt(rrNext) <= target)
+            break;
+
+        direction = residual + (rrNext / rr) * direction;
+        rr = rrNext;
+    }
+
+    return -(gradient * step + static_cast<T>(0.5) * (step * stepProduct));
+}
+
+template <typename T, class Container>
+Point<T, Container> NewtonOptimization<T, Container>::NextPoint(const Point<T, Container>& point)
+{
+    const T gradientNorm = FreeCoordinates(point);
+
+    if (!gradientNorm)
+        return point;
+
+    for (size_t attempt{}; attempt < MAXATTEMPT; ++attempt)
+    {
+        const T predicted = Steihaug(point, gradientNorm), stepNorm = std::sqrt(step * step);
+
+        if (predicted <= 0 || !stepNorm)
+        {
+            radius /= 4;
+
+            continue;
+        }
+
+        trial = point + step;
+
+        // Rounding must not move the point outside the area.
+        for (size_t i{}; i < trial.size(); ++i)
+            trial[i] = std::clamp(trial[i], this->area.minArea[i], this->area.maxArea[i]);
+
+        const T trialValue = this->f->ValueAndGradient(trial, nextGradient), ratio = (value - trialValue) / predicted;
+
+        if (ratio < static_cast<T>(0.25))
+            radius = static_cast<T>(0.25) * stepNorm;
+        else if (ratio > static_cast<T>(0.75) && stepNorm >= static_cast<T>(0.99) * radius)
+            radius *= 2;
+
+        if (ratio > ETA)
+        {
+            value = trialValue;
+            std::swap(gradient, nextGradient);
+
+            return trial;
+        }
+    }
+
+    return point;
+}
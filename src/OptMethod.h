@@ -3,37 +3,115 @@
 /// @details File contains the definition of template classes of the Conjugate Vector Method and the Stochastic Method.
 #pragma once
 
+#include <chrono>
+#include <span>
+#include "LineSearch.h"
 #include "Optimization.h"
+#include "ThreadPool.h"
 
 /// @brief Class of the Conjugate Vector Method.
 /// @tparam T Typename for a value of a function.
-template <typename T>
-class DetermOptimization : public Optimization<T>
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class DetermOptimization : public Optimization<T, Container>
 {
 private:
     T beta;
     T epsilon;
     T epsilonStep;
-    Point<T> conjugateVector;
+    LineSearchMode lineSearch;
+    Point<T, Container> conjugateVector;
+    /// @brief Point and gradient of the line search. Their storage is reused by all evaluations.
+    Point<T, Container> linePoint;
+    Point<T, Container> lineGradient;
+    /// @brief Step and derivative along the vector of the last iteration. They give the initial step of local line searches.
+    T lastAlpha;
+    T lastSlope;
+    /// @brief Value and gradient at the last point of the pathway and gradient at the next point.
+    /// They are computed once and reused by the next iteration.
+    T value;
+    Point<T, Container> gradient;
+    Point<T, Container> nextGradient;
+    /// @brief Slice of the scan: its borders, the value at the left golden point and whether the slice has no probes yet.
+    struct Slice
+    {
+        T left;
+        T right;
+        T valueLeft;
+        bool first;
+    };
+
+    /// @brief Storage of the batched scan, it is reused by all iterations.
+    std::vector<Slice> slices;
+    std::vector<T> sliceArgs;
+    std::vector<T> sliceValues;
+    /// @brief Block of points of the line as a structure of arrays and pointers to its coordinates, one set per chunk.
+    std::vector<T> lineBlock;
+    std::vector<const T*> lineCoords;
+    /// @brief Pool which evaluates chunks of a block. Without it the block is evaluated by the calling thread.
+    ThreadPool* pool = nullptr;
+    /// @brief Estimated time of one probe in nanoseconds, measured on the last block. Zero before the first block of a run.
+    double probeTime = 0;
+    /// @brief Minimum estimated time of a chunk in nanoseconds, which pays for its dispatch to the pool.
+    static constexpr double MINCHUNKTIME = 20000;
     /// @brief Golden ratio. Calculate: (1 + \sqrt(5))/2.
     static constexpr T PHI = static_cast<T>(1.6180339887);
 
-    /// @brief One dimensional optimization.
-    /// @param argMin Left border.
-    /// @param argMax Right border.
-    /// @param res Value of minimum.
-    /// @param oneF Function.
-    /// @return Point of minimum.
-    T OneDimensionalOptim(const T& argMin, const T& argMax, T& res, std::function<T(const T&)> oneF);
-
     /// @brief The alpha of the intersection of the boundary and the vector.
     /// @param point Start point.
     /// @param conjugateVector Vector.
     /// @return Min alpha.
-    T MinAlpha(const Point<T>& point, const Point<T>& conjugateVector);
+    T MinAlpha(const Point<T, Container>& point, const Point<T, Container>& conjugateVector);
 protected:
-    Point<T> NextPoint(const Point<T>& point) override;
-    void SetStart(const Point<T>& startPoint) override;
+    Point<T, Container> NextPoint(const Point<T, Container>& point) override;
+    void SetStart(const Point<T, Container>& startPoint) override;
+    void FillState(const Point<T, Container>& point, IterationState<T, Container>& state) const override;
+
+    /// @brief One dimensional optimization with probes evaluated in blocks.
+    /// @details The segment is split into slices of the relative length epsilonStep, and the minimum of every slice
+    /// is searched by the golden section until the slice is shorter than the relative epsilon. The searches of all slices
+    /// run in lockstep: a round takes one probe of every slice which is not finished (two in the first round)
+    /// and evaluates them by one call. The minimum is chosen in order of slices, so the result does not depend
+    /// on the evaluation of a block.
+    /// @param argMin Left border.
+    /// @param argMax Right border.
+    /// @param valueMin Value of function at the left border.
+    /// @param res Point of minimum.
+    /// @param blockF Function of a block: void blockF(std::span<const T> args, std::span<T> values).
+    /// @return Value of minimum.
+    template <class BlockF>
+    T OneDimensionalOptimBlock(const T& argMin, const T& argMax, const T& valueMin, T& res, const BlockF& blockF);
+
+    /// @brief Values of the function at points of the line from the point along the conjugate vector.
+    /// @details An evaluator with ValueBatch gets the points as blocks, chunks of the block are evaluated on the pool.
+    /// The count of chunks follows the estimated time of the block, so a block of few expensive probes is split
+    /// and a block of many cheap ones is not. Other evaluators get the points one by one in the calling thread.
+    /// @param function Evaluator of the function.
+    /// @param point Point of the line at zero.
+    /// @param args Steps along the vector.
+    /// @param values Values.
+    template <class Function>
+    void LineValues(const Function& function, const Point<T, Container>& point, std::span<const T> args, std::span<T> values);
+
+    /// @brief Local line search from the point along the conjugate vector.
+    /// @details If the vector is not a descent direction, the method restarts with the antigradient.
+    /// @param function Evaluator of the function.
+    /// @param point Last point.
+    /// @return Step. If it is the last probe of the strong Wolfe search, lineGradient is the gradient at it.
+    template <class Function>
+    LineStep<T> LocalLineSearch(const Function& function, const Point<T, Container>& point);
+
+    /// @brief Iteration of the method with a given evaluator of the function.
+    /// @details The evaluator has members Value and ValueAndGradient. NextPoint passes the virtual interface,
+    /// StaticDetermOptimization passes formulas of a concrete function, which are called without virtual dispatch.
+    /// @param function Evaluator of the function.
+    /// @param point Last point.
+    /// @return Next point.
+    template <class Function>
+    Point<T, Container> NextPointWith(const Function& function, const Point<T, Container>& point);
+
+    template <class Function>
+    void SetStartWith(const Function& function, const Point<T, Container>& startPoint);
 
     /// @brief It checked correct of field.
     void CorrectField() override;
@@ -43,13 +121,23 @@ public:
     /// @param[in] _stopIteration Stopper for stoping.
     /// @param[in] _epsilon Condition of stopping for one dimension optimization.
     /// @param[in] _epsilonStep Step width in one dimension optimization.
-    DetermOptimization(GeneralFunction<T>& _f, GeneralStop<T>& _stopIteration, const T& _epsilon, const T& _epsilonStep);
+    /// The local searches start from this part of the segment in the first iteration.
+    /// @param[in] _lineSearch Search along the conjugate vector.
+    DetermOptimization(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration, const T& _epsilon, const T& _epsilonStep,
+                       LineSearchMode _lineSearch = LineSearchMode::Brent);
 
-    void SetParam(GeneralFunction<T>& _f, GeneralStop<T>& _stopIteration, const T& _epsilon, const T& _epsilonStep);
+    void SetParam(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration, const T& _epsilon, const T& _epsilonStep,
+                  LineSearchMode _lineSearch = LineSearchMode::Brent);
+
+    inline LineSearchMode getLineSearch() const { return lineSearch; }
+
+    /// @brief Sets the pool for blocks of the scan. The function must be thread-safe.
+    /// @param _pool Pool. If it is nullptr, blocks are evaluated by the calling thread.
+    void SetPool(ThreadPool* _pool) { pool = _pool; }
 };
 
-template <typename T>
-void DetermOptimization<T>::CorrectField()
+template <typename T, class Container>
+void DetermOptimization<T, Container>::CorrectField()
 {
     if (epsilon <= 0)
         throw std::invalid_argument("Epsilon must be greater than zero.");
@@ -58,90 +146,181 @@ void DetermOptimization<T>::CorrectField()
         throw std::invalid_argument("Step must be greater than zero.");
 }
 
-template <typename T>
-DetermOptimization<T>::DetermOptimization(GeneralFunction<T>& _f, GeneralStop<T>& _stopIteration, const T& _epsilon, const T& _epsilonStep)
-    : Optimization<T>(_f, _stopIteration), epsilon(_epsilon), epsilonStep(_epsilonStep)
+template <typename T, class Container>
+DetermOptimization<T, Container>::DetermOptimization(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration, const T& _epsilon, const T& _epsilonStep,
+                                                     LineSearchMode _lineSearch)
+    : Optimization<T, Container>(_f, _stopIteration), epsilon(_epsilon), epsilonStep(_epsilonStep), lineSearch(_lineSearch)
 {
     CorrectField();
 }
 
-template <typename T>
-void DetermOptimization<T>::SetParam(GeneralFunction<T>& _f, GeneralStop<T>& _stopIteration, const T& _epsilon, const T& _epsilonStep)
+template <typename T, class Container>
+void DetermOptimization<T, Container>::SetParam(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration, const T& _epsilon, const T& _epsilonStep,
+                                                LineSearchMode _lineSearch)
 {
-    Optimization<T>::SetParam(_f, _stopIteration);
+    Optimization<T, Container>::SetParam(_f, _stopIteration);
     epsilon = _epsilon;
     epsilonStep = _epsilonStep;
+    lineSearch = _lineSearch;
 
     CorrectField();
 }
 
-template <typename T>
-T DetermOptimization<T>::OneDimensionalOptim(const T& argMin, const T& argMax, T& res, std::function<T(const T&)> oneF)
+template <typename T, class Container>
+template <class BlockF>
+T DetermOptimization<T, Container>::OneDimensionalOptimBlock(const T& argMin, const T& argMax, const T& valueMin, T& res, const BlockF& blockF)
 {
     if (argMin >= argMax)
         return argMin;
 
-    enum Edge { left, right, nothing } lastEdge;
-    T valueLeft, valueRight, leftEdge, rightEdge, leftSetEdge, rightSetEdge, minValue = oneF(argMin), middle, value;
+    T minValue = valueMin;
     T epsilonOne = this->epsilon * (argMax - argMin), epsilonStepOne = epsilonStep * (argMax - argMin);
     res = (argMin + epsilonOne) / 2;
 
+    slices.clear();
+
     for (T i = argMin; i + epsilonStepOne <= argMax; i = i + epsilonStepOne)
+        slices.push_back({i, i + epsilonStepOne, T{}, true});
+
+    for (;;)
     {
-        leftEdge = i, rightEdge = i + epsilonStepOne;
-        lastEdge = nothing;
+        sliceArgs.clear();
 
-        while (rightEdge - leftEdge > epsilonOne)
-        {
-            leftSetEdge = rightEdge - (rightEdge - leftEdge) / PHI;
-            rightSetEdge = leftEdge + (rightEdge - leftEdge) / PHI;
+        for (const Slice& slice : slices)
+            if (slice.right - slice.left > epsilonOne)
+            {
+                if (slice.first)
+                    sliceArgs.push_back(slice.left + (slice.right - slice.left) / PHI);
+
+                sliceArgs.push_back(slice.right - (slice.right - slice.left) / PHI);
+            }
+
+        if (sliceArgs.empty())
+            break;
+
+        sliceValues.resize(sliceArgs.size());
+        blockF(std::span<const T>(sliceArgs), std::span<T>(sliceValues));
+
+        // The value at the left golden point of the last round is taken as the value at the right one.
+        size_t k{};
 
-            switch (lastEdge)
+        for (Slice& slice : slices)
+            if (slice.right - slice.left > epsilonOne)
             {
-            case nothing:
-                valueLeft = oneF(rightSetEdge);
-            case left:
-                valueRight = valueLeft;
-                valueLeft = oneF(leftSetEdge);
-
-                lastEdge = right;
-                break;
-            
-            case right:
-                valueRight = valueLeft;
-                valueLeft = oneF(leftSetEdge);
-
-                lastEdge = left;
-                break;
+                const T leftSetEdge = slice.right - (slice.right - slice.left) / PHI;
+                const T rightSetEdge = slice.left + (slice.right - slice.left) / PHI;
+                const T valueRight = slice.first ? sliceValues[k++] : slice.valueLeft;
+
+                slice.valueLeft = sliceValues[k++];
+                slice.first = false;
+
+                if (slice.valueLeft < valueRight)
+                    slice.right = rightSetEdge;
+                else
+                    slice.left = leftSetEdge;
             }
+    }
 
-            if (valueLeft < valueRight)
-                rightEdge = rightSetEdge;
-            else
-                leftEdge = leftSetEdge;
+    sliceArgs.clear();
+
+    for (const Slice& slice : slices)
+        sliceArgs.push_back((slice.left + slice.right) / 2);
+
+    sliceValues.resize(sliceArgs.size());
+    blockF(std::span<const T>(sliceArgs), std::span<T>(sliceValues));
+
+    for (size_t i{}; i < slices.size(); ++i)
+        if (sliceValues[i] < minValue)
+        {
+            minValue = sliceValues[i];
+            res = sliceArgs[i];
         }
 
-        middle = (leftEdge + rightEdge) / 2;
-        value = oneF(middle);
+    return minValue;
+}
+
+template <typename T, class Container>
+template <class Function>
+void DetermOptimization<T, Container>::LineValues(const Function& function, const Point<T, Container>& p, std::span<const T> args, std::span<T> values)
+{
+    if constexpr (requires { function.ValueBatch(std::span<const T* const>(), values); })
+    {
+        const size_t dim = p.size(), count = args.size();
+
+        if (!count)
+            return;
+
+        const size_t chunks = pool ? std::clamp<size_t>(static_cast<size_t>(probeTime * static_cast<double>(count) / MINCHUNKTIME), 1,
+                                                        std::min(pool->getSize(), count))
+                                   : 1;
+        const size_t chunkSize = (count + chunks - 1) / chunks;
+
+        lineBlock.resize(dim * count);
+        lineCoords.resize(dim * chunks);
 
-        if (value < minValue)
+        for (size_t c{}; c < chunks; ++c)
+            for (size_t j{}; j < dim; ++j)
+                lineCoords[c * dim + j] = lineBlock.data() + j * count + std::min(count, c * chunkSize);
+
+        const auto evaluate = [this, &function, &p, args, values, dim, count, chunkSize](size_t c)
         {
-            minValue = value;
-            res = middle;
+            const size_t begin = std::min(count, c * chunkSize), end = std::min(count, begin + chunkSize);
+
+            for (size_t j{}; j < dim; ++j)
+                for (size_t i = begin; i < end; ++i)
+                    lineBlock[j * count + i] = p[j] + args[i] * conjugateVector[j];
+
+            function.ValueBatch(std::span<const T* const>(lineCoords.data() + c * dim, dim), values.subspan(begin, end - begin));
+        };
+
+        const auto begin = std::chrono::steady_clock::now();
+
+        if (chunks > 1)
+            pool->ParallelFor(chunks, evaluate);
+        else
+            evaluate(0);
+
+        if (pool)
+        {
+            // Chunks run at the same time, so the block takes about the time of one chunk.
+            const std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - begin;
+            probeTime = time.count() * static_cast<double>(chunks) / static_cast<double>(count);
         }
     }
+    else
+        for (size_t i{}; i < args.size(); ++i)
+        {
+            linePoint = p + args[i] * conjugateVector;
+            values[i] = function.Value(linePoint);
+        }
+}
 
-    return minValue;
+template <typename T, class Container>
+void DetermOptimization<T, Container>::SetStart(const Point<T, Container>& startPoint)
+{
+    SetStartWith(*this->f, startPoint);
+}
+
+template <typename T, class Container>
+template <class Function>
+void DetermOptimization<T, Container>::SetStartWith(const Function& function, const Point<T, Container>& startPoint)
+{
+    value = function.ValueAndGradient(startPoint, gradient);
+    conjugateVector = -gradient;
+    lastAlpha = 0;
+    probeTime = 0;
 }
 
-template <typename T>
-void DetermOptimization<T>::SetStart(const Point<T>& startPoint)
+template <typename T, class Container>
+void DetermOptimization<T, Container>::FillState(const Point<T, Container>&, IterationState<T, Container>& state) const
 {
-    conjugateVector = -this->f->Gradient(startPoint);
+    state.value = value;
+    state.gradientNorm = Norm(gradient);
+    state.hasGradient = true;
 }
 
-template <typename T>
-T DetermOptimization<T>::MinAlpha(const Point<T>& point, const Point<T>& conjugateVector)
+template <typename T, class Container>
+T DetermOptimization<T, Container>::MinAlpha(const Point<T, Container>& point, const Point<T, Container>& conjugateVector)
 {
     bool flag = true;
     T minAlpha{};
@@ -166,29 +345,117 @@ T DetermOptimization<T>::MinAlpha(const Point<T>& point, const Point<T>& conjuga
     return minAlpha;
 }
 
-template <typename T>
-Point<T> DetermOptimization<T>::NextPoint(const Point<T>& p)
+template <typename T, class Container>
+template <class Function>
+LineStep<T> DetermOptimization<T, Container>::LocalLineSearch(const Function& function, const Point<T, Container>& p)
 {
-    T alpha;
-    Point<T> nextP;
+    T slope = gradient * conjugateVector;
+
+    if (slope >= 0)
+    {
+        conjugateVector = -gradient;
+        slope = -(gradient * gradient);
+        lastAlpha = 0;
+    }
+
+    const T maxAlpha = MinAlpha(p, conjugateVector), tolerance = epsilon * maxAlpha;
+    // The first step is a part of the segment, the next steps keep the decrease of the previous iteration: alpha * slope.
+    const T initial = lastAlpha > 0 ? lastAlpha * lastSlope / slope : epsilonStep * maxAlpha;
+    LineStep<T> step{T{}, value};
+
+    const auto phi = [this, &p, &function](const T al)
+    {
+        this->linePoint = p + al * this->conjugateVector;
+
+        return function.Value(this->linePoint);
+    };
+
+    switch (lineSearch)
+    {
+    case LineSearchMode::Brent:
+        step = BrentSearch(phi, value, initial, maxAlpha, tolerance);
+        break;
+
+    case LineSearchMode::StrongWolfe:
+        step = StrongWolfeSearch([this, &p, &function](const T al, T& derivative)
+        {
+            this->linePoint = p + al * this->conjugateVector;
+
+            const T res = function.ValueAndGradient(this->linePoint, this->lineGradient);
+            derivative = this->lineGradient * this->conjugateVector;
+
+            return res;
+        }, value, slope, initial, maxAlpha, tolerance);
+        break;
+
+    case LineSearchMode::Armijo:
+        step = ArmijoSearch(phi, value, slope, initial, maxAlpha, tolerance);
+        break;
+
+    default:
+        break;
+    }
+
+    lastAlpha = step.alpha;
+    lastSlope = slope;
+
+    return step;
+}
+
+template <typename T, class Container>
+Point<T, Container> DetermOptimization<T, Container>::NextPoint(const Point<T, Container>& p)
+{
+    return NextPointWith(*this->f, p);
+}
+
+template <typename T, class Container>
+template <class Function>
+Point<T, Container> DetermOptimization<T, Container>::NextPointWith(const Function& function, const Point<T, Container>& p)
+{
+    T alpha{};
+    Point<T, Container> nextP;
 
 #ifdef DEBUG_DO
     std::cout << std::endl << "Point: " << p << std::endl;
     std::cout << "Conjugate Vector: " << conjugateVector << std::endl;
 #endif
-    OneDimensionalOptim({}, MinAlpha(p, conjugateVector), alpha, [this, &p](const T al)
+    LineStep<T> step{};
+
+    if (lineSearch == LineSearchMode::Scan)
+        OneDimensionalOptimBlock({}, MinAlpha(p, conjugateVector), value, alpha, [this, &p, &function](std::span<const T> args, std::span<T> values)
+        {
+            LineValues(function, p, args, values);
+        });
+    else
     {
-        return this->f->Value(p + al * this->conjugateVector);
-    });
+        step = LocalLineSearch(function, p);
+        alpha = step.alpha;
+    }
 
     nextP = p + alpha * conjugateVector;
-    
-    if (this->f->Gradient(p) * this->f->Gradient(p))
-        beta = (this->f->Gradient(nextP) * (this->f->Gradient(nextP) + (-this->f->Gradient(p)))) / (this->f->Gradient(p) * this->f->Gradient(p));
+
+    // The gradient at p was computed by the previous iteration, only the next point is evaluated.
+    // The strong Wolfe search has evaluated it already.
+    T nextValue;
+
+    if (step.last)
+    {
+        nextValue = step.value;
+        std::swap(nextGradient, lineGradient);
+    }
+    else
+        nextValue = function.ValueAndGradient(nextP, nextGradient);
+    const T gradientNorm = gradient * gradient;
+
+    // Polak-Ribiere: g1 * (g1 - g0) is expanded into two dot products, so every term is a single kernel call.
+    if (gradientNorm)
+        beta = (nextGradient * nextGradient - nextGradient * gradient) / gradientNorm;
     else
         beta = 0;
 
-    conjugateVector = (-this->f->Gradient(nextP)) + beta * conjugateVector;
+    conjugateVector = (-nextGradient) + beta * conjugateVector;
+    std::swap(gradient, nextGradient);
+    value = nextValue;
 
     return nextP;
 }
@@ -196,31 +463,38 @@ Point<T> DetermOptimization<T>::NextPoint(const Point<T>& p)
 
 /// @brief Class of the Stochastic Method.
 /// @tparam T Typename for a value of a function.
-template <typename T>
-class StochastOptimization : public Optimization<T>
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class StochastOptimization : public Optimization<T, Container>
 {
 private:
     T delta;
     T deltaStart;
     T probability;
     T alpha;
+    /// @brief Value at the last point of the pathway.
+    T value;
     std::mt19937 generator;
     std::uniform_real_distribution<T> distr;
-    CubicArea<T> sphereArea;
+    CubicArea<T, Container> sphereArea;
+    /// @brief Candidate point and the delta neighborhood. Their storage is reused by all iterations.
+    Point<T, Container> nextPointHelp;
+    Point<T, Container> deltaPoint;
 
     /// @brief Generates new point in the area.
     /// @param nextPointHelp Point.
     /// @param start Minimum of area.
     /// @param end Maximum of area.
-    void NewStochPoint(Point<T>& nextPointHelp, const Point<T>& start, const Point<T>& end);
+    void NewStochPoint(Point<T, Container>& nextPointHelp, const Point<T, Container>& start, const Point<T, Container>& end);
 
     /// @brief Intersection of two parallelepiped areas.
     /// @param _sphereArea Area 1. The result will be recorded here.
     /// @param _area Area 2.
-    void IntersectionArea(CubicArea<T>& _sphereArea, const CubicArea<T>& _area);
+    void IntersectionArea(CubicArea<T, Container>& _sphereArea, const CubicArea<T, Container>& _area);
 protected:
-    Point<T> NextPoint(const Point<T>& point) override;
-    void SetStart(const Point<T>& startPoint) override;
+    Point<T, Container> NextPoint(const Point<T, Container>& point) override;
+    void SetStart(const Point<T, Container>& startPoint) override;
+    void FillState(const Point<T, Container>&, IterationState<T, Container>& state) const override { state.value = value; }
 
     /// @brief It checked correct of field.
     void CorrectField() override;
@@ -232,15 +506,17 @@ public:
     /// @param[in] _delta Width of the delta neighborhood.
     /// @param _seed Seed for a generator.
     /// @param[in] _alpha Сoefficient of narrowing of the delta neighborhood.
-    StochastOptimization(GeneralFunction<T>& _f, GeneralStop<T>& _stopIteration, const T& _probability, const T& _delta,
+    StochastOptimization(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration, const T& _probability, const T& _delta,
                          size_t _seed = 0, const T& _alpha = static_cast<T>(1));
 
-    void SetParam(GeneralFunction<T>& _f, GeneralStop<T>& _stopIteration, const T& _probability, const T& _delta,
+    void SetParam(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration, const T& _probability, const T& _delta,
                   size_t _seed = 0, const T& _alpha = static_cast<T>(1));
+
+    void SetSeed(size_t seed) override { generator.seed(seed); }
 };
 
-template <typename T>
-void StochastOptimization<T>::CorrectField()
+template <typename T, class Container>
+void StochastOptimization<T, Container>::CorrectField()
 {
     if (delta <= 0)
         throw std::invalid_argument("Delta must be greater than zero.");
@@ -252,21 +528,22 @@ void StochastOptimization<T>::CorrectField()
         throw std::invalid_argument("Probability must be greater than zero and less or equal than 1.");
 }
 
-template <typename T>
-StochastOptimization<T>::StochastOptimization(GeneralFunction<T>& _f, GeneralStop<T>& _stopIteration, const T& _probability, const T& _delta,
-                                              size_t _seed, const T& _alpha) : Optimization<T>(_f, _stopIteration), delta(_delta), deltaStart(_delta),
+template <typename T, class Container>
+StochastOptimization<T, Container>::StochastOptimization(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration, const T& _probability, const T& _delta,
+                                              size_t _seed, const T& _alpha) : Optimization<T, Container>(_f, _stopIteration), delta(_delta), deltaStart(_delta),
                                                                                probability(_probability), alpha(_alpha), generator(_seed),
                                                                                distr(static_cast<T>(0), static_cast<T>(1))
 {
     CorrectField();
 }
 
-template <typename T>
-void StochastOptimization<T>::SetParam(GeneralFunction<T>& _f, GeneralStop<T>& _stopIteration, const T& _probability, const T& _delta,
+template <typename T, class Container>
+void StochastOptimization<T, Container>::SetParam(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration, const T& _probability, const T& _delta,
                                        size_t _seed, const T& _alpha)
 {
-    Optimization<T>::SetParam(_f, _stopIteration);
+    Optimization<T, Container>::SetParam(_f, _stopIteration);
     delta = _delta;
+    deltaStart = _delta;
     probability = _probability;
     alpha = _alpha;
     generator.seed(_seed);
@@ -274,14 +551,15 @@ void StochastOptimization<T>::SetParam(GeneralFunction<T>& _f, GeneralStop<T>& _
     CorrectField();
 }
 
-template <typename T>
-void StochastOptimization<T>::SetStart(const Point<T>&)
+template <typename T, class Container>
+void StochastOptimization<T, Container>::SetStart(const Point<T, Container>& startPoint)
 {
-
+    delta = deltaStart;
+    value = this->f->Value(startPoint);
 }
 
-template <typename T>
-void StochastOptimization<T>::NewStochPoint(Point<T>& nextPointHelp, const Point<T>& start, const Point<T>& end)
+template <typename T, class Container>
+void StochastOptimization<T, Container>::NewStochPoint(Point<T, Container>& nextPointHelp, const Point<T, Container>& start, const Point<T, Container>& end)
 {
     for (size_t i{}; i < nextPointHelp.size(); ++i)
     {
@@ -291,8 +569,8 @@ void StochastOptimization<T>::NewStochPoint(Point<T>& nextPointHelp, const Point
     }
 }
 
-template <typename T>
-void StochastOptimization<T>::IntersectionArea(CubicArea<T>& _sphereArea, const CubicArea<T>& _area)
+template <typename T, class Container>
+void StochastOptimization<T, Container>::IntersectionArea(CubicArea<T, Container>& _sphereArea, const CubicArea<T, Container>& _area)
 {
     for (size_t i{}; i < _sphereArea.minArea.size(); ++i)
     {
@@ -301,12 +579,14 @@ void StochastOptimization<T>::IntersectionArea(CubicArea<T>& _sphereArea, const
     }
 }
 
-template <typename T>
-Point<T> StochastOptimization<T>::NextPoint(const Point<T>& point)
+template <typename T, class Container>
+Point<T, Container> StochastOptimization<T, Container>::NextPoint(const Point<T, Container>& point)
 {
-    Point<T> nextPointHelp = point;
-    sphereArea.minArea = point + (-Point<T>(std::vector<T>(point.size(), delta)));
-    sphereArea.maxArea = point + Point<T>(std::vector<T>(point.size(), delta));
+    nextPointHelp = point;
+    deltaPoint = point;
+    deltaPoint.Fill(delta);
+    sphereArea.minArea = point + (-deltaPoint);
+    sphereArea.maxArea = point + deltaPoint;
     IntersectionArea(sphereArea, this->area);
 
     if (distr(generator) < probability)
@@ -314,7 +594,9 @@ Point<T> StochastOptimization<T>::NextPoint(const Point<T>& point)
     else
         NewStochPoint(nextPointHelp, this->area.minArea, this->area.maxArea);
 
-    if (this->f->Value(nextPointHelp) >= this->f->Value(point))
+    const T nextValue = this->f->Value(nextPointHelp);
+
+    if (nextValue >= value)
     {
         delta = deltaStart;
 
@@ -323,7 +605,8 @@ Point<T> StochastOptimization<T>::NextPoint(const Point<T>& point)
     else
     {
         delta = delta * alpha;
-        
+        value = nextValue;
+
         return nextPointHelp;
     }
 }
@@ -3,8 +3,9 @@
 /// @date 02.11.2023
 
 /// @file
-/// @brief Abstract classes for optimization methods, functions and stoppers.
-/// @details File contains the definition of abstract classes for optimization methods, functions and stoppers.
+/// @brief Abstract classes for optimization methods and stoppers.
+/// @details File contains the definition of abstract classes for optimization methods and stoppers,
+/// the abstract class for functions is in GeneralFunction.h.
 /// For using them you need to use inheritance. You cannot use them by themselves.
 #pragma once
 
@@ -15,12 +16,43 @@
 #include <chrono>
 #include <random>
 #include "Point.h"
+#include "Pathway.h"
+#include "GeneralFunction.h"
+#include "CachedFunction.h"
+#include "InstrumentedFunction.h"
 
 static const size_t MAXSTEP = 100;
 
+/// @brief State of an iteration which an optimization passes to the stopper.
+/// @tparam T Typename for a value of a function.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+struct IterationState
+{
+    /// @brief Count of points in the pathway including the new point.
+    size_t iteration = 0;
+    /// @brief New point. It is a view of the last point of the pathway.
+    PointView<T, Container> point{nullptr, 0};
+    /// @brief Value of the function in the new point. Methods remember it, so it costs no evaluation.
+    T value{};
+    /// @brief Norm of the gradient in the new point. It is set only if hasGradient is true.
+    T gradientNorm{};
+    bool hasGradient = false;
+    /// @brief Distance between the new point and the previous one. Zero for the start point.
+    T stepLength{};
+    /// @brief Time since the start of the run in nanoseconds.
+    double elapsed = 0;
+    /// @brief Count of points evaluated by the function since the start of the run. Cache hits are not counted.
+    size_t evaluations = 0;
+};
+
 /// @brief Abstract class for stoppers.
+/// @details The stopper is called once per point of the pathway, beginning with the start point.
+/// It keeps running aggregates of states instead of reading the pathway, so every decision takes O(1) time
+/// and does not evaluate the function.
 /// @tparam T Typename for a value of a function.
-template <typename T>
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
 class GeneralStop
 {
 protected:
@@ -29,32 +61,19 @@ public:
     /// @brief Default constructor.
     GeneralStop(size_t _maxStep = MAXSTEP) : maxStep(_maxStep) {};
 
-    /// @brief Function of a condition for stoping.
-    /// @param[in] pathway Pathway of a optimization.
-    /// @return Result of a condition.
-    virtual bool condition(const std::vector<Point<T>>& pathway) const = 0;
+    /// @brief Resets running aggregates. It is called before the start point of every run.
+    virtual void Reset() {}
 
-    /// @brief Virtual destructor.
-    virtual ~GeneralStop() {}
-};
-
-/// @brief Abstract class for function.
-/// @tparam T Typename for a value of a function.
-template <typename T>
-class GeneralFunction
-{
-public:
-    /// @brief Default constructor.
-    GeneralFunction() = default;
+    /// @brief Function of a condition for stoping.
+    /// @param[in] state State of the last iteration.
+    /// @return True if the optimization must continue.
+    virtual bool condition(const IterationState<T, Container>& state) = 0;
 
-    /// @brief Function culculated a value of function.
-    /// @param[in] _ Point of a argument of a function.
-    /// @return Value of a function.
-    virtual T Value(const Point<T>&) const = 0;
-    virtual Point<T> Gradient(const Point<T>&) const = 0;
+    /// @brief Maximum count of a step of iteration. Combinations and wrappers compute it from their stoppers.
+    virtual size_t getMaxStep() const { return maxStep; }
 
     /// @brief Virtual destructor.
-    virtual ~GeneralFunction() {}
+    virtual ~GeneralStop() {}
 };
 
 /// @brief Struct for functions.
@@ -71,35 +90,81 @@ struct FunctionData
 
 /// @brief Struct of a area for optimization.
 /// @tparam T Typename of a point's coordinate.
-template <typename T>
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
 struct CubicArea
 {
     /// @brief Minimum point of a area.
-    Point<T> minArea;
+    Point<T, Container> minArea;
     
     /// @brief Maximum point of a area.
-    Point<T> maxArea;
+    Point<T, Container> maxArea;
 };
 
-/// @brief Abstract class for optimization methods.
+/// @brief Summary of a run of an optimization method.
 /// @tparam T Typename for a value of a function.
 template <typename T>
+struct RunSummary
+{
+    /// @brief Count of points in the pathway.
+    size_t iterations = 0;
+    size_t dimension = 0;
+    /// @brief Values of the function in the start and in the last point.
+    T valueStart{};
+    T valueEnd{};
+    /// @brief Wall time of the run in nanoseconds.
+    double time = 0;
+    /// @brief Statistics of calls of the function by kinds, in order of FunctionCall.
+    std::array<CallStats, 6> calls{};
+    /// @brief Count of points evaluated by all kinds of calls.
+    size_t evaluations = 0;
+    size_t cacheHits = 0;
+
+    /// @brief Decrease of the function per evaluated point: the progress which a method gets for its cost.
+    T DecreasePerEvaluation() const { return evaluations ? (valueStart - valueEnd) / static_cast<T>(evaluations) : T{}; }
+};
+
+/// @brief Abstract class for optimization methods.
+/// @tparam T Typename for a value of a function.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
 class Optimization
 {
 private:
-    GeneralStop<T>* stopIteration;
-    Point<T> nowPoint;
-    std::vector<Point<T>> pathway;
+    GeneralStop<T, Container>* stopIteration;
+    Point<T, Container> nowPoint;
+    Pathway<T, Container> pathway;
+    InstrumentedFunction<T, Container> instrument;
+    CachedFunction<T, Container> cache;
+    bool instrumented;
+    double time;
+    size_t hitsStart;
+    /// @brief Values of the function in the first and in the last point of the pathway, remembered by PushPoint.
+    T valueFirst;
+    T valueLast;
+
+    /// @brief Points f to the cache, the instrument or the function itself.
+    void Wire();
+
+    /// @brief Appends the current point to the pathway and updates the state of the iteration except the step length.
+    void PushPoint(IterationState<T, Container>& state, std::chrono::steady_clock::time_point begin);
 protected:
-    CubicArea<T> area;
-    GeneralFunction<T>* f;
+    CubicArea<T, Container> area;
+    GeneralFunction<T, Container>* f;
 
     /// @brief Takes next point of the pathway.
     /// @param point Last point.
     /// @return Next point.
-    virtual Point<T> NextPoint(const Point<T>& point) = 0;
-    virtual void SetStart(const Point<T>& startPoint) = 0;
-    void SetParam(GeneralFunction<T>& _f, GeneralStop<T>& _stopIteration);
+    virtual Point<T, Container> NextPoint(const Point<T, Container>& point) = 0;
+    virtual void SetStart(const Point<T, Container>& startPoint) = 0;
+
+    /// @brief Sets the value of the function and the norm of the gradient in the last point of the pathway.
+    /// @details Methods remember them after SetStart and NextPoint, so the stopper does not evaluate the function.
+    /// By default the value is evaluated and the gradient is unknown.
+    /// @param[in] point Last point of the pathway.
+    /// @param[out] state State of the iteration.
+    virtual void FillState(const Point<T, Container>& point, IterationState<T, Container>& state) const { state.value = f->Value(point); }
+    void SetParam(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration);
 
     /// @brief It checked correct of field.
     virtual void CorrectField() = 0;
@@ -107,33 +172,66 @@ public:
     /// @brief Constructor of a optimization.
     /// @param[in] _f Function for optimization.
     /// @param[in] _stopIteration Stopper for stoping.
-    Optimization(GeneralFunction<T>& _f, GeneralStop<T>& _stopIteration);
+    Optimization(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration);
+
+    // The method evaluates the function through its own wrappers, a copy would evaluate through the wrappers of the source.
+    Optimization(const Optimization&) = delete;
+    Optimization(Optimization&&) = delete;
+    Optimization& operator=(const Optimization&) = delete;
+    Optimization& operator=(Optimization&&) = delete;
 
     /// @brief Sets minimum and maximum point of an area.
     /// @param[in] _min Minimum point of a area.
     /// @param[in] _max Maximum point of a area.
-    void SetArea(const Point<T>& _min, const Point<T>& _max);
+    void SetArea(const Point<T, Container>& _min, const Point<T, Container>& _max);
     
     /// @brief Function whith optimase math functions.
     /// @param[in] start Start point of a pathway.
-    void DoOptimize(const Point<T>& start);
+    void DoOptimize(const Point<T, Container>& start);
+
+    /// @brief Sets the stopper of next runs.
+    inline void SetStop(GeneralStop<T, Container>& _stopIteration) { stopIteration = &_stopIteration; }
+
+    /// @brief Sets the seed of random choices of the method. Deterministic methods ignore it.
+    /// @details Together with SetArea it makes a run independent of previous runs of the same object.
+    virtual void SetSeed(size_t) {}
+
+    /// @brief Sets the size of the cache of evaluations. Methods evaluate the function through the cache.
+    /// @param[in] capacity Maximum count of remembered points. Zero disables the cache.
+    void SetCacheCapacity(size_t capacity);
+    inline const CachedFunction<T, Container>& getCache() const { return cache; }
 
-    inline const std::vector<Point<T>> getPathway() const { return pathway; }
-    inline const T getValueLastPoint() const { return f->Value(pathway.back()); }
+    /// @brief Sets counting of calls of the function.
+    /// @details By default every call is counted and one call of every kind in SAMPLINGPERIOD is timed.
+    /// Without counting methods call the function directly, the summary has no evaluations and EvalStop does not stop.
+    /// @param[in] enabled Calls are counted.
+    /// @param[in] sampling Period of timed calls: 1 times every call, 0 only counts calls.
+    void SetInstrumentation(bool enabled, size_t sampling = SAMPLINGPERIOD);
+
+    /// @brief Counters of calls of the function in the last run. Calls answered by the cache are not counted.
+    inline const InstrumentedFunction<T, Container>& getInstrument() const { return instrument; }
+
+    /// @brief Summary of the last run: counts and latencies of calls and the decrease of the function.
+    /// @details Values in the start and in the last point are the values which the method passed to the stopper.
+    RunSummary<T> getSummary() const;
+
+    /// @brief View of the pathway of the last run. It is valid until the next call of SetArea or DoOptimize.
+    inline PathwayView<T, Container> getPathway() const { return pathway.View(); }
+    inline const T getValueLastPoint() const { return valueLast; }
 
     /// @brief Virtual destructor.
     virtual ~Optimization() {}
 };
 
-template <typename T>
-Optimization<T>::Optimization(GeneralFunction<T>& _f, GeneralStop<T>& _stopIteration)
-    : stopIteration(&_stopIteration), f(&_f)
+template <typename T, class Container>
+Optimization<T, Container>::Optimization(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration)
+    : stopIteration(&_stopIteration), instrument(_f, SAMPLINGPERIOD), cache(instrument, 0), instrumented(true), time(0), hitsStart(0), valueFirst{}, valueLast{}, f(&instrument)
 {
 
 }
 
-template <typename T>
-void Optimization<T>::SetArea(const Point<T>& _min, const Point<T>& _max)
+template <typename T, class Container>
+void Optimization<T, Container>::SetArea(const Point<T, Container>& _min, const Point<T, Container>& _max)
 {
     if (_min.size() != _max.size())
         throw std::invalid_argument("Size of points not equal.");
@@ -145,18 +243,43 @@ void Optimization<T>::SetArea(const Point<T>& _min, const Point<T>& _max)
     area.minArea = _min;
     area.maxArea = _max;
 
-    pathway.clear();
+    pathway.Clear();
 }
 
-template <typename T>
-void Optimization<T>::SetParam(GeneralFunction<T>& _f, GeneralStop<T>& _stopIteration)
+template <typename T, class Container>
+void Optimization<T, Container>::SetParam(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration)
 {
-    f = &_f;
+    instrument.SetParam(_f);
     stopIteration = &_stopIteration;
+    Wire();
 }
 
-template <typename T>
-void Optimization<T>::DoOptimize(const Point<T>& start)
+template <typename T, class Container>
+void Optimization<T, Container>::Wire()
+{
+    GeneralFunction<T, Container>* target = instrumented ? &instrument : &instrument.getFunction();
+
+    cache.SetParam(*target, cache.getCapacity());
+    f = cache.getCapacity() ? &cache : target;
+}
+
+template <typename T, class Container>
+void Optimization<T, Container>::SetCacheCapacity(size_t capacity)
+{
+    cache.SetParam(instrument, capacity);
+    Wire();
+}
+
+template <typename T, class Container>
+void Optimization<T, Container>::SetInstrumentation(bool enabled, size_t sampling)
+{
+    instrumented = enabled;
+    instrument.SetSampling(sampling);
+    Wire();
+}
+
+template <typename T, class Container>
+void Optimization<T, Container>::DoOptimize(const Point<T, Container>& start)
 {
     if (start.size() != area.minArea.size())
         throw std::invalid_argument("Size of start point is not equal size of area.");
@@ -165,13 +288,64 @@ void Optimization<T>::DoOptimize(const Point<T>& start)
         if (start[i] > area.maxArea[i] || start[i] < area.minArea[i])
             throw std::invalid_argument("The start point must be less than the maximum point and greater than the minimum point in all coordinates.");
 
+    const auto begin = std::chrono::steady_clock::now();
+    instrument.Reset();
+    hitsStart = cache.getHits();
+    stopIteration->Reset();
+
+    IterationState<T, Container> state;
+
     nowPoint = start;
     SetStart(start);
-    pathway.push_back(nowPoint);
+    PushPoint(state, begin);
 
-    while (stopIteration->condition(pathway))
+    while (stopIteration->condition(state))
     {
         nowPoint = NextPoint(nowPoint);
-        pathway.push_back(nowPoint);
+        state.stepLength = Norm(nowPoint + (-pathway.back()));
+        PushPoint(state, begin);
     }
+
+    time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+}
+
+template <typename T, class Container>
+void Optimization<T, Container>::PushPoint(IterationState<T, Container>& state, std::chrono::steady_clock::time_point begin)
+{
+    pathway.PushBack(nowPoint);
+
+    state.iteration = pathway.size();
+    state.point = pathway.back();
+    state.hasGradient = false;
+    FillState(nowPoint, state);
+    valueLast = state.value;
+
+    if (pathway.size() == 1)
+        valueFirst = state.value;
+
+    state.elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    state.evaluations = instrument.getEvaluations();
+}
+
+template <typename T, class Container>
+RunSummary<T> Optimization<T, Container>::getSummary() const
+{
+    RunSummary<T> res;
+
+    if (pathway.empty())
+        return res;
+
+    res.iterations = pathway.size();
+    res.dimension = pathway.back().size();
+    res.valueStart = valueFirst;
+    res.valueEnd = valueLast;
+    res.time = time;
+
+    for (size_t i{}; i < res.calls.size(); ++i)
+        res.calls[i] = instrument.getStats(static_cast<FunctionCall>(i));
+
+    res.evaluations = instrument.getEvaluations();
+    res.cacheHits = cache.getHits() - hitsStart;
+
+    return res;
 }
\ No newline at end of file
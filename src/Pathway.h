@@ -0,0 +1,203 @@
+/// @file
+/// @brief Contiguous storage of a pathway of an optimization.
+/// @details File contains the definition of a pathway stored as one row-major buffer (count of points x dimension)
+/// and of non-owning views of the pathway and of its points. A view of a point is an expression over points,
+/// so it takes part in arithmetic of points and is converted to a point where a function needs one.
+/// Views are valid until the pathway is changed.
+#pragma once
+
+#include <compare>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+#include "Point.h"
+
+/// @brief Non-owning view of coordinates of a point.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam Container Container of points which the view stands for.
+template <typename T, class Container = std::vector<T>>
+class PointView : public PointExpr<PointView<T, Container>>
+{
+private:
+    const T* x;
+    size_t dim;
+public:
+    using value_type = T;
+    static constexpr size_t extent = PointExtent<Container>::value;
+
+    PointView(const T* _x, size_t _dim) : x(_x), dim(_dim) {}
+
+    size_t size() const { return dim; }
+    const T* Data() const { return x; }
+
+    const T* begin() const { return x; }
+    const T* end() const { return x + dim; }
+
+    /// @brief Coordinate without range checking. The range is checked if DEBUG_POINT is defined.
+    const T& Eval(size_t i) const
+    {
+#ifdef DEBUG_POINT
+        return (*this)[i];
+#else
+        return x[i];
+#endif
+    }
+
+    const T& operator[](size_t i) const
+    {
+        if (i >= dim)
+            throw std::out_of_range("Out of range of Point.");
+
+        return x[i];
+    }
+};
+
+template <typename T, class Container>
+std::ostream& operator<<(std::ostream& out, const PointView<T, Container>& p)
+{
+    for (const T& a : p)
+        out << a << " ";
+
+    return out;
+}
+
+/// @brief Non-owning view of a pathway.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class PathwayView
+{
+private:
+    const T* data;
+    size_t count;
+    size_t dim;
+public:
+    /// @brief Random access iterator. Dereferencing gives a view of a point.
+    class Iterator
+    {
+    private:
+        const T* x;
+        size_t dim;
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = PointView<T, Container>;
+        using difference_type = std::ptrdiff_t;
+        using reference = PointView<T, Container>;
+        using pointer = void;
+
+        Iterator() : x(nullptr), dim(0) {}
+        Iterator(const T* _x, size_t _dim) : x(_x), dim(_dim) {}
+
+        reference operator*() const { return reference(x, dim); }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        Iterator& operator++() { x += dim; return *this; }
+        Iterator& operator--() { x -= dim; return *this; }
+        Iterator operator++(int) { Iterator res = *this; ++*this; return res; }
+        Iterator operator--(int) { Iterator res = *this; --*this; return res; }
+        Iterator& operator+=(difference_type n) { x += n * static_cast<difference_type>(dim); return *this; }
+        Iterator& operator-=(difference_type n) { x -= n * static_cast<difference_type>(dim); return *this; }
+
+        friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+        friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+        friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const Iterator& a, const Iterator& b) { return a.dim ? (a.x - b.x) / static_cast<difference_type>(a.dim) : 0; }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.x == b.x; }
+        friend auto operator<=>(const Iterator& a, const Iterator& b) { return a.x <=> b.x; }
+    };
+
+    using value_type = PointView<T, Container>;
+    using iterator = Iterator;
+    using reverse_iterator = std::reverse_iterator<Iterator>;
+
+    PathwayView() : data(nullptr), count(0), dim(0) {}
+    PathwayView(const T* _data, size_t _count, size_t _dim) : data(_data), count(_count), dim(_dim) {}
+
+    size_t size() const { return count; }
+    bool empty() const { return !count; }
+    size_t dimension() const { return dim; }
+
+    /// @brief Coordinates of all points, point after point.
+    const T* Data() const { return data; }
+
+    PointView<T, Container> operator[](size_t i) const
+    {
+        if (i >= count)
+            throw std::out_of_range("Out of range of Pathway.");
+
+        return PointView<T, Container>(data + i * dim, dim);
+    }
+
+    PointView<T, Container> front() const { return (*this)[0]; }
+    PointView<T, Container> back() const { return (*this)[count - 1]; }
+
+    Iterator begin() const { return Iterator(data, dim); }
+    Iterator end() const { return Iterator(data + count * dim, dim); }
+
+    reverse_iterator rbegin() const { return reverse_iterator(end()); }
+    reverse_iterator rend() const { return reverse_iterator(begin()); }
+};
+
+/// @brief Pathway stored as one contiguous buffer with amortized growth.
+/// @details All points have the dimension of the first point. Clear keeps the storage, so repeated runs do not allocate.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam Container Container for a storage of point's coordinate.
+template <typename T, class Container = std::vector<T>>
+class Pathway
+{
+private:
+    std::vector<T> data;
+    size_t count = 0;
+    size_t dim = PointExtent<Container>::value;
+public:
+    Pathway() = default;
+
+    /// @brief Copies points of a view.
+    /// @param view View of a pathway.
+    Pathway(const PathwayView<T, Container>& view)
+        : data(view.Data(), view.Data() + view.size() * view.dimension()), count(view.size()), dim(view.dimension()) {}
+
+    /// @brief Removes all points and keeps the storage.
+    void Clear() { data.clear(); count = 0; }
+
+    /// @brief Reserves the storage for a count of points of a dimension.
+    void Reserve(size_t points, size_t dimension) { data.reserve(points * dimension); }
+
+    /// @brief Appends a point.
+    /// @param e Point or expression over points. Its dimension must be equal to the dimension of the pathway.
+    template <class E>
+    void PushBack(const PointExpr<E>& e)
+    {
+        const E& p = e.Self();
+
+        if (!count && PointExtent<Container>::value == 0)
+            dim = p.size();
+        else if (p.size() != dim)
+            throw std::invalid_argument("Dimension of the point is not equal dimension of the pathway.");
+
+        data.resize(data.size() + dim);
+        T* x = data.data() + count * dim;
+
+        for (size_t i{}; i < dim; ++i)
+            x[i] = p.Eval(i);
+
+        ++count;
+    }
+
+    PathwayView<T, Container> View() const { return PathwayView<T, Container>(data.data(), count, dim); }
+    operator PathwayView<T, Container>() const { return View(); }
+
+    size_t size() const { return count; }
+    bool empty() const { return !count; }
+    size_t dimension() const { return dim; }
+
+    PointView<T, Container> operator[](size_t i) const { return View()[i]; }
+    PointView<T, Container> front() const { return View().front(); }
+    PointView<T, Container> back() const { return View().back(); }
+
+    auto begin() const { return View().begin(); }
+    auto end() const { return View().end(); }
+    auto rbegin() const { return View().rbegin(); }
+    auto rend() const { return View().rend(); }
+};
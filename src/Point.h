@@ -1,26 +1,163 @@
 /// @file
 /// @brief Realization of a multidimensional point.
 /// @details File contains the definition of class of a multidimensional point.
+/// The point can store coordinates in std::vector (dimension is known at runtime)
+/// or in std::array (dimension is known at compile time, coordinates are stored on the stack).
+/// Arithmetic operators return lazy expressions: a whole expression like p + alpha * v is evaluated
+/// in one loop when it is assigned to a point, so no temporary points are created.
+/// Dot product, axpy, scaling and norm of points of double stored in std::vector are computed by vectorized kernels.
+/// If DEBUG_POINT is defined, kernels are not used and every access to a coordinate checks the range.
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#include "PointKernels.h"
+
+/// @brief Compile-time information about a container of point's coordinates.
+/// @tparam Container Container for a storage of point's coordinate.
+template <class Container>
+struct PointExtent
+{
+    /// @brief Dimension of a point. Zero if it is known only at runtime.
+    static constexpr size_t value = 0;
+};
+
+template <typename T, size_t N>
+struct PointExtent<std::array<T, N>>
+{
+    static constexpr size_t value = N;
+};
+
+/// @brief Base class of an expression over points.
+/// @details Each expression has value_type, extent, size() and Eval(i) without range checking.
+/// @tparam E Type of an expression.
+template <class E>
+class PointExpr
+{
+public:
+    const E& Self() const { return static_cast<const E&>(*this); }
+};
+
+template <typename T, class Container>
+class Point;
+
+namespace PointDetail
+{
+    /// @brief How an expression stores its operand: points by reference, expressions by value.
+    template <class E>
+    struct Operand
+    {
+        using type = const E;
+    };
+
+    template <typename T, class Container>
+    struct Operand<Point<T, Container>>
+    {
+        using type = const Point<T, Container>&;
+    };
+
+    /// @brief Points which are processed by vectorized kernels.
+    template <class E>
+    struct IsKernelPoint
+    {
+#ifdef DEBUG_POINT
+        static constexpr bool value = false;
+#else
+        static constexpr bool value = std::is_same_v<E, Point<double, std::vector<double>>>;
+#endif
+    };
+
+    /// @brief Evaluation of an expression by vectorized kernels. Defined for expressions of kernel points.
+    template <class E>
+    struct Kernel
+    {
+        static constexpr bool value = false;
+    };
+
+    /// @brief Calls op(i) for all indexes of a point. Loop is unrolled if the dimension is known at compile time.
+    template <size_t N, class Op, size_t... I>
+    inline void Unroll(Op&& op, std::index_sequence<I...>)
+    {
+        (op(I), ...);
+    }
+
+    template <size_t N, class Op>
+    inline void ForEachIndex(size_t size, Op&& op)
+    {
+        if constexpr (N > 0)
+            Unroll<N>(op, std::make_index_sequence<N>());
+        else
+            for (size_t i{0}; i < size; ++i)
+                op(i);
+    }
+}
 
 /// @brief Class of a multidimensional point.
 /// @tparam T Typename of a point's coordinate.
 /// @tparam Container Container for a storage of point's coordinate.
 template <typename T, class Container = std::vector<T>>
-class Point
+class Point : public PointExpr<Point<T, Container>>
 {
 private:
     Container x;
+
+    template <class E>
+    void Assign(const E& e)
+    {
+        if constexpr (extent == 0)
+            x.resize(e.size());
+        else if (e.size() != extent)
+            throw std::out_of_range("The dimensions of the points are not equal.");
+
+        if constexpr (PointDetail::Kernel<E>::value)
+        {
+            PointDetail::Kernel<E>::Run(x.data(), e);
+
+            return;
+        }
+
+        PointDetail::ForEachIndex<extent>(size(), [this, &e](size_t i)
+        {
+            x[i] = e.Eval(i);
+        });
+    }
 public:
+    using value_type = T;
+
+    /// @brief Dimension of a point if it is known at compile time, else zero.
+    static constexpr size_t extent = PointExtent<Container>::value;
+
     /// @brief Default constructor.
-    Point() {};
+    Point() : x() {};
     /// @brief Constructor for multidimensional point.
     /// @param _x Container which store of point's coordinate.
     Point(const Container& _x) : x(_x) {};
+    /// @brief Constructor which evaluates an expression.
+    /// @param e Expression over points.
+    template <class E>
+    Point(const PointExpr<E>& e) : x() { Assign(e.Self()); }
+
+    Point(const Point&) = default;
+    Point(Point&&) = default;
+    Point& operator=(const Point&) = default;
+    Point& operator=(Point&&) = default;
+
+    /// @brief Evaluates an expression into the point. Storage of the point is reused.
+    /// @param e Expression over points.
+    template <class E>
+    Point& operator=(const PointExpr<E>& e)
+    {
+        Assign(e.Self());
+
+        return *this;
+    }
 
     auto begin() { return x.begin(); }
     auto end() { return x.end(); }
@@ -28,7 +165,35 @@ public:
     auto begin() const  { return x.cbegin(); }
     auto end() const { return x.cend(); }
 
-    size_t size() const { return x.size(); }
+    constexpr size_t size() const { return x.size(); }
+
+    /// @brief Changes the dimension of a point. Storage is reused if the dimension is not changed.
+    /// @param n New dimension. It must be equal to extent if the dimension is known at compile time.
+    void Resize(size_t n)
+    {
+        if constexpr (extent == 0)
+            x.resize(n);
+        else if (n != extent)
+            throw std::out_of_range("The dimension of the point is fixed.");
+    }
+
+    /// @brief Sets all coordinates to the value.
+    /// @param value Value of coordinates.
+    void Fill(const T& value) { std::fill(x.begin(), x.end(), value); }
+
+    /// @brief Pointer to contiguous coordinates.
+    T* Data() { return x.data(); }
+    const T* Data() const { return x.data(); }
+
+    /// @brief Coordinate without range checking. The range is checked if DEBUG_POINT is defined.
+    const T& Eval(size_t i) const
+    {
+#ifdef DEBUG_POINT
+        return (*this)[i];
+#else
+        return x[i];
+#endif
+    }
 
     T& operator[](size_t i)
     {
@@ -45,74 +210,219 @@ public:
 
         return x[i];
     }
+};
 
-    Point<T, Container> operator-() const 
-    {
-        Point<T, Container> res(*this);
+/// @brief Point with a dimension known at compile time.
+/// @tparam T Typename of a point's coordinate.
+/// @tparam N Dimension of a point.
+template <typename T, size_t N>
+using PointN = Point<T, std::array<T, N>>;
 
-        std::for_each(res.begin(), res.end(), [](T& p)
-        {
-            p = p * (-1);
-        });
+/// @brief Expression of a sum of two points.
+template <class L, class R>
+class PointSum : public PointExpr<PointSum<L, R>>
+{
+private:
+    typename PointDetail::Operand<L>::type l;
+    typename PointDetail::Operand<R>::type r;
+public:
+    using value_type = typename L::value_type;
+    static constexpr size_t extent = L::extent ? L::extent : R::extent;
 
-        return res;
+    PointSum(const L& _l, const R& _r) : l(_l), r(_r)
+    {
+        if (l.size() != r.size())
+            throw std::out_of_range("The dimensions of the points are not equal.");
     }
 
-    template <typename V, class Container_>
-    friend Point<V, Container_> operator+(const Point<V, Container_>& p1, const Point<V, Container_>& p2);
-    template <typename V, class Container_>
-    friend Point<V, Container_> operator*(const V& alpha, const Point<V, Container_>& p);
+    size_t size() const { return l.size(); }
+    value_type Eval(size_t i) const { return l.Eval(i) + r.Eval(i); }
+
+    const L& Left() const { return l; }
+    const R& Right() const { return r; }
 };
 
-template <typename T, class Container>
-T operator*(const Point<T, Container>& p1, const Point<T, Container>& p2)
+/// @brief Expression of a negation of a point.
+template <class E>
+class PointNeg : public PointExpr<PointNeg<E>>
 {
-    if (p1.size() != p2.size())
-        throw std::out_of_range("The dimensions of the points are not equal.");
+private:
+    typename PointDetail::Operand<E>::type e;
+public:
+    using value_type = typename E::value_type;
+    static constexpr size_t extent = E::extent;
 
-    T res{};
-    
-    for (size_t i{0}; i < p1.size(); ++i)
-        res += p1[i] * p2[i];
+    PointNeg(const E& _e) : e(_e) {}
 
-    return res;
-}
+    size_t size() const { return e.size(); }
+    value_type Eval(size_t i) const { return -e.Eval(i); }
 
-template <typename T, class Container>
-Point<T, Container> operator+(const Point<T, Container>& p1, const Point<T, Container>& p2)
+    const E& Arg() const { return e; }
+};
+
+/// @brief Expression of a product of a scalar and a point.
+template <class E>
+class PointScale : public PointExpr<PointScale<E>>
 {
-    if (p1.size() != p2.size())
-        throw std::out_of_range("The dimensions of the points are not equal.");
+private:
+    typename E::value_type alpha;
+    typename PointDetail::Operand<E>::type e;
+public:
+    using value_type = typename E::value_type;
+    static constexpr size_t extent = E::extent;
+
+    PointScale(const value_type& _alpha, const E& _e) : alpha(_alpha), e(_e) {}
+
+    size_t size() const { return e.size(); }
+    value_type Eval(size_t i) const { return e.Eval(i) * alpha; }
+
+    const value_type& Alpha() const { return alpha; }
+    const E& Arg() const { return e; }
+};
+
+namespace PointDetail
+{
+    /// @brief alpha * x.
+    template <class P>
+    struct Kernel<PointScale<P>>
+    {
+        static constexpr bool value = IsKernelPoint<P>::value;
+
+        static void Run(double* out, const PointScale<P>& e)
+        {
+            PointKernels::Scale(e.Alpha(), e.Arg().Data(), out, e.size());
+        }
+    };
+
+    /// @brief x + y.
+    template <class P>
+    struct Kernel<PointSum<P, P>>
+    {
+        static constexpr bool value = IsKernelPoint<P>::value;
+
+        static void Run(double* out, const PointSum<P, P>& e)
+        {
+            PointKernels::Axpy(1.0, e.Right().Data(), e.Left().Data(), out, e.size());
+        }
+    };
+
+    /// @brief y + alpha * x.
+    template <class P>
+    struct Kernel<PointSum<P, PointScale<P>>>
+    {
+        static constexpr bool value = IsKernelPoint<P>::value;
+
+        static void Run(double* out, const PointSum<P, PointScale<P>>& e)
+        {
+            PointKernels::Axpy(e.Right().Alpha(), e.Right().Arg().Data(), e.Left().Data(), out, e.size());
+        }
+    };
+
+    /// @brief alpha * x + y.
+    template <class P>
+    struct Kernel<PointSum<PointScale<P>, P>>
+    {
+        static constexpr bool value = IsKernelPoint<P>::value;
+
+        static void Run(double* out, const PointSum<PointScale<P>, P>& e)
+        {
+            PointKernels::Axpy(e.Left().Alpha(), e.Left().Arg().Data(), e.Right().Data(), out, e.size());
+        }
+    };
+
+    /// @brief y + (-x).
+    template <class P>
+    struct Kernel<PointSum<P, PointNeg<P>>>
+    {
+        static constexpr bool value = IsKernelPoint<P>::value;
+
+        static void Run(double* out, const PointSum<P, PointNeg<P>>& e)
+        {
+            PointKernels::Axpy(-1.0, e.Right().Arg().Data(), e.Left().Data(), out, e.size());
+        }
+    };
 
-    Point<T, Container> p;
+    /// @brief (-x) + alpha * y. The destination may be x or y, so the order of passes depends on it.
+    template <class P>
+    struct Kernel<PointSum<PointNeg<P>, PointScale<P>>>
+    {
+        static constexpr bool value = IsKernelPoint<P>::value;
 
-    std::copy(p1.begin(), p1.end(), std::back_inserter(p.x));
-    
-    for (size_t i{0}; i < p.size(); ++i)
-        p[i] = p[i] + p2[i];
+        static void Run(double* out, const PointSum<PointNeg<P>, PointScale<P>>& e)
+        {
+            const double* x = e.Left().Arg().Data();
+            const double* y = e.Right().Arg().Data();
 
-    return p;
+            if (out != x)
+            {
+                PointKernels::Scale(e.Right().Alpha(), y, out, e.size());
+                PointKernels::Axpy(-1.0, x, out, out, e.size());
+            }
+            else
+            {
+                PointKernels::Scale(-1.0, x, out, e.size());
+                PointKernels::Axpy(e.Right().Alpha(), y, out, out, e.size());
+            }
+        }
+    };
 }
 
-template <typename T, class Container>
-Point<T, Container> operator*(const T& alpha, const Point<T, Container>& p)
+template <class L, class R>
+typename L::value_type operator*(const PointExpr<L>& e1, const PointExpr<R>& e2)
 {
-    Point<T, Container> res;
+    const L& p1 = e1.Self();
+    const R& p2 = e2.Self();
+
+    if (p1.size() != p2.size())
+        throw std::out_of_range("The dimensions of the points are not equal.");
+
+    if constexpr (PointDetail::IsKernelPoint<L>::value && PointDetail::IsKernelPoint<R>::value)
+        return PointKernels::Dot(p1.Data(), p2.Data(), p1.size());
 
-    std::copy(p.begin(), p.end(), std::back_inserter(res.x));
-    
-    std::for_each(res.begin(), res.end(), [&alpha](T& element)
+    typename L::value_type res{};
+
+    PointDetail::ForEachIndex<PointSum<L, R>::extent>(p1.size(), [&res, &p1, &p2](size_t i)
     {
-        element = element * alpha;
+        res += p1.Eval(i) * p2.Eval(i);
     });
 
     return res;
 }
 
-template <typename T, class Container>
-Point<T, Container> operator*(const Point<T, Container>& p, const T& alpha)
+/// @brief Euclidean norm of a point.
+/// @param e Point or expression over points.
+/// @return Norm.
+template <class E>
+typename E::value_type Norm(const PointExpr<E>& e)
+{
+    if constexpr (PointDetail::IsKernelPoint<E>::value)
+        return PointKernels::Norm(e.Self().Data(), e.Self().size());
+    else
+        return std::sqrt(e * e);
+}
+
+template <class L, class R>
+PointSum<L, R> operator+(const PointExpr<L>& e1, const PointExpr<R>& e2)
+{
+    return PointSum<L, R>(e1.Self(), e2.Self());
+}
+
+template <class E>
+PointNeg<E> operator-(const PointExpr<E>& e)
 {
-    return alpha * p;
+    return PointNeg<E>(e.Self());
+}
+
+template <class E>
+PointScale<E> operator*(const typename E::value_type& alpha, const PointExpr<E>& e)
+{
+    return PointScale<E>(alpha, e.Self());
+}
+
+template <class E>
+PointScale<E> operator*(const PointExpr<E>& e, const typename E::value_type& alpha)
+{
+    return PointScale<E>(alpha, e.Self());
 }
 
 template <typename T, class Container>
@@ -124,4 +434,4 @@ std::ostream& operator<<(std::ostream& out, const Point<T, Container>& p)
     });
 
     return out;
-}
\ No newline at end of file
+}
@@ -0,0 +1,285 @@
+#include <cmath>
+#include <stdexcept>
+#include "PointKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define POINT_KERNELS_X86
+#endif
+
+namespace
+{
+    struct KernelTable
+    {
+        double (*dot)(const double*, const double*, size_t);
+        void (*axpy)(double, const double*, const double*, double*, size_t);
+        void (*scale)(double, const double*, double*, size_t);
+        double (*norm)(const double*, size_t);
+    };
+
+    double DotScalar(const double* a, const double* b, size_t n)
+    {
+        double s0{}, s1{}, s2{}, s3{};
+        size_t i{0};
+
+        for (; i + 4 <= n; i += 4)
+        {
+            s0 += a[i] * b[i];
+            s1 += a[i + 1] * b[i + 1];
+            s2 += a[i + 2] * b[i + 2];
+            s3 += a[i + 3] * b[i + 3];
+        }
+
+        for (; i < n; ++i)
+            s0 += a[i] * b[i];
+
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    void AxpyScalar(double alpha, const double* x, const double* y, double* out, size_t n)
+    {
+        for (size_t i{0}; i < n; ++i)
+            out[i] = y[i] + x[i] * alpha;
+    }
+
+    void ScaleScalar(double alpha, const double* x, double* out, size_t n)
+    {
+        for (size_t i{0}; i < n; ++i)
+            out[i] = x[i] * alpha;
+    }
+
+    double NormScalar(const double* x, size_t n)
+    {
+        return std::sqrt(DotScalar(x, x, n));
+    }
+
+#ifdef POINT_KERNELS_X86
+    [[gnu::target("avx2,fma")]] double HorizontalSum(__m256d v)
+    {
+        __m128d low = _mm256_castpd256_pd128(v), high = _mm256_extractf128_pd(v, 1);
+        low = _mm_add_pd(low, high);
+
+        return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+    }
+
+    [[gnu::target("avx2,fma")]] double DotAVX2(const double* a, const double* b, size_t n)
+    {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        size_t i{0};
+
+        for (; i + 8 <= n; i += 8)
+        {
+            s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+            s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), s1);
+        }
+
+        for (; i + 4 <= n; i += 4)
+            s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+
+        double res = HorizontalSum(_mm256_add_pd(s0, s1));
+
+        for (; i < n; ++i)
+            res += a[i] * b[i];
+
+        return res;
+    }
+
+    [[gnu::target("avx2,fma")]] void AxpyAVX2(double alpha, const double* x, const double* y, double* out, size_t n)
+    {
+        __m256d a = _mm256_set1_pd(alpha);
+        size_t i{0};
+
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(out + i, _mm256_fmadd_pd(_mm256_loadu_pd(x + i), a, _mm256_loadu_pd(y + i)));
+
+        for (; i < n; ++i)
+            out[i] = y[i] + x[i] * alpha;
+    }
+
+    [[gnu::target("avx2,fma")]] void ScaleAVX2(double alpha, const double* x, double* out, size_t n)
+    {
+        __m256d a = _mm256_set1_pd(alpha);
+        size_t i{0};
+
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(x + i), a));
+
+        for (; i < n; ++i)
+            out[i] = x[i] * alpha;
+    }
+
+    [[gnu::target("avx2,fma")]] double NormAVX2(const double* x, size_t n)
+    {
+        return std::sqrt(DotAVX2(x, x, n));
+    }
+
+    [[gnu::target("avx512f")]] double DotAVX512(const double* a, const double* b, size_t n)
+    {
+        __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+        size_t i{0};
+
+        for (; i + 16 <= n; i += 16)
+        {
+            s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
+            s1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), s1);
+        }
+
+        if (i + 8 <= n)
+        {
+            s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
+            i += 8;
+        }
+
+        if (i < n)
+        {
+            __mmask8 mask = static_cast<__mmask8>((1u << (n - i)) - 1);
+            s1 = _mm512_fmadd_pd(_mm512_mask_loadu_pd(_mm512_setzero_pd(), mask, a + i),
+                                 _mm512_mask_loadu_pd(_mm512_setzero_pd(), mask, b + i), s1);
+        }
+
+        // _mm512_reduce_add_pd is avoided: its header implementation triggers -Wuninitialized in GCC 12.
+        alignas(64) double lanes[8];
+        _mm512_store_pd(lanes, _mm512_add_pd(s0, s1));
+
+        return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    }
+
+    [[gnu::target("avx512f")]] void AxpyAVX512(double alpha, const double* x, const double* y, double* out, size_t n)
+    {
+        __m512d a = _mm512_set1_pd(alpha);
+        size_t i{0};
+
+        for (; i + 8 <= n; i += 8)
+            _mm512_storeu_pd(out + i, _mm512_fmadd_pd(_mm512_loadu_pd(x + i), a, _mm512_loadu_pd(y + i)));
+
+        if (i < n)
+        {
+            __mmask8 mask = static_cast<__mmask8>((1u << (n - i)) - 1);
+            _mm512_mask_storeu_pd(out + i, mask, _mm512_fmadd_pd(_mm512_mask_loadu_pd(_mm512_setzero_pd(), mask, x + i), a,
+                                                                 _mm512_mask_loadu_pd(_mm512_setzero_pd(), mask, y + i)));
+        }
+    }
+
+    [[gnu::target("avx512f")]] void ScaleAVX512(double alpha, const double* x, double* out, size_t n)
+    {
+        __m512d a = _mm512_set1_pd(alpha);
+        size_t i{0};
+
+        for (; i + 8 <= n; i += 8)
+            _mm512_storeu_pd(out + i, _mm512_mul_pd(_mm512_loadu_pd(x + i), a));
+
+        if (i < n)
+        {
+            __mmask8 mask = static_cast<__mmask8>((1u << (n - i)) - 1);
+            _mm512_mask_storeu_pd(out + i, mask, _mm512_mul_pd(_mm512_mask_loadu_pd(_mm512_setzero_pd(), mask, x + i), a));
+        }
+    }
+
+    [[gnu::target("avx512f")]] double NormAVX512(const double* x, size_t n)
+    {
+        return std::sqrt(DotAVX512(x, x, n));
+    }
+#endif
+
+    KernelTable TableFor(PointKernels::Isa isa)
+    {
+        switch (isa)
+        {
+#ifdef POINT_KERNELS_X86
+        case PointKernels::Isa::AVX512:
+            return {DotAVX512, AxpyAVX512, ScaleAVX512, NormAVX512};
+        case PointKernels::Isa::AVX2:
+            return {DotAVX2, AxpyAVX2, ScaleAVX2, NormAVX2};
+#endif
+        default:
+            return {DotScalar, AxpyScalar, ScaleScalar, NormScalar};
+        }
+    }
+
+    bool Supported(PointKernels::Isa isa)
+    {
+        switch (isa)
+        {
+        case PointKernels::Isa::Scalar:
+            return true;
+#ifdef POINT_KERNELS_X86
+        case PointKernels::Isa::AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case PointKernels::Isa::AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+        }
+    }
+
+    struct ActiveTable
+    {
+        PointKernels::Isa isa;
+        KernelTable table;
+    };
+
+    ActiveTable& Current()
+    {
+        static ActiveTable active{PointKernels::Best(), TableFor(PointKernels::Best())};
+
+        return active;
+    }
+}
+
+PointKernels::Isa PointKernels::Best()
+{
+    if (Supported(Isa::AVX512))
+        return Isa::AVX512;
+
+    if (Supported(Isa::AVX2))
+        return Isa::AVX2;
+
+    return Isa::Scalar;
+}
+
+PointKernels::Isa PointKernels::Active()
+{
+    return Current().isa;
+}
+
+void PointKernels::Use(Isa isa)
+{
+    if (!Supported(isa))
+        throw std::invalid_argument("Instruction set is not supported by the processor.");
+
+    Current() = {isa, TableFor(isa)};
+}
+
+const char* PointKernels::Name(Isa isa)
+{
+    switch (isa)
+    {
+    case Isa::AVX512:
+        return "avx512";
+    case Isa::AVX2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+double PointKernels::Dot(const double* a, const double* b, size_t n)
+{
+    return Current().table.dot(a, b, n);
+}
+
+void PointKernels::Axpy(double alpha, const double* x, const double* y, double* out, size_t n)
+{
+    Current().table.axpy(alpha, x, y, out, n);
+}
+
+void PointKernels::Scale(double alpha, const double* x, double* out, size_t n)
+{
+    Current().table.scale(alpha, x, out, n);
+}
+
+double PointKernels::Norm(const double* x, size_t n)
+{
+    return Current().table.norm(x, n);
+}
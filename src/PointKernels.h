@@ -0,0 +1,48 @@
+/// @file
+/// @brief Vectorized kernels for arithmetic of points.
+/// @details File contains the declaration of dot product, axpy, scaling and norm over contiguous arrays.
+/// Kernels are implemented for AVX-512, AVX2 and without SIMD. The best supported instruction set is
+/// selected at runtime on the first call. Kernels do not check ranges: the caller checks sizes once.
+#pragma once
+
+#include <cstddef>
+
+/// @brief Attribute of functions with loops over arrays, which are vectorized even in a build without -O3.
+/// The AVX2 clone is selected at runtime if the processor supports it.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define VECTORIZED [[gnu::target_clones("avx2", "default"), gnu::optimize("O3")]]
+#else
+#define VECTORIZED
+#endif
+
+namespace PointKernels
+{
+    /// @brief Instruction set of kernels.
+    enum class Isa { Scalar, AVX2, AVX512 };
+
+    /// @brief The best instruction set supported by the processor.
+    Isa Best();
+
+    /// @brief Instruction set used now.
+    Isa Active();
+
+    /// @brief Sets instruction set of kernels. Not thread-safe, call it before optimization.
+    /// @param isa Instruction set. It must be supported by the processor.
+    void Use(Isa isa);
+
+    /// @brief Name of an instruction set.
+    const char* Name(Isa isa);
+
+    /// @brief Dot product of two arrays.
+    /// @return Sum of a[i] * b[i].
+    double Dot(const double* a, const double* b, size_t n);
+
+    /// @brief Computes out[i] = y[i] + alpha * x[i]. Out can be equal to x or y.
+    void Axpy(double alpha, const double* x, const double* y, double* out, size_t n);
+
+    /// @brief Computes out[i] = alpha * x[i]. Out can be equal to x.
+    void Scale(double alpha, const double* x, double* out, size_t n);
+
+    /// @brief Euclidean norm of an array.
+    double Norm(const double* x, size_t n);
+}
@@ -0,0 +1,301 @@
+/// @file
+/// @brief Realization of reverse-mode automatic differentiation.
+/// @details File contains the definition of a tape of operations and of a function which computes its gradient
+/// by replaying the tape. The objective is recorded once for a dimension: every operation is appended
+/// to the tape with indexes of its arguments. Later gradients replay the recorded tape with new inputs:
+/// a forward sweep recomputes values and a reverse sweep accumulates adjoints. The tape is stored in
+/// contiguous arrays which are reused, so replaying does not allocate.
+///
+/// The objective is the same functor as for AutoDiffFunction. Its sequence of operations must not depend
+/// on values of the point (no branches on values), because the tape is recorded only once.
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "Optimization.h"
+
+template <typename T>
+class TapeVar;
+
+/// @brief Tape of operations of reverse-mode automatic differentiation.
+/// @tparam T Typename of a value.
+template <typename T>
+class Tape
+{
+public:
+    enum class Op : uint8_t { Input, Add, Sub, Mul, Div, Neg, AddC, MulC, SubFromC, DivIntoC,
+                              Sin, Cos, Exp, Log, Sqrt, PowC };
+private:
+    /// @brief Operation with indexes of arguments and a constant operand.
+    struct Node
+    {
+        Op op;
+        uint32_t a;
+        uint32_t b;
+        T c;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<T> values;
+    std::vector<T> adjoints;
+    std::vector<uint32_t> inputs;
+public:
+    /// @brief Forgets all operations. Memory is kept for the next recording.
+    void Clear();
+
+    /// @brief Appends an operation.
+    /// @return Index of a result of an operation.
+    uint32_t Push(Op op, uint32_t a, uint32_t b, const T& c, const T& value);
+
+    /// @brief Appends an input variable.
+    uint32_t Input(const T& value);
+
+    /// @brief Sets values of inputs and recomputes values of all operations.
+    /// @param p Point with values of inputs.
+    template <class Container>
+    void Forward(const Point<T, Container>& p);
+
+    /// @brief Accumulates adjoints from an output back to inputs.
+    /// @param output Index of an output.
+    /// @param gradient Gradient: adjoints of inputs.
+    template <class Container>
+    void Reverse(uint32_t output, Point<T, Container>& gradient);
+
+    inline const T& getValue(uint32_t i) const { return values[i]; }
+    inline size_t getSize() const { return nodes.size(); }
+    inline size_t getInputCount() const { return inputs.size(); }
+};
+
+/// @brief Variable recorded on a tape.
+/// @tparam T Typename of a value.
+template <typename T>
+class TapeVar
+{
+private:
+    using Op = typename Tape<T>::Op;
+
+    Tape<T>* tape;
+    uint32_t index;
+
+    static TapeVar Unary(Op op, const TapeVar& a, const T& c, const T& value)
+    {
+        return TapeVar(a.tape, a.tape->Push(op, a.index, a.index, c, value));
+    }
+
+    static TapeVar Binary(Op op, const TapeVar& a, const TapeVar& b, const T& value)
+    {
+        return TapeVar(a.tape, a.tape->Push(op, a.index, b.index, T{}, value));
+    }
+public:
+    using value_type = T;
+
+    TapeVar() : tape(nullptr), index(0) {}
+    TapeVar(Tape<T>* _tape, uint32_t _index) : tape(_tape), index(_index) {}
+
+    const T& Value() const { return tape->getValue(index); }
+    uint32_t Index() const { return index; }
+
+    friend TapeVar operator+(const TapeVar& a, const TapeVar& b) { return Binary(Op::Add, a, b, a.Value() + b.Value()); }
+    friend TapeVar operator-(const TapeVar& a, const TapeVar& b) { return Binary(Op::Sub, a, b, a.Value() - b.Value()); }
+    friend TapeVar operator*(const TapeVar& a, const TapeVar& b) { return Binary(Op::Mul, a, b, a.Value() * b.Value()); }
+    friend TapeVar operator/(const TapeVar& a, const TapeVar& b) { return Binary(Op::Div, a, b, a.Value() / b.Value()); }
+    friend TapeVar operator-(const TapeVar& a) { return Unary(Op::Neg, a, T{}, -a.Value()); }
+
+    friend TapeVar operator+(const TapeVar& a, const T& c) { return Unary(Op::AddC, a, c, a.Value() + c); }
+    friend TapeVar operator+(const T& c, const TapeVar& a) { return Unary(Op::AddC, a, c, c + a.Value()); }
+    friend TapeVar operator-(const TapeVar& a, const T& c) { return Unary(Op::AddC, a, -c, a.Value() - c); }
+    friend TapeVar operator-(const T& c, const TapeVar& a) { return Unary(Op::SubFromC, a, c, c - a.Value()); }
+    friend TapeVar operator*(const TapeVar& a, const T& c) { return Unary(Op::MulC, a, c, a.Value() * c); }
+    friend TapeVar operator*(const T& c, const TapeVar& a) { return Unary(Op::MulC, a, c, c * a.Value()); }
+    friend TapeVar operator/(const TapeVar& a, const T& c) { return Unary(Op::MulC, a, static_cast<T>(1) / c, a.Value() / c); }
+    friend TapeVar operator/(const T& c, const TapeVar& a) { return Unary(Op::DivIntoC, a, c, c / a.Value()); }
+
+    TapeVar& operator+=(const TapeVar& b) { return *this = *this + b; }
+    TapeVar& operator-=(const TapeVar& b) { return *this = *this - b; }
+    TapeVar& operator*=(const TapeVar& b) { return *this = *this * b; }
+    TapeVar& operator/=(const TapeVar& b) { return *this = *this / b; }
+
+    friend TapeVar sin(const TapeVar& a) { return Unary(Op::Sin, a, T{}, std::sin(a.Value())); }
+    friend TapeVar cos(const TapeVar& a) { return Unary(Op::Cos, a, T{}, std::cos(a.Value())); }
+    friend TapeVar exp(const TapeVar& a) { return Unary(Op::Exp, a, T{}, std::exp(a.Value())); }
+    friend TapeVar log(const TapeVar& a) { return Unary(Op::Log, a, T{}, std::log(a.Value())); }
+    friend TapeVar sqrt(const TapeVar& a) { return Unary(Op::Sqrt, a, T{}, std::sqrt(a.Value())); }
+    friend TapeVar pow(const TapeVar& a, const T& c) { return Unary(Op::PowC, a, c, std::pow(a.Value(), c)); }
+};
+
+template <typename T>
+void Tape<T>::Clear()
+{
+    nodes.clear();
+    values.clear();
+    inputs.clear();
+}
+
+template <typename T>
+uint32_t Tape<T>::Push(Op op, uint32_t a, uint32_t b, const T& c, const T& value)
+{
+    nodes.push_back({op, a, b, c});
+    values.push_back(value);
+
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+template <typename T>
+uint32_t Tape<T>::Input(const T& value)
+{
+    inputs.push_back(Push(Op::Input, 0, 0, T{}, value));
+
+    return inputs.back();
+}
+
+template <typename T>
+template <class Container>
+void Tape<T>::Forward(const Point<T, Container>& p)
+{
+    if (p.size() != inputs.size())
+        throw std::invalid_argument("Size of point is not equal count of inputs of the tape.");
+
+    T* v = values.data();
+
+    for (size_t i{}; i < inputs.size(); ++i)
+        v[inputs[i]] = p.Eval(i);
+
+    for (size_t i{}; i < nodes.size(); ++i)
+    {
+        const Node& n = nodes[i];
+
+        switch (n.op)
+        {
+        case Op::Input:
+            break;
+        case Op::Add: v[i] = v[n.a] + v[n.b]; break;
+        case Op::Sub: v[i] = v[n.a] - v[n.b]; break;
+        case Op::Mul: v[i] = v[n.a] * v[n.b]; break;
+        case Op::Div: v[i] = v[n.a] / v[n.b]; break;
+        case Op::Neg: v[i] = -v[n.a]; break;
+        case Op::AddC: v[i] = v[n.a] + n.c; break;
+        case Op::MulC: v[i] = v[n.a] * n.c; break;
+        case Op::SubFromC: v[i] = n.c - v[n.a]; break;
+        case Op::DivIntoC: v[i] = n.c / v[n.a]; break;
+        case Op::Sin: v[i] = std::sin(v[n.a]); break;
+        case Op::Cos: v[i] = std::cos(v[n.a]); break;
+        case Op::Exp: v[i] = std::exp(v[n.a]); break;
+        case Op::Log: v[i] = std::log(v[n.a]); break;
+        case Op::Sqrt: v[i] = std::sqrt(v[n.a]); break;
+        case Op::PowC: v[i] = std::pow(v[n.a], n.c); break;
+        }
+    }
+}
+
+template <typename T>
+template <class Container>
+void Tape<T>::Reverse(uint32_t output, Point<T, Container>& gradient)
+{
+    adjoints.assign(nodes.size(), T{});
+    adjoints[output] = static_cast<T>(1);
+
+    const T* v = values.data();
+    T* adj = adjoints.data();
+
+    for (size_t i = output + 1; i-- > 0;)
+    {
+        const Node& n = nodes[i];
+        const T g = adj[i];
+
+        switch (n.op)
+        {
+        case Op::Input:
+            break;
+        case Op::Add: adj[n.a] += g; adj[n.b] += g; break;
+        case Op::Sub: adj[n.a] += g; adj[n.b] -= g; break;
+        case Op::Mul: adj[n.a] += g * v[n.b]; adj[n.b] += g * v[n.a]; break;
+        case Op::Div: adj[n.a] += g / v[n.b]; adj[n.b] -= g * v[i] / v[n.b]; break;
+        case Op::Neg: adj[n.a] -= g; break;
+        case Op::AddC: adj[n.a] += g; break;
+        case Op::MulC: adj[n.a] += g * n.c; break;
+        case Op::SubFromC: adj[n.a] -= g; break;
+        case Op::DivIntoC: adj[n.a] -= g * v[i] / v[n.a]; break;
+        case Op::Sin: adj[n.a] += g * std::cos(v[n.a]); break;
+        case Op::Cos: adj[n.a] -= g * std::sin(v[n.a]); break;
+        case Op::Exp: adj[n.a] += g * v[i]; break;
+        case Op::Log: adj[n.a] += g / v[n.a]; break;
+        case Op::Sqrt: adj[n.a] += g * static_cast<T>(0.5) / v[i]; break;
+        case Op::PowC: adj[n.a] += g * n.c * std::pow(v[n.a], n.c - 1); break;
+        }
+    }
+
+    gradient.Resize(inputs.size());
+
+    for (size_t i{}; i < inputs.size(); ++i)
+        gradient[i] = adj[inputs[i]];
+}
+
+/// @brief Function which computes its gradient by reverse-mode automatic differentiation.
+/// @details The tape is recorded on the first gradient and recorded again only if the dimension changes.
+/// The tape is not thread-safe: use one function per thread.
+/// @tparam T Typename for a value of a function.
+/// @tparam Objective Functor with a template call operator over points of T and of TapeVar<T>.
+template <typename T, class Objective>
+class ReverseDiffFunction : public GeneralFunction<T>
+{
+private:
+    Objective objective;
+    mutable Tape<T> tape;
+    mutable uint32_t output;
+
+    /// @brief Records the tape if it is not recorded for the dimension of a point.
+    void Record(const Point<T>& p) const;
+public:
+    /// @brief Constructor of a function.
+    /// @param[in] _objective Objective of a function.
+    ReverseDiffFunction(const Objective& _objective = Objective()) : objective(_objective), output(0) {}
+
+    T Value(const Point<T>& p) const override;
+    Point<T> Gradient(const Point<T>& p) const override;
+    T ValueAndGradient(const Point<T>& p, Point<T>& gradient) const override;
+
+    inline const Tape<T>& getTape() const { return tape; }
+};
+
+template <typename T, class Objective>
+void ReverseDiffFunction<T, Objective>::Record(const Point<T>& p) const
+{
+    if (tape.getSize() && tape.getInputCount() == p.size())
+        return;
+
+    tape.Clear();
+
+    std::vector<TapeVar<T>> x;
+    x.reserve(p.size());
+
+    for (size_t i{}; i < p.size(); ++i)
+        x.emplace_back(&tape, tape.Input(p[i]));
+
+    output = objective(Point<TapeVar<T>>(x)).Index();
+}
+
+template <typename T, class Objective>
+T ReverseDiffFunction<T, Objective>::Value(const Point<T>& p) const
+{
+    return objective(p);
+}
+
+template <typename T, class Objective>
+Point<T> ReverseDiffFunction<T, Objective>::Gradient(const Point<T>& p) const
+{
+    Point<T> gradient;
+    ValueAndGradient(p, gradient);
+
+    return gradient;
+}
+
+template <typename T, class Objective>
+T ReverseDiffFunction<T, Objective>::ValueAndGradient(const Point<T>& p, Point<T>& gradient) const
+{
+    Record(p);
+    tape.Forward(p);
+    tape.Reverse(output, gradient);
+
+    return tape.getValue(output);
+}
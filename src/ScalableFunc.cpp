@@ -0,0 +1,716 @@
+#include <array>
+#include <cmath>
+#include "PointKernels.h"
+#include "ScalableFunc.h"
+
+namespace
+{
+    /// @brief Buffers of a thread for transformed coordinates and gradients. They grow to the largest dimension and are reused.
+    enum Slot { SlotZ, SlotGradient, SlotProduct };
+
+    double* Scratch(Slot slot, size_t n)
+    {
+        thread_local std::array<std::vector<double>, 3> buffers;
+
+        if (buffers[slot].size() < n)
+            buffers[slot].resize(n);
+
+        return buffers[slot].data();
+    }
+
+    /// @brief Sum of term(i) for i from 0 to n.
+    /// @details Eight partial sums are independent, so the loop is vectorized without reassociation of the sum.
+    template <class Term>
+    [[gnu::always_inline]] inline double Sum(size_t n, Term term)
+    {
+        double acc[8]{};
+        size_t i{};
+
+        for (; i + 8 <= n; i += 8)
+            for (size_t k{}; k < 8; ++k)
+                acc[k] += term(i + k);
+
+        for (; i < n; ++i)
+            acc[0] += term(i);
+
+        return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+    }
+
+    CubicArea<double> Box(size_t dim, double min, double max)
+    {
+        CubicArea<double> res;
+        res.minArea.Resize(dim);
+        res.maxArea.Resize(dim);
+        res.minArea.Fill(min);
+        res.maxArea.Fill(max);
+
+        return res;
+    }
+
+    /// @brief Random orthogonal matrix n x n (row-major): Gram-Schmidt orthogonalization of a Gaussian matrix.
+    std::vector<double> RandomOrthogonal(size_t n, std::mt19937& generator)
+    {
+        std::normal_distribution<double> distr;
+        std::vector<double> q(n * n);
+
+        for (double& a : q)
+            a = distr(generator);
+
+        for (size_t r{}; r < n; ++r)
+        {
+            double* row = q.data() + r * n;
+
+            // Two passes of projection keep rows orthogonal in floating point.
+            for (int pass{}; pass < 2; ++pass)
+                for (size_t k{}; k < r; ++k)
+                {
+                    const double* prev = q.data() + k * n;
+                    PointKernels::Axpy(-PointKernels::Dot(row, prev, n), prev, row, row, n);
+                }
+
+            PointKernels::Scale(1 / PointKernels::Norm(row, n), row, row, n);
+        }
+
+        return q;
+    }
+
+    /// @brief Transposed square matrix n x n.
+    std::vector<double> Transposed(const std::vector<double>& m, size_t n)
+    {
+        std::vector<double> res(n * n);
+
+        for (size_t r{}; r < n; ++r)
+            for (size_t c{}; c < n; ++c)
+                res[c * n + r] = m[r * n + c];
+
+        return res;
+    }
+
+    /// @brief Computes out = M * in for one block, columns of M are stored one after another.
+    /// @details The product is a sum of columns, so the inner loop is contiguous and vectorized.
+    [[gnu::always_inline]] inline void MultiplyBlock(const double* columns, size_t n, const double* in, double* out)
+    {
+        for (size_t r{}; r < n; ++r)
+            out[r] = 0;
+
+        for (size_t c{}; c < n; ++c)
+        {
+            const double a = in[c];
+            const double* column = columns + c * n;
+
+            for (size_t r{}; r < n; ++r)
+                out[r] += a * column[r];
+        }
+    }
+
+    /// @brief Computes out = M * in for the block-diagonal matrix. In and out are different arrays.
+    /// @param columns Columns of a full block.
+    /// @param lastColumns Columns of the last incomplete block.
+    VECTORIZED void MultiplyBlocks(const double* columns, const double* lastColumns, size_t block, const double* in, double* out, size_t n)
+    {
+        size_t i{};
+
+        for (; i + block <= n; i += block)
+            MultiplyBlock(columns, block, in + i, out + i);
+
+        if (i < n)
+            MultiplyBlock(lastColumns, n - i, in + i, out + i);
+    }
+
+    // Loops of the functions over coordinates.
+
+    VECTORIZED double RosenbrockValue(const double* z, size_t n)
+    {
+        return Sum(n - 1, [z](size_t i)
+        {
+            const double a = 1 - z[i], b = z[i + 1] - z[i] * z[i];
+
+            return 100 * b * b + a * a;
+        });
+    }
+
+    VECTORIZED double RosenbrockGradient(const double* z, double* g, size_t n)
+    {
+        const double value = Sum(n - 1, [z, g](size_t i)
+        {
+            const double a = 1 - z[i], b = z[i + 1] - z[i] * z[i];
+
+            g[i] = -400 * z[i] * b - 2 * a;
+
+            return 100 * b * b + a * a;
+        });
+
+        g[n - 1] = 0;
+
+        for (size_t i = 1; i < n; ++i)
+            g[i] += 200 * (z[i] - z[i - 1] * z[i - 1]);
+
+        return value;
+    }
+
+    VECTORIZED double RastriginValue(const double* z, size_t n)
+    {
+        return 10 * static_cast<double>(n) + Sum(n, [z](size_t i) { return z[i] * z[i] - 10 * std::cos(2 * M_PI * z[i]); });
+    }
+
+    VECTORIZED double RastriginGradient(const double* z, double* g, size_t n)
+    {
+        return 10 * static_cast<double>(n) + Sum(n, [z, g](size_t i)
+        {
+            const double t = 2 * M_PI * z[i];
+
+            g[i] = 2 * z[i] + 20 * M_PI * std::sin(t);
+
+            return z[i] * z[i] - 10 * std::cos(t);
+        });
+    }
+
+    VECTORIZED void AckleySums(const double* z, size_t n, double& squares, double& cosines)
+    {
+        squares = Sum(n, [z](size_t i) { return z[i] * z[i]; });
+        cosines = Sum(n, [z](size_t i) { return std::cos(2 * M_PI * z[i]); });
+    }
+
+    VECTORIZED void AckleyGradient(const double* z, double* g, size_t n, double a, double b)
+    {
+        for (size_t i{}; i < n; ++i)
+            g[i] = a * z[i] + b * std::sin(2 * M_PI * z[i]);
+    }
+
+    VECTORIZED double SquaresValue(const double* z, const double* factors, size_t n)
+    {
+        return Sum(n, [z, factors](size_t i) { return factors[i] * z[i] * z[i]; });
+    }
+
+    VECTORIZED double SquaresGradient(const double* z, const double* factors, double* g, size_t n)
+    {
+        return Sum(n, [z, factors, g](size_t i)
+        {
+            g[i] = 2 * factors[i] * z[i];
+
+            return factors[i] * z[i] * z[i];
+        });
+    }
+
+    VECTORIZED double SumSquares(const double* z, size_t n)
+    {
+        return Sum(n, [z](size_t i) { return z[i] * z[i]; });
+    }
+
+    VECTORIZED void Cosines(const double* z, const double* scale, double* c, size_t n)
+    {
+        for (size_t i{}; i < n; ++i)
+            c[i] = std::cos(z[i] * scale[i]);
+    }
+
+    VECTORIZED double StyblinskiTangValue(const double* z, size_t n)
+    {
+        return Sum(n, [z](size_t i)
+        {
+            const double s = z[i] * z[i];
+
+            return 0.5 * (s * s - 16 * s + 5 * z[i]);
+        });
+    }
+
+    VECTORIZED double StyblinskiTangGradient(const double* z, double* g, size_t n)
+    {
+        return Sum(n, [z, g](size_t i)
+        {
+            const double s = z[i] * z[i];
+
+            g[i] = 2 * s * z[i] - 16 * z[i] + 2.5;
+
+            return 0.5 * (s * s - 16 * s + 5 * z[i]);
+        });
+    }
+
+    VECTORIZED double ChainValue(const double* z, size_t n)
+    {
+        return (1 - z[0]) * (1 - z[0]) + Sum(n - 1, [z](size_t i) { return (z[i] - z[i + 1]) * (z[i] - z[i + 1]); });
+    }
+
+    VECTORIZED double ChainGradient(const double* z, double* g, size_t n)
+    {
+        const double value = (1 - z[0]) * (1 - z[0]) + Sum(n - 1, [z, g](size_t i)
+        {
+            const double d = z[i] - z[i + 1];
+
+            g[i] = 2 * d;
+
+            return d * d;
+        });
+
+        g[n - 1] = 0;
+        g[0] -= 2 * (1 - z[0]);
+
+        for (size_t i = 1; i < n; ++i)
+            g[i] -= 2 * (z[i - 1] - z[i]);
+
+        return value;
+    }
+    VECTORIZED void RosenbrockHessianVector(const double* z, const double* v, double* r, size_t n)
+    {
+        for (size_t i{}; i + 1 < n; ++i)
+            r[i] = (1200 * z[i] * z[i] - 400 * z[i + 1] + 2) * v[i] - 400 * z[i] * v[i + 1];
+
+        r[n - 1] = 0;
+
+        for (size_t i = 1; i < n; ++i)
+            r[i] += 200 * v[i] - 400 * z[i - 1] * v[i - 1];
+    }
+
+    VECTORIZED void RastriginHessianVector(const double* z, const double* v, double* r, size_t n)
+    {
+        for (size_t i{}; i < n; ++i)
+            r[i] = (2 + 40 * M_PI * M_PI * std::cos(2 * M_PI * z[i])) * v[i];
+    }
+
+    VECTORIZED void AckleyProducts(const double* z, const double* v, size_t n, double& zv, double& sv)
+    {
+        zv = Sum(n, [z, v](size_t i) { return z[i] * v[i]; });
+        sv = Sum(n, [z, v](size_t i) { return std::sin(2 * M_PI * z[i]) * v[i]; });
+    }
+
+    /// @brief Computes r = a v + b cos(2pi z) v + c z + d sin(2pi z).
+    VECTORIZED void AckleyHessianVector(const double* z, const double* v, double* r, size_t n, double a, double b, double c, double d)
+    {
+        for (size_t i{}; i < n; ++i)
+        {
+            const double t = 2 * M_PI * z[i];
+
+            r[i] = (a + b * std::cos(t)) * v[i] + c * z[i] + d * std::sin(t);
+        }
+    }
+
+    VECTORIZED void StyblinskiTangHessianVector(const double* z, const double* v, double* r, size_t n)
+    {
+        for (size_t i{}; i < n; ++i)
+            r[i] = (6 * z[i] * z[i] - 16) * v[i];
+    }
+
+    VECTORIZED void SquaresHessianVector(const double* factors, const double* v, double* r, size_t n)
+    {
+        for (size_t i{}; i < n; ++i)
+            r[i] = 2 * factors[i] * v[i];
+    }
+
+    VECTORIZED void ChainHessianVector(const double* v, double* r, size_t n)
+    {
+        for (size_t i{}; i + 1 < n; ++i)
+            r[i] = 2 * (v[i] - v[i + 1]);
+
+        r[n - 1] = 0;
+        r[0] += 2 * v[0];
+
+        for (size_t i = 1; i < n; ++i)
+            r[i] += 2 * (v[i] - v[i - 1]);
+    }
+}
+
+F_ND::ScalableFunction::ScalableFunction(size_t _dim) : dim(_dim), block(0)
+{
+    if (!dim)
+        throw std::invalid_argument("Dimension of the function must be positive.");
+}
+
+void F_ND::ScalableFunction::CheckPoint(const Point<double>& p) const
+{
+    if (p.size() != dim)
+        throw std::invalid_argument("Dimension of the point is not equal dimension of the function.");
+}
+
+void F_ND::ScalableFunction::SetShift(const Point<double>& _shift)
+{
+    if (_shift.size() && _shift.size() != dim)
+        throw std::invalid_argument("Dimension of the shift is not equal dimension of the function.");
+
+    shift.assign(_shift.begin(), _shift.end());
+}
+
+void F_ND::ScalableFunction::SetRandomShift(size_t seed)
+{
+    const CubicArea<double> area = getArea();
+    std::mt19937 generator(static_cast<std::mt19937::result_type>(seed));
+
+    shift.resize(dim);
+
+    for (size_t i{}; i < dim; ++i)
+    {
+        const double margin = (area.maxArea[i] - area.minArea[i]) / 4;
+
+        shift[i] = std::uniform_real_distribution<double>(area.minArea[i] + margin, area.maxArea[i] - margin)(generator);
+    }
+}
+
+void F_ND::ScalableFunction::SetRotation(size_t _block, size_t seed)
+{
+    std::mt19937 generator(static_cast<std::mt19937::result_type>(seed));
+
+    block = std::min(_block, dim);
+    rotation = block ? RandomOrthogonal(block, generator) : std::vector<double>();
+    rotationLast = block ? RandomOrthogonal(dim % block, generator) : std::vector<double>();
+    columns = Transposed(rotation, block);
+    columnsLast = block ? Transposed(rotationLast, dim % block) : std::vector<double>();
+}
+
+const double* F_ND::ScalableFunction::Transform(const double* x, double* z) const
+{
+    if (shift.empty() && !block)
+        return x;
+
+    const double optimum = OptimumCoordinate();
+    double* d = block ? Scratch(SlotGradient, dim) : z;
+
+    if (shift.empty())
+        std::copy(x, x + dim, d);
+    else
+        for (size_t i{}; i < dim; ++i)
+            d[i] = x[i] - shift[i];
+
+    // Without the shift the rotation is around the optimum of the base function.
+    if (block)
+    {
+        if (shift.empty())
+            for (size_t i{}; i < dim; ++i)
+                d[i] -= optimum;
+
+        MultiplyBlocks(columns.data(), columnsLast.data(), block, d, z, dim);
+    }
+
+    for (size_t i{}; i < dim; ++i)
+        z[i] += optimum;
+
+    return z;
+}
+
+void F_ND::ScalableFunction::TransformGradient(const double* gz, double* gx) const
+{
+    // Rows of R are columns of R^T.
+    MultiplyBlocks(rotation.data(), rotationLast.data(), block, gz, gx, dim);
+}
+
+double F_ND::ScalableFunction::Value(const Point<double>& p) const
+{
+    CheckPoint(p);
+
+    return ValueOf(Transform(p.Data(), Scratch(SlotZ, dim)));
+}
+
+Point<double> F_ND::ScalableFunction::Gradient(const Point<double>& p) const
+{
+    Point<double> gradient;
+    ValueAndGradient(p, gradient);
+
+    return gradient;
+}
+
+double F_ND::ScalableFunction::ValueAndGradient(const Point<double>& p, Point<double>& gradient) const
+{
+    CheckPoint(p);
+    gradient.Resize(dim);
+
+    const double* z = Transform(p.Data(), Scratch(SlotZ, dim));
+
+    // The shift does not change the gradient, the rotation is applied back to it.
+    if (!block)
+        return ValueAndGradientOf(z, gradient.Data());
+
+    double* gz = Scratch(SlotGradient, dim);
+    const double value = ValueAndGradientOf(z, gz);
+    TransformGradient(gz, gradient.Data());
+
+    return value;
+}
+
+void F_ND::ScalableFunction::HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const
+{
+    CheckPoint(p);
+    CheckPoint(v);
+
+    const double* z = Transform(p.Data(), Scratch(SlotZ, dim));
+    result.Resize(dim);
+
+    // For the rotation H_x v = R^T H_z (R v).
+    if (!block)
+    {
+        if (!HessianVectorOf(z, v.Data(), result.Data()))
+            GeneralFunction<double>::HessianVectorProduct(p, v, result);
+
+        return;
+    }
+
+    double* rv = Scratch(SlotGradient, dim);
+    double* hz = Scratch(SlotProduct, dim);
+    MultiplyBlocks(columns.data(), columnsLast.data(), block, v.Data(), rv, dim);
+
+    if (!HessianVectorOf(z, rv, hz))
+    {
+        GeneralFunction<double>::HessianVectorProduct(p, v, result);
+
+        return;
+    }
+
+    TransformGradient(hz, result.Data());
+}
+
+Point<double> F_ND::ScalableFunction::getOptimum() const
+{
+    if (!shift.empty())
+        return Point<double>(shift);
+
+    Point<double> res;
+    res.Resize(dim);
+    res.Fill(OptimumCoordinate());
+
+    return res;
+}
+
+F_ND::FuncRosenbrock::FuncRosenbrock(size_t _dim) : ScalableFunction(_dim)
+{
+    if (_dim < 2)
+        throw std::invalid_argument("Dimension of the Rosenbrock function must be at least 2.");
+}
+
+double F_ND::FuncRosenbrock::ValueOf(const double* z) const
+{
+    return RosenbrockValue(z, getDimension());
+}
+
+double F_ND::FuncRosenbrock::ValueAndGradientOf(const double* z, double* gradient) const
+{
+    return RosenbrockGradient(z, gradient, getDimension());
+}
+
+bool F_ND::FuncRosenbrock::HessianVectorOf(const double* z, const double* v, double* result) const
+{
+    RosenbrockHessianVector(z, v, result, getDimension());
+
+    return true;
+}
+
+CubicArea<double> F_ND::FuncRosenbrock::getArea() const
+{
+    return Box(getDimension(), -5, 10);
+}
+
+double F_ND::FuncRastrigin::ValueOf(const double* z) const
+{
+    return RastriginValue(z, getDimension());
+}
+
+double F_ND::FuncRastrigin::ValueAndGradientOf(const double* z, double* gradient) const
+{
+    return RastriginGradient(z, gradient, getDimension());
+}
+
+bool F_ND::FuncRastrigin::HessianVectorOf(const double* z, const double* v, double* result) const
+{
+    RastriginHessianVector(z, v, result, getDimension());
+
+    return true;
+}
+
+CubicArea<double> F_ND::FuncRastrigin::getArea() const
+{
+    return Box(getDimension(), -5.12, 5.12);
+}
+
+double F_ND::FuncAckley::ValueOf(const double* z) const
+{
+    const double n = static_cast<double>(getDimension());
+    double squares, cosines;
+    AckleySums(z, getDimension(), squares, cosines);
+
+    return -20 * std::exp(-0.2 * std::sqrt(squares / n)) - std::exp(cosines / n) + 20 + M_E;
+}
+
+double F_ND::FuncAckley::ValueAndGradientOf(const double* z, double* gradient) const
+{
+    const double n = static_cast<double>(getDimension());
+    double squares, cosines;
+    AckleySums(z, getDimension(), squares, cosines);
+
+    const double r = std::sqrt(squares / n), first = std::exp(-0.2 * r), second = std::exp(cosines / n);
+
+    AckleyGradient(z, gradient, getDimension(), r > 0 ? 4 * first / (n * r) : 0, 2 * M_PI * second / n);
+
+    return -20 * first - second + 20 + M_E;
+}
+
+bool F_ND::FuncAckley::HessianVectorOf(const double* z, const double* v, double* result) const
+{
+    // The gradient is a(r) z + b sin(2pi z), the derivatives of the factors a and b give two terms of rank one.
+    const size_t dim = getDimension();
+    const double n = static_cast<double>(dim);
+    double squares, cosines, zv, sv;
+    AckleySums(z, dim, squares, cosines);
+    AckleyProducts(z, v, dim, zv, sv);
+
+    const double r = std::sqrt(squares / n), first = std::exp(-0.2 * r), second = std::exp(cosines / n);
+    const double b = 2 * M_PI * second / n;
+
+    if (r > 0)
+    {
+        const double a = 4 * first / (n * r), da = -4 * first * (0.2 * r + 1) / (n * n * r * r * r);
+
+        AckleyHessianVector(z, v, result, dim, a, 2 * M_PI * b, da * zv, -2 * M_PI * b * sv / n);
+    }
+    else
+        AckleyHessianVector(z, v, result, dim, 0, 2 * M_PI * b, 0, -2 * M_PI * b * sv / n);
+
+    return true;
+}
+
+CubicArea<double> F_ND::FuncAckley::getArea() const
+{
+    return Box(getDimension(), -32.768, 32.768);
+}
+
+F_ND::FuncGriewank::FuncGriewank(size_t _dim) : ScalableFunction(_dim), scale(_dim)
+{
+    for (size_t i{}; i < _dim; ++i)
+        scale[i] = 1 / std::sqrt(static_cast<double>(i + 1));
+}
+
+double F_ND::FuncGriewank::ValueOf(const double* z) const
+{
+    const size_t n = getDimension();
+    double* c = Scratch(SlotProduct, n);
+    double product = 1;
+
+    Cosines(z, scale.data(), c, n);
+
+    for (size_t i{}; i < n; ++i)
+        product *= c[i];
+
+    return 1 + SumSquares(z, n) / 4000 - product;
+}
+
+double F_ND::FuncGriewank::ValueAndGradientOf(const double* z, double* gradient) const
+{
+    // The derivative of the product by z_i is the product of the other cosines: prefix and suffix products
+    // avoid the division by a cosine which can be zero.
+    const size_t n = getDimension();
+    double* c = Scratch(SlotProduct, n);
+    double prefix = 1, suffix = 1;
+
+    Cosines(z, scale.data(), c, n);
+
+    for (size_t i{}; i < n; ++i)
+    {
+        gradient[i] = prefix;
+        prefix *= c[i];
+    }
+
+    for (size_t i = n; i-- > 0;)
+    {
+        gradient[i] = z[i] / 2000 + scale[i] * std::sin(z[i] * scale[i]) * gradient[i] * suffix;
+        suffix *= c[i];
+    }
+
+    return 1 + SumSquares(z, n) / 4000 - prefix;
+}
+
+CubicArea<double> F_ND::FuncGriewank::getArea() const
+{
+    return Box(getDimension(), -600, 600);
+}
+
+double F_ND::FuncStyblinskiTang::ValueOf(const double* z) const
+{
+    return StyblinskiTangValue(z, getDimension());
+}
+
+double F_ND::FuncStyblinskiTang::ValueAndGradientOf(const double* z, double* gradient) const
+{
+    return StyblinskiTangGradient(z, gradient, getDimension());
+}
+
+bool F_ND::FuncStyblinskiTang::HessianVectorOf(const double* z, const double* v, double* result) const
+{
+    StyblinskiTangHessianVector(z, v, result, getDimension());
+
+    return true;
+}
+
+double F_ND::FuncStyblinskiTang::OptimumCoordinate() const
+{
+    // The smaller root of 2z^3 - 16z + 2.5 = 0 by the Newton method.
+    static const double root = []
+    {
+        double z = -3;
+
+        for (int i{}; i < 50; ++i)
+            z -= (2 * z * z * z - 16 * z + 2.5) / (6 * z * z - 16);
+
+        return z;
+    }();
+
+    return root;
+}
+
+double F_ND::FuncStyblinskiTang::getOptimumValue() const
+{
+    const double z = OptimumCoordinate(), s = z * z;
+
+    return 0.5 * (s * s - 16 * s + 5 * z) * static_cast<double>(getDimension());
+}
+
+CubicArea<double> F_ND::FuncStyblinskiTang::getArea() const
+{
+    return Box(getDimension(), -5, 5);
+}
+
+F_ND::FuncQuadratic::FuncQuadratic(size_t _dim, double _condition) : ScalableFunction(_dim), factors(_dim), condition(_condition)
+{
+    if (!(condition >= 1))
+        throw std::invalid_argument("Condition number of the quadratic function must be at least 1.");
+
+    for (size_t i{}; i < _dim; ++i)
+        factors[i] = _dim > 1 ? std::pow(condition, static_cast<double>(i) / static_cast<double>(_dim - 1)) : 1;
+}
+
+double F_ND::FuncQuadratic::ValueOf(const double* z) const
+{
+    return SquaresValue(z, factors.data(), getDimension());
+}
+
+double F_ND::FuncQuadratic::ValueAndGradientOf(const double* z, double* gradient) const
+{
+    return SquaresGradient(z, factors.data(), gradient, getDimension());
+}
+
+bool F_ND::FuncQuadratic::HessianVectorOf(const double*, const double* v, double* result) const
+{
+    SquaresHessianVector(factors.data(), v, result, getDimension());
+
+    return true;
+}
+
+CubicArea<double> F_ND::FuncQuadratic::getArea() const
+{
+    return Box(getDimension(), -5, 5);
+}
+
+double F_ND::FuncQuadraticChain::ValueOf(const double* z) const
+{
+    return ChainValue(z, getDimension());
+}
+
+double F_ND::FuncQuadraticChain::ValueAndGradientOf(const double* z, double* gradient) const
+{
+    return ChainGradient(z, gradient, getDimension());
+}
+
+bool F_ND::FuncQuadraticChain::HessianVectorOf(const double*, const double* v, double* result) const
+{
+    ChainHessianVector(v, result, getDimension());
+
+    return true;
+}
+
+CubicArea<double> F_ND::FuncQuadraticChain::getArea() const
+{
+    return Box(getDimension(), -5, 5);
+}
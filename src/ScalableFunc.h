@@ -0,0 +1,216 @@
+/// @file
+/// @brief Benchmark functions of any dimension.
+/// @details File contains the definition of Rosenbrock, Rastrigin, Ackley, Griewank, Styblinski-Tang
+/// and quadratic functions for an arbitrary dimension with known optima.
+/// A function is evaluated in transformed coordinates z = R(x - o) + z*, where z* is the optimum of the base function,
+/// o is the shift and R is a rotation. Without a shift o = z*, so the base function is evaluated as is.
+/// With any shift the optimum is x* = o. The rotation is block-diagonal: one random orthogonal block
+/// is repeated along the diagonal, so it costs O(N * block) time and O(block^2) memory and scales to millions of dimensions.
+/// Formulas are loops over contiguous arrays of coordinates, they are vectorized in ScalableFunc.cpp.
+#pragma once
+
+#include <vector>
+#include "Optimization.h"
+
+namespace F_ND
+{
+    /// @brief Abstract class for benchmark functions of any dimension with the shift and the rotation.
+    class ScalableFunction : public GeneralFunction<double>
+    {
+    private:
+        size_t dim;
+        /// @brief Shift o. It is empty if the function is not shifted.
+        std::vector<double> shift;
+        size_t block;
+        /// @brief Orthogonal matrix block x block (row-major) and the matrix of the last incomplete block.
+        std::vector<double> rotation;
+        std::vector<double> rotationLast;
+        /// @brief The same matrices stored by columns.
+        std::vector<double> columns;
+        std::vector<double> columnsLast;
+
+        void CheckPoint(const Point<double>& p) const;
+
+        /// @brief Computes z = R(x - o) + z*.
+        /// @return Pointer to z: x itself if there is no transformation, otherwise z.
+        const double* Transform(const double* x, double* z) const;
+
+        /// @brief Computes the gradient by x from the gradient by z: gx = R^T gz.
+        void TransformGradient(const double* gz, double* gx) const;
+    protected:
+        /// @brief Value of the base function in z.
+        virtual double ValueOf(const double* z) const = 0;
+
+        /// @brief Value and gradient of the base function in z.
+        /// @param[in] z Coordinates.
+        /// @param[out] gradient Gradient of the size of the dimension.
+        virtual double ValueAndGradientOf(const double* z, double* gradient) const = 0;
+
+        /// @brief Product of the Hessian of the base function in z and a vector.
+        /// @return False if there is no analytic product, then differences of gradients are used.
+        virtual bool HessianVectorOf(const double*, const double*, double*) const { return false; }
+
+        /// @brief Every coordinate of the optimum of the base function.
+        virtual double OptimumCoordinate() const = 0;
+    public:
+        /// @brief Constructor of a function.
+        /// @param[in] _dim Dimension of a function.
+        ScalableFunction(size_t _dim);
+
+        /// @brief Sets the optimum of the function.
+        /// @param[in] _shift Point of the optimum. Empty point removes the shift.
+        void SetShift(const Point<double>& _shift);
+
+        /// @brief Sets the random shift. Every coordinate of the optimum is uniform in [min + margin, max - margin] of the area,
+        /// where margin is a quarter of the width, so the optimum is not near the boundary.
+        /// @param[in] seed Seed of the generator.
+        void SetRandomShift(size_t seed);
+
+        /// @brief Sets the random rotation around the optimum.
+        /// @param[in] _block Size of blocks of the rotation. Zero removes the rotation, a size not less than
+        /// the dimension gives a full rotation.
+        /// @param[in] seed Seed of the generator.
+        void SetRotation(size_t _block, size_t seed);
+
+        double Value(const Point<double>& p) const override;
+        Point<double> Gradient(const Point<double>& p) const override;
+        double ValueAndGradient(const Point<double>& p, Point<double>& gradient) const override;
+        void HessianVectorProduct(const Point<double>& p, const Point<double>& v, Point<double>& result) const override;
+
+        inline size_t getDimension() const { return dim; }
+        inline size_t getRotationBlock() const { return block; }
+
+        /// @brief Point of the global minimum.
+        Point<double> getOptimum() const;
+
+        /// @brief Value of the global minimum.
+        virtual double getOptimumValue() const { return 0; }
+
+        /// @brief Conventional area for a search.
+        virtual CubicArea<double> getArea() const = 0;
+
+        /// @brief Name of the function.
+        virtual const char* getName() const = 0;
+    };
+
+    /// @brief Rosenbrock function: sum of 100(z_{i+1} - z_i^2)^2 + (1 - z_i)^2. Minimum 0 at z = (1, ..., 1).
+    /// @details Unlike F_2D::FuncRosenbrock it has the conventional factor 100. The dimension must be at least 2.
+    class FuncRosenbrock final : public ScalableFunction
+    {
+    protected:
+        double ValueOf(const double* z) const override;
+        double ValueAndGradientOf(const double* z, double* gradient) const override;
+        bool HessianVectorOf(const double* z, const double* v, double* result) const override;
+        double OptimumCoordinate() const override { return 1; }
+    public:
+        FuncRosenbrock(size_t _dim);
+
+        CubicArea<double> getArea() const override;
+        const char* getName() const override { return "Rosenbrock"; }
+    };
+
+    /// @brief Rastrigin function: 10N + sum of z_i^2 - 10cos(2pi z_i). Minimum 0 at z = 0.
+    class FuncRastrigin final : public ScalableFunction
+    {
+    protected:
+        double ValueOf(const double* z) const override;
+        double ValueAndGradientOf(const double* z, double* gradient) const override;
+        bool HessianVectorOf(const double* z, const double* v, double* result) const override;
+        double OptimumCoordinate() const override { return 0; }
+    public:
+        FuncRastrigin(size_t _dim) : ScalableFunction(_dim) {}
+
+        CubicArea<double> getArea() const override;
+        const char* getName() const override { return "Rastrigin"; }
+    };
+
+    /// @brief Ackley function: -20exp(-0.2sqrt(mean of z_i^2)) - exp(mean of cos(2pi z_i)) + 20 + e. Minimum 0 at z = 0.
+    /// @details The gradient in the minimum is set to zero, the Hessian there has only the part of cosines.
+    class FuncAckley final : public ScalableFunction
+    {
+    protected:
+        double ValueOf(const double* z) const override;
+        double ValueAndGradientOf(const double* z, double* gradient) const override;
+        bool HessianVectorOf(const double* z, const double* v, double* result) const override;
+        double OptimumCoordinate() const override { return 0; }
+    public:
+        FuncAckley(size_t _dim) : ScalableFunction(_dim) {}
+
+        CubicArea<double> getArea() const override;
+        const char* getName() const override { return "Ackley"; }
+    };
+
+    /// @brief Griewank function: 1 + sum of z_i^2 / 4000 - product of cos(z_i / sqrt(i + 1)). Minimum 0 at z = 0.
+    /// @details The Hessian is dense, its products with vectors are differences of gradients.
+    class FuncGriewank final : public ScalableFunction
+    {
+    private:
+        /// @brief Factors 1 / sqrt(i + 1).
+        std::vector<double> scale;
+    protected:
+        double ValueOf(const double* z) const override;
+        double ValueAndGradientOf(const double* z, double* gradient) const override;
+        double OptimumCoordinate() const override { return 0; }
+    public:
+        FuncGriewank(size_t _dim);
+
+        CubicArea<double> getArea() const override;
+        const char* getName() const override { return "Griewank"; }
+    };
+
+    /// @brief Styblinski-Tang function: sum of (z_i^4 - 16z_i^2 + 5z_i) / 2. Minimum about -39.166N at z_i = -2.9035.
+    class FuncStyblinskiTang final : public ScalableFunction
+    {
+    protected:
+        double ValueOf(const double* z) const override;
+        double ValueAndGradientOf(const double* z, double* gradient) const override;
+        bool HessianVectorOf(const double* z, const double* v, double* result) const override;
+        double OptimumCoordinate() const override;
+    public:
+        FuncStyblinskiTang(size_t _dim) : ScalableFunction(_dim) {}
+
+        double getOptimumValue() const override;
+        CubicArea<double> getArea() const override;
+        const char* getName() const override { return "Styblinski-Tang"; }
+    };
+
+    /// @brief Ellipsoid: sum of c_i z_i^2 with c_i = condition^(i / (N - 1)). Minimum 0 at z = 0.
+    /// @details The condition number of the Hessian is the parameter condition.
+    class FuncQuadratic final : public ScalableFunction
+    {
+    private:
+        std::vector<double> factors;
+        double condition;
+    protected:
+        double ValueOf(const double* z) const override;
+        double ValueAndGradientOf(const double* z, double* gradient) const override;
+        bool HessianVectorOf(const double* z, const double* v, double* result) const override;
+        double OptimumCoordinate() const override { return 0; }
+    public:
+        /// @brief Constructor of a function.
+        /// @param[in] _dim Dimension of a function.
+        /// @param[in] _condition Ratio of the largest and the smallest factor. It must be at least 1.
+        FuncQuadratic(size_t _dim, double _condition = 1e3);
+
+        inline double getCondition() const { return condition; }
+
+        CubicArea<double> getArea() const override;
+        const char* getName() const override { return "Quadratic"; }
+    };
+
+    /// @brief Chain quadratic: (1 - z_0)^2 + sum of (z_i - z_{i+1})^2. Minimum 0 at z = (1, ..., 1).
+    /// @details It is F_4D::FuncQuadratic1 for any dimension. The condition number grows as N^2.
+    class FuncQuadraticChain final : public ScalableFunction
+    {
+    protected:
+        double ValueOf(const double* z) const override;
+        double ValueAndGradientOf(const double* z, double* gradient) const override;
+        bool HessianVectorOf(const double* z, const double* v, double* result) const override;
+        double OptimumCoordinate() const override { return 1; }
+    public:
+        FuncQuadraticChain(size_t _dim) : ScalableFunction(_dim) {}
+
+        CubicArea<double> getArea() const override;
+        const char* getName() const override { return "Quadratic chain"; }
+    };
+}
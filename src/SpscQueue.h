@@ -0,0 +1,106 @@
+/// @file
+/// @brief Realization of a lock-free queue for one producer and one consumer.
+/// @details File contains the definition of a bounded ring buffer. One thread pushes and one thread pops,
+/// neither of them waits for the other. Indexes of the producer and of the consumer are on different cache lines,
+/// and every side remembers the last seen index of the other side, so atomics of the other side are read only
+/// when the queue looks full or empty. Elements are assigned into slots, so slots keep their storage between laps.
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/// @brief Bounded lock-free queue for one producer and one consumer.
+/// @tparam T Typename of an element.
+template <typename T>
+class SpscQueue
+{
+private:
+    static constexpr size_t LINE = 64;
+
+    std::vector<T> buffer;
+    size_t mask;
+    /// @brief Index of the next pop and the index of the next push seen by the consumer. They are written by the consumer.
+    alignas(LINE) std::atomic<size_t> head{0};
+    size_t cachedTail{0};
+    /// @brief Index of the next push and the index of the next pop seen by the producer. They are written by the producer.
+    alignas(LINE) std::atomic<size_t> tail{0};
+    size_t cachedHead{0};
+public:
+    /// @brief Constructor of a queue.
+    /// @param capacity Minimum count of elements. It is rounded up to a power of two.
+    explicit SpscQueue(size_t capacity)
+    {
+        if (!capacity)
+            throw std::invalid_argument("Capacity must be greater than zero.");
+
+        buffer.resize(std::bit_ceil(capacity));
+        mask = buffer.size() - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    inline size_t getCapacity() const { return buffer.size(); }
+
+    /// @brief Pushes an element. It is called only by the producer.
+    /// @param value Value which is assigned to an element.
+    /// @return False if the queue is full.
+    template <class U>
+    bool TryPush(const U& value)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+
+        if (t - cachedHead == buffer.size())
+        {
+            cachedHead = head.load(std::memory_order_acquire);
+
+            if (t - cachedHead == buffer.size())
+                return false;
+        }
+
+        buffer[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /// @brief Pops an element. It is called only by the consumer.
+    /// @param value Element.
+    /// @return False if the queue is empty.
+    bool TryPop(T& value)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+
+        if (h == cachedTail)
+        {
+            cachedTail = tail.load(std::memory_order_acquire);
+
+            if (h == cachedTail)
+                return false;
+        }
+
+        value = buffer[h & mask];
+        head.store(h + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /// @brief Calls f for every element in the queue and pops them. It is called only by the consumer.
+    /// @return Count of elements.
+    template <class F>
+    size_t Drain(F&& f)
+    {
+        const size_t h = head.load(std::memory_order_relaxed), t = tail.load(std::memory_order_acquire);
+
+        for (size_t i{h}; i < t; ++i)
+            f(static_cast<const T&>(buffer[i & mask]));
+
+        cachedTail = t;
+        head.store(t, std::memory_order_release);
+
+        return t - h;
+    }
+};
@@ -0,0 +1,168 @@
+/// @file
+/// @brief Statically dispatched optimization of functions with known formulas.
+/// @details File contains the Conjugate Vector Method which evaluates a concrete function type
+/// through its static formulas instead of the virtual interface, so evaluations in the line search are inlined.
+/// OptimizeStatic chooses the instantiation for the functions of MathFunc.h at runtime and falls back
+/// to the virtual interface for other functions.
+#pragma once
+
+#include <concepts>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "FixedOptim.h"
+#include "MathFunc.h"
+#include "OptMethod.h"
+
+/// @brief Function with static formulas of a value and of a value with a gradient.
+/// @tparam F Type of a function.
+/// @tparam T Typename for a value of a function.
+/// @tparam Container Container for a storage of point's coordinate.
+template <class F, typename T, class Container>
+concept StaticFunction = std::derived_from<F, GeneralFunction<T, Container>> &&
+    requires(const Point<T, Container>& p, Point<T, Container>& gradient)
+    {
+        { F::ValueImpl(p) } -> std::convertible_to<T>;
+        { F::ValueAndGradientImpl(p, gradient) } -> std::convertible_to<T>;
+    };
+
+/// @brief Class of the Conjugate Vector Method with static dispatch of evaluations.
+/// @details Evaluations call the formulas of F directly. They are not cached and not timed, getSummary counts them
+/// once per iteration, so EvalStop sees them.
+/// @tparam F Type of a function.
+/// @tparam T Typename for a value of a function.
+/// @tparam Container Container for a storage of point's coordinate.
+template <class F, typename T = double, class Container = std::vector<T>>
+    requires StaticFunction<F, T, Container>
+class StaticDetermOptimization : public DetermOptimization<T, Container>
+{
+private:
+    /// @brief Evaluator with the formulas of F. Evaluations are serial, so counters are plain.
+    struct Formulas
+    {
+        size_t* values;
+        size_t* gradients;
+
+        T Value(const Point<T, Container>& p) const
+        {
+            ++*values;
+
+            return F::ValueImpl(p);
+        }
+
+        T ValueAndGradient(const Point<T, Container>& p, Point<T, Container>& gradient) const
+        {
+            ++*gradients;
+
+            return F::ValueAndGradientImpl(p, gradient);
+        }
+    };
+
+    /// @brief Evaluations of the current iteration.
+    size_t values = 0;
+    size_t gradients = 0;
+
+    static void CheckFunction(GeneralFunction<T, Container>& _f)
+    {
+        if (!dynamic_cast<F*>(&_f))
+            throw std::invalid_argument("Function does not have the type of the static optimization.");
+    }
+
+    /// @brief Adds evaluations of the iteration to the counters of the summary.
+    void Flush()
+    {
+        this->getInstrument().AddCalls(FunctionCall::Value, std::exchange(values, 0));
+        this->getInstrument().AddCalls(FunctionCall::ValueAndGradient, std::exchange(gradients, 0));
+    }
+protected:
+    Point<T, Container> NextPoint(const Point<T, Container>& point) override
+    {
+        Point<T, Container> res = this->NextPointWith(Formulas{&values, &gradients}, point);
+
+        Flush();
+
+        return res;
+    }
+
+    void SetStart(const Point<T, Container>& startPoint) override
+    {
+        values = gradients = 0;
+        this->SetStartWith(Formulas{&values, &gradients}, startPoint);
+        Flush();
+    }
+public:
+    /// @brief Constructor of optimization of the Conjugate Vector Method.
+    /// @param[in] _f Function for optimization. It must have the type F.
+    /// @param[in] _stopIteration Stopper for stoping.
+    /// @param[in] _epsilon Condition of stopping for one dimension optimization.
+    /// @param[in] _epsilonStep Step width in one dimension optimization.
+    /// @param[in] _lineSearch Search along the conjugate vector.
+    StaticDetermOptimization(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration, const T& _epsilon, const T& _epsilonStep,
+                             LineSearchMode _lineSearch = LineSearchMode::Brent)
+        : DetermOptimization<T, Container>(_f, _stopIteration, _epsilon, _epsilonStep, _lineSearch)
+    {
+        CheckFunction(_f);
+    }
+
+    void SetParam(GeneralFunction<T, Container>& _f, GeneralStop<T, Container>& _stopIteration, const T& _epsilon, const T& _epsilonStep,
+                  LineSearchMode _lineSearch = LineSearchMode::Brent)
+    {
+        CheckFunction(_f);
+        DetermOptimization<T, Container>::SetParam(_f, _stopIteration, _epsilon, _epsilonStep, _lineSearch);
+    }
+};
+
+/// @brief Template of StaticDetermOptimization for a given function, in the form which OptimizeInDimension takes.
+template <class F>
+struct StaticMethod
+{
+    template <typename T, class Container>
+    using type = StaticDetermOptimization<F, T, Container>;
+};
+
+/// @brief Runs the static optimization if the function has the type F.
+/// @param[out] res Result of the optimization.
+/// @return True if the function has the type F.
+template <class F, size_t N>
+bool OptimizeAs(GeneralFunction<double>& f, GeneralStop<double>& stop, const CubicArea<double>& area, const Point<double>& start, size_t cache,
+                double epsilon, double epsilonStep, LineSearchMode lineSearch, RunResult<double>& res)
+{
+    F* concrete = dynamic_cast<F*>(&f);
+
+    if (!concrete || start.size() != N)
+        return false;
+
+    res = OptimizeInDimension<StaticMethod<F>::template type, N>(static_cast<FunctionN<double, N>&>(*concrete), stop, area, start, cache,
+                                                                  epsilon, epsilonStep, lineSearch);
+
+    return true;
+}
+
+/// @brief Runs the Conjugate Vector Method. Functions of MathFunc.h are evaluated without virtual dispatch
+/// on points of a fixed dimension, other functions through the virtual interface (see OptimizeFixed).
+/// @param f Function for optimization.
+/// @param stop Stopper. It sees states of points in std::vector.
+/// @param area Area for optimization.
+/// @param start Start point of a pathway.
+/// @param cache Capacity of the cache of evaluations, 0 disables it. Static formulas are not cached.
+/// @param epsilon Condition of stopping for one dimension optimization.
+/// @param epsilonStep Step width in one dimension optimization.
+/// @param lineSearch Search along the conjugate vector.
+/// @return Pathway and summary of the optimization.
+inline RunResult<double> OptimizeStatic(GeneralFunction<double>& f, GeneralStop<double>& stop, const CubicArea<double>& area,
+                                        const Point<double>& start, size_t cache, double epsilon, double epsilonStep,
+                                        LineSearchMode lineSearch = LineSearchMode::Brent)
+{
+    RunResult<double> res;
+
+    if (OptimizeAs<F_2D::FuncQuadratic1, 2>(f, stop, area, start, cache, epsilon, epsilonStep, lineSearch, res) ||
+        OptimizeAs<F_2D::FuncRosenbrock, 2>(f, stop, area, start, cache, epsilon, epsilonStep, lineSearch, res) ||
+        OptimizeAs<F_2D::FuncSinSin, 2>(f, stop, area, start, cache, epsilon, epsilonStep, lineSearch, res) ||
+        OptimizeAs<F_2D::FuncHimmelblau, 2>(f, stop, area, start, cache, epsilon, epsilonStep, lineSearch, res) ||
+        OptimizeAs<F_2D::FuncNull, 2>(f, stop, area, start, cache, epsilon, epsilonStep, lineSearch, res) ||
+        OptimizeAs<F_3D::FuncQuadratic1, 3>(f, stop, area, start, cache, epsilon, epsilonStep, lineSearch, res) ||
+        OptimizeAs<F_4D::FuncQuadratic1, 4>(f, stop, area, start, cache, epsilon, epsilonStep, lineSearch, res))
+        return res;
+
+    return OptimizeFixed<DetermOptimization>(f, stop, area, start, cache, epsilon, epsilonStep, lineSearch);
+}
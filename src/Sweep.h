@@ -0,0 +1,465 @@
+/// @file
+/// @brief Parallel search of parameters of optimization methods.
+/// @details File contains the sweep engine. A configuration is a vector of values of parameters, the engine creates a method
+/// of a configuration by a factory. Every configuration is run on every start point of every problem. A run stops when
+/// the value reaches the known minimum plus the tolerance, when the budget of evaluations would be exceeded
+/// or after the maximum count of iterations. The cost of a run is its count of evaluations if it reached the tolerance
+/// and twice the budget otherwise (penalized average), so configurations are ranked by evaluations to the tolerance
+/// and failures are punished.
+///
+/// Strategies:
+/// - grid and random: configurations race over runs. After the runs of every problem, a configuration
+///   whose mean cost exceeds the best mean cost times the pruning factor is terminated;
+/// - successive halving: random configurations are run with a small budget, the best 1 / eta of them are run again
+///   with the budget times eta and so on up to the full budget.
+///
+/// Decisions are made after all live configurations finished a step, and the run i of every configuration gets the seed seed + i,
+/// so results do not depend on the count of threads. The functions are shared by threads, so their evaluations must be thread-safe.
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <numeric>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "DiffStoper.h"
+#include "Optimization.h"
+#include "ThreadPool.h"
+
+/// @brief Strategy of the search.
+enum class SweepStrategy { Grid, Random, SuccessiveHalving };
+
+/// @brief Range of a parameter.
+template <typename T>
+struct SweepParam
+{
+    std::string name;
+    T min;
+    T max;
+    /// @brief Values are spread uniformly by the logarithm.
+    bool log = false;
+    /// @brief Count of values of the grid.
+    size_t count = 5;
+};
+
+/// @brief Problem: a function with its area, start points and the known minimum.
+template <typename T>
+struct SweepProblem
+{
+    std::string name;
+    GeneralFunction<T>* f;
+    CubicArea<T> area;
+    std::vector<Point<T>> starts;
+    T minimum{};
+};
+
+/// @brief Result of a configuration.
+template <typename T>
+struct SweepResult
+{
+    std::vector<T> values;
+    /// @brief Count of finished runs and count of runs which reached the tolerance.
+    size_t runs = 0;
+    size_t solved = 0;
+    /// @brief Mean evaluations to the tolerance of solved runs.
+    double evaluations = 0;
+    /// @brief Mean cost of finished runs.
+    double cost = 0;
+    /// @brief Budget of evaluations of the last runs.
+    size_t budget = 0;
+    /// @brief The configuration was pruned before the last step of the search.
+    bool terminated = false;
+    /// @brief Step of the termination: count of runs of the race or count of rungs of the successive halving.
+    size_t step = 0;
+};
+
+/// @brief Engine of the search of parameters.
+/// @tparam T Typename for a value of a function.
+template <typename T = double>
+class Sweep
+{
+public:
+    /// @brief Factory of a method of a configuration. It gets the function, the stopper and values of parameters.
+    using MethodFactory = std::function<std::unique_ptr<Optimization<T>>(GeneralFunction<T>&, GeneralStop<T>&, const std::vector<T>&)>;
+private:
+    /// @brief Run: a problem and a start point.
+    struct Run
+    {
+        const SweepProblem<T>* problem;
+        const Point<T>* start;
+    };
+
+    /// @brief Outcome of a run.
+    struct Outcome
+    {
+        size_t evaluations = 0;
+        bool solved = false;
+    };
+
+    MethodFactory makeMethod;
+    std::vector<SweepParam<T>> params;
+    ThreadPool* pool;
+    T tolerance;
+    size_t budget;
+    size_t maxStep;
+    double prune;
+    size_t eta;
+
+    void CorrectField();
+
+    Outcome RunOne(const std::vector<T>& values, const Run& run, size_t runBudget, size_t seed) const;
+
+    /// @brief Adds the outcome of a run to the result.
+    static void Add(SweepResult<T>& result, const Outcome& outcome);
+
+    void Race(std::vector<SweepResult<T>>& results, const std::vector<Run>& runs, size_t seed);
+
+    void Halving(std::vector<SweepResult<T>>& results, const std::vector<Run>& runs, size_t seed);
+public:
+    /// @brief Constructor of the engine.
+    /// @param[in] _makeMethod Factory of a method.
+    /// @param[in] _params Ranges of parameters in order of values of the factory.
+    /// @param[in] _pool Pool of threads.
+    /// @param[in] _tolerance Gap to the minimum which a run must reach.
+    /// @param[in] _budget Evaluations of a run.
+    /// @param[in] _maxStep Maximum count of iterations of a run.
+    /// @param[in] _prune Pruning factor of the race. Zero disables pruning.
+    /// @param[in] _eta Reduction of the successive halving.
+    Sweep(MethodFactory _makeMethod, std::vector<SweepParam<T>> _params, ThreadPool& _pool, const T& _tolerance, size_t _budget,
+          size_t _maxStep = 1000, double _prune = 4, size_t _eta = 3);
+
+    void SetParam(MethodFactory _makeMethod, std::vector<SweepParam<T>> _params, ThreadPool& _pool, const T& _tolerance, size_t _budget,
+                  size_t _maxStep = 1000, double _prune = 4, size_t _eta = 3);
+
+    /// @brief Configurations of the grid: all combinations of values of parameters.
+    std::vector<std::vector<T>> Grid() const;
+
+    /// @brief Random configurations.
+    std::vector<std::vector<T>> Random(size_t count, size_t seed) const;
+
+    /// @brief Searches parameters.
+    /// @param[in] problems Problems.
+    /// @param[in] strategy Strategy.
+    /// @param[in] count Count of configurations of the random search and of the successive halving. The grid ignores it.
+    /// @param[in] seed Seed of configurations and of runs.
+    /// @return Configurations from the best one: not terminated before terminated, then by the cost.
+    std::vector<SweepResult<T>> Search(const std::vector<SweepProblem<T>>& problems, SweepStrategy strategy, size_t count = 0, size_t seed = 0);
+
+    inline const std::vector<SweepParam<T>>& getParams() const { return params; }
+};
+
+template <typename T>
+void Sweep<T>::CorrectField()
+{
+    if (!makeMethod)
+        throw std::invalid_argument("Factory must be set.");
+
+    if (params.empty())
+        throw std::invalid_argument("Sweep must have parameters.");
+
+    for (const SweepParam<T>& param : params)
+    {
+        if (param.min > param.max)
+            throw std::invalid_argument("Minimum of " + param.name + " must not be greater than maximum.");
+
+        if (param.log && param.min <= 0)
+            throw std::invalid_argument("Logarithmic range of " + param.name + " must be positive.");
+
+        if (!param.count)
+            throw std::invalid_argument("Grid of " + param.name + " must have values.");
+    }
+
+    if (tolerance <= 0)
+        throw std::invalid_argument("Tolerance must be greater than zero.");
+
+    if (!budget)
+        throw std::invalid_argument("Budget must be greater than zero.");
+
+    if (prune != 0 && prune < 1)
+        throw std::invalid_argument("Pruning factor must be zero or not less than 1.");
+
+    if (eta < 2)
+        throw std::invalid_argument("Reduction must be not less than 2.");
+}
+
+template <typename T>
+Sweep<T>::Sweep(MethodFactory _makeMethod, std::vector<SweepParam<T>> _params, ThreadPool& _pool, const T& _tolerance, size_t _budget,
+                size_t _maxStep, double _prune, size_t _eta)
+    : makeMethod(std::move(_makeMethod)), params(std::move(_params)), pool(&_pool), tolerance(_tolerance), budget(_budget),
+      maxStep(_maxStep), prune(_prune), eta(_eta)
+{
+    CorrectField();
+}
+
+template <typename T>
+void Sweep<T>::SetParam(MethodFactory _makeMethod, std::vector<SweepParam<T>> _params, ThreadPool& _pool, const T& _tolerance, size_t _budget,
+                        size_t _maxStep, double _prune, size_t _eta)
+{
+    makeMethod = std::move(_makeMethod);
+    params = std::move(_params);
+    pool = &_pool;
+    tolerance = _tolerance;
+    budget = _budget;
+    maxStep = _maxStep;
+    prune = _prune;
+    eta = _eta;
+
+    CorrectField();
+}
+
+template <typename T>
+std::vector<std::vector<T>> Sweep<T>::Grid() const
+{
+    std::vector<std::vector<T>> res(1);
+
+    for (const SweepParam<T>& param : params)
+    {
+        std::vector<std::vector<T>> next;
+
+        for (const std::vector<T>& prefix : res)
+            for (size_t i{}; i < param.count; ++i)
+            {
+                const double u = param.count > 1 ? static_cast<double>(i) / static_cast<double>(param.count - 1) : 0.5;
+                std::vector<T> values = prefix;
+
+                values.push_back(param.log ? static_cast<T>(std::exp(std::log(param.min) + u * (std::log(param.max) - std::log(param.min))))
+                                           : static_cast<T>(param.min + u * (param.max - param.min)));
+                next.push_back(std::move(values));
+            }
+
+        res = std::move(next);
+    }
+
+    return res;
+}
+
+template <typename T>
+std::vector<std::vector<T>> Sweep<T>::Random(size_t count, size_t seed) const
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<std::vector<T>> res(count);
+
+    for (std::vector<T>& values : res)
+        for (const SweepParam<T>& param : params)
+        {
+            const double u = unit(generator);
+
+            values.push_back(param.log ? static_cast<T>(std::exp(std::log(param.min) + u * (std::log(param.max) - std::log(param.min))))
+                                       : static_cast<T>(param.min + u * (param.max - param.min)));
+        }
+
+    return res;
+}
+
+template <typename T>
+typename Sweep<T>::Outcome Sweep<T>::RunOne(const std::vector<T>& values, const Run& run, size_t runBudget, size_t seed) const
+{
+    // Stoppers are constructed before their combination, which reads their maximum steps.
+    NumStop<T> num(maxStep);
+    EvalStop<T> eval(runBudget);
+    TargetStop<T> target(run.problem->minimum + tolerance);
+    AnyOf<T> stop({&num, &eval, &target});
+
+    std::unique_ptr<Optimization<T>> method = makeMethod(*run.problem->f, stop, values);
+
+    method->SetArea(run.problem->area.minArea, run.problem->area.maxArea);
+    method->SetSeed(seed);
+    method->DoOptimize(*run.start);
+
+    const RunSummary<T> summary = method->getSummary();
+
+    return {summary.evaluations, summary.valueEnd <= run.problem->minimum + tolerance};
+}
+
+template <typename T>
+void Sweep<T>::Add(SweepResult<T>& result, const Outcome& outcome)
+{
+    const double cost = outcome.solved ? static_cast<double>(outcome.evaluations) : 2.0 * static_cast<double>(result.budget);
+
+    result.cost = (result.cost * result.runs + cost) / (result.runs + 1);
+    ++result.runs;
+
+    if (outcome.solved)
+    {
+        result.evaluations = (result.evaluations * result.solved + outcome.evaluations) / (result.solved + 1);
+        ++result.solved;
+    }
+}
+
+template <typename T>
+void Sweep<T>::Race(std::vector<SweepResult<T>>& results, const std::vector<Run>& runs, size_t seed)
+{
+    std::vector<size_t> live(results.size());
+    std::iota(live.begin(), live.end(), size_t{});
+
+    std::vector<Outcome> outcomes(results.size());
+
+    for (size_t r{}; r < runs.size() && !live.empty(); ++r)
+    {
+        pool->ParallelFor(live.size(), [this, &results, &runs, &live, &outcomes, r, seed](size_t i)
+        {
+            outcomes[live[i]] = RunOne(results[live[i]].values, runs[r], budget, seed + r);
+        });
+
+        double best = std::numeric_limits<double>::max();
+
+        for (const size_t c : live)
+        {
+            Add(results[c], outcomes[c]);
+            best = std::min(best, results[c].cost);
+        }
+
+        // Configurations are compared when all starts of a problem are finished, so one hard start does not terminate them.
+        if (!prune || r + 1 == runs.size() || runs[r + 1].problem == runs[r].problem)
+            continue;
+
+        // Costs are means over the same runs, so they are compared directly.
+        std::erase_if(live, [this, &results, best, r](size_t c)
+        {
+            if (results[c].cost <= prune * best)
+                return false;
+
+            results[c].terminated = true;
+            results[c].step = r + 1;
+
+            return true;
+        });
+    }
+}
+
+template <typename T>
+void Sweep<T>::Halving(std::vector<SweepResult<T>>& results, const std::vector<Run>& runs, size_t seed)
+{
+    size_t rungs = 1;
+
+    for (size_t n = results.size(); n > eta; n = (n + eta - 1) / eta)
+        ++rungs;
+
+    std::vector<size_t> live(results.size());
+    std::iota(live.begin(), live.end(), size_t{});
+
+    for (size_t rung{}; rung < rungs; ++rung)
+    {
+        size_t rungBudget = budget;
+
+        for (size_t i = rung + 1; i < rungs; ++i)
+            rungBudget = std::max<size_t>(1, rungBudget / eta);
+
+        std::vector<Outcome> outcomes(live.size() * runs.size());
+
+        for (const size_t c : live)
+            results[c] = {results[c].values, 0, 0, 0, 0, rungBudget, false, rung + 1};
+
+        pool->ParallelFor(outcomes.size(), [this, &results, &runs, &live, &outcomes, rungBudget, seed](size_t i)
+        {
+            const size_t c = live[i / runs.size()], r = i % runs.size();
+
+            outcomes[i] = RunOne(results[c].values, runs[r], rungBudget, seed + r);
+        });
+
+        for (size_t i{}; i < outcomes.size(); ++i)
+            Add(results[live[i / runs.size()]], outcomes[i]);
+
+        if (rung + 1 == rungs)
+            break;
+
+        std::stable_sort(live.begin(), live.end(), [&results](size_t a, size_t b) { return results[a].cost < results[b].cost; });
+
+        const size_t keep = std::max<size_t>(1, live.size() / eta);
+
+        for (size_t i = keep; i < live.size(); ++i)
+            results[live[i]].terminated = true;
+
+        live.resize(keep);
+        std::sort(live.begin(), live.end());
+    }
+}
+
+template <typename T>
+std::vector<SweepResult<T>> Sweep<T>::Search(const std::vector<SweepProblem<T>>& problems, SweepStrategy strategy, size_t count, size_t seed)
+{
+    std::vector<Run> runs;
+
+    for (const SweepProblem<T>& problem : problems)
+        for (const Point<T>& start : problem.starts)
+            runs.push_back({&problem, &start});
+
+    if (runs.empty())
+        throw std::invalid_argument("Sweep must have start points.");
+
+    const std::vector<std::vector<T>> configs = strategy == SweepStrategy::Grid ? Grid() : Random(count, seed);
+    std::vector<SweepResult<T>> results(configs.size());
+
+    for (size_t i{}; i < configs.size(); ++i)
+    {
+        results[i].values = configs[i];
+        results[i].budget = budget;
+    }
+
+    if (strategy == SweepStrategy::SuccessiveHalving)
+        Halving(results, runs, seed);
+    else
+        Race(results, runs, seed);
+
+    // Configurations which went further are better, ties are broken by the cost and by the order of generation.
+    std::vector<size_t> order(results.size());
+    std::iota(order.begin(), order.end(), size_t{});
+    std::stable_sort(order.begin(), order.end(), [&results](size_t a, size_t b)
+    {
+        const SweepResult<T>& x = results[a];
+        const SweepResult<T>& y = results[b];
+
+        if (x.terminated != y.terminated)
+            return !x.terminated;
+
+        if (x.step != y.step)
+            return x.step > y.step;
+
+        return x.cost < y.cost;
+    });
+
+    std::vector<SweepResult<T>> res;
+    res.reserve(results.size());
+
+    for (const size_t i : order)
+        res.push_back(std::move(results[i]));
+
+    return res;
+}
+
+/// @brief Prints the ranked table of configurations.
+/// @param[out] out Stream.
+/// @param[in] params Parameters.
+/// @param[in] results Results of Sweep::Search.
+/// @param[in] rows Maximum count of rows. Zero means all.
+template <typename T>
+void PrintSweep(std::ostream& out, const std::vector<SweepParam<T>>& params, const std::vector<SweepResult<T>>& results, size_t rows = 0)
+{
+    out << std::setw(5) << "rank";
+
+    for (const SweepParam<T>& param : params)
+        out << std::setw(13) << param.name;
+
+    out << std::setw(10) << "solved" << std::setw(14) << "evaluations" << std::setw(14) << "cost" << std::setw(10) << "budget"
+        << "  status" << std::endl;
+
+    for (size_t i{}; i < results.size() && (!rows || i < rows); ++i)
+    {
+        const SweepResult<T>& res = results[i];
+
+        out << std::setw(5) << i + 1;
+
+        for (const T& value : res.values)
+            out << std::setw(13) << std::setprecision(4) << value;
+
+        out << std::setw(10) << (std::to_string(res.solved) + "/" + std::to_string(res.runs)) << std::fixed << std::setprecision(1)
+            << std::setw(14) << res.evaluations << std::setw(14) << res.cost << std::defaultfloat << std::setw(10) << res.budget << "  "
+            << (res.terminated ? "terminated at " + std::to_string(res.step) : "complete") << std::endl;
+    }
+}
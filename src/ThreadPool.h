@@ -0,0 +1,244 @@
+/// @file
+/// @brief Realization of a pool of threads.
+/// @details File contains the definition of a pool of worker threads with a parallel loop.
+/// Iterations of a loop are balanced between threads by work stealing.
+/// The thread which calls ParallelFor also executes iterations, so nested loops do not deadlock.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/// @brief Pool of worker threads.
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stop;
+
+    void Work()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return stop || !tasks.empty(); });
+
+                if (stop && tasks.empty())
+                    return;
+
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+
+    /// @brief State of one parallel loop. It is shared with helpers which may start after the loop is finished.
+    /// @details Iterations are split into one range per thread. A thread takes iterations from the front of its range
+    /// and, when it is empty, steals the back half of the largest range of other threads.
+    /// A range is packed into one atomic word, so taking and stealing are single compare-and-swap operations.
+    struct Loop
+    {
+        std::vector<std::atomic<uint64_t>> ranges;
+        /// @brief Count of slots taken by threads. It is not named slots, because Qt defines slots as a macro.
+        std::atomic<size_t> taken{0};
+        std::atomic<size_t> done{0};
+        size_t count;
+        std::function<void(size_t, size_t)> body;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable finished;
+
+        static uint64_t Pack(uint32_t begin, uint32_t end) { return (static_cast<uint64_t>(end) << 32) | begin; }
+        static uint32_t Begin(uint64_t range) { return static_cast<uint32_t>(range); }
+        static uint32_t End(uint64_t range) { return static_cast<uint32_t>(range >> 32); }
+
+        Loop(size_t _count, size_t threads, std::function<void(size_t, size_t)> _body)
+            : ranges(threads), count(_count), body(std::move(_body))
+        {
+            for (size_t i{}; i < threads; ++i)
+                ranges[i] = Pack(static_cast<uint32_t>(count * i / threads), static_cast<uint32_t>(count * (i + 1) / threads));
+        }
+
+        /// @brief Takes the first iteration of the range of a slot.
+        bool Pop(size_t slot, size_t& index)
+        {
+            uint64_t range = ranges[slot].load();
+
+            while (Begin(range) < End(range))
+                if (ranges[slot].compare_exchange_weak(range, Pack(Begin(range) + 1, End(range))))
+                {
+                    index = Begin(range);
+
+                    return true;
+                }
+
+            return false;
+        }
+
+        /// @brief Moves the back half of the largest range of other slots into the empty range of a slot.
+        bool Steal(size_t slot)
+        {
+            for (;;)
+            {
+                size_t victim = slot;
+                uint32_t largest = 0;
+
+                for (size_t i{}; i < ranges.size(); ++i)
+                    if (const uint64_t range = ranges[i].load(); i != slot && End(range) - Begin(range) > largest)
+                    {
+                        victim = i;
+                        largest = End(range) - Begin(range);
+                    }
+
+                if (victim == slot)
+                    return false;
+
+                uint64_t range = ranges[victim].load();
+                const uint32_t begin = Begin(range), end = End(range), middle = begin + (end - begin) / 2;
+
+                if (begin < end && ranges[victim].compare_exchange_strong(range, Pack(begin, middle)))
+                {
+                    ranges[slot] = Pack(middle, end);
+
+                    return true;
+                }
+            }
+        }
+
+        void Run()
+        {
+            const size_t slot = taken.fetch_add(1);
+
+            // Helpers which start after all slots are taken have nothing to do.
+            if (slot >= ranges.size())
+                return;
+
+            size_t i;
+
+            for (;;)
+            {
+                if (!Pop(slot, i))
+                {
+                    if (!Steal(slot))
+                        return;
+
+                    continue;
+                }
+
+                try
+                {
+                    body(i, slot);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+
+                    if (!error)
+                        error = std::current_exception();
+                }
+
+                if (done.fetch_add(1) + 1 == count)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finished.notify_all();
+                }
+            }
+        }
+    };
+public:
+    /// @brief Constructor of a pool.
+    /// @param threads Count of worker threads. Zero means that all iterations are executed by the calling thread.
+    explicit ThreadPool(size_t threads = std::max(1u, std::thread::hardware_concurrency()) - 1) : stop(false)
+    {
+        for (size_t i{}; i < threads; ++i)
+            workers.emplace_back([this] { Work(); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+
+        condition.notify_all();
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    /// @brief Count of threads which execute a parallel loop: workers and the calling thread.
+    inline size_t getSize() const { return workers.size() + 1; }
+
+    /// @brief Puts a task into the queue.
+    void Post(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+
+        condition.notify_one();
+    }
+
+    /// @brief Calls body(i) for all i from 0 to count - 1 and waits for the end.
+    /// @details The first exception thrown by the body is rethrown in the calling thread.
+    /// @param count Count of iterations.
+    /// @param body Body of the loop.
+    void ParallelFor(size_t count, std::function<void(size_t)> body)
+    {
+        ParallelForSlot(count, [&body](size_t i, size_t) { body(i); });
+    }
+
+    /// @brief Calls body(i, slot) for all i from 0 to count - 1 and waits for the end.
+    /// @details The slot is less than getSize() and only one thread uses a slot during the loop,
+    /// so the body may keep per-thread state in an array indexed by slots.
+    /// The first exception thrown by the body is rethrown in the calling thread.
+    /// @param count Count of iterations. It must be less than 2^32.
+    /// @param body Body of the loop.
+    void ParallelForSlot(size_t count, std::function<void(size_t, size_t)> body)
+    {
+        if (!count)
+            return;
+
+        if (count > std::numeric_limits<uint32_t>::max())
+            throw std::invalid_argument("Count of iterations of a parallel loop is too large.");
+
+        const size_t helpers = std::min(workers.size(), count - 1);
+        auto loop = std::make_shared<Loop>(count, helpers + 1, std::move(body));
+
+        for (size_t i{}; i < helpers; ++i)
+            Post([loop] { loop->Run(); });
+
+        loop->Run();
+
+        {
+            std::unique_lock<std::mutex> lock(loop->mutex);
+            loop->finished.wait(lock, [&loop] { return loop->done == loop->count; });
+        }
+
+        if (loop->error)
+            std::rethrow_exception(loop->error);
+    }
+};
@@ -1,5 +1,6 @@
 #include <QObject>
 #include <QMessageBox>
+#include <QScreen>
 #include <fstream>
 #include "gui_optim.h"
 #include "ui_gui_optim.h"
@@ -11,29 +12,40 @@ GUI_Optim::GUI_Optim(std::vector<FunctionData<double>>& _f, QWidget *parent) :
     QMainWindow(parent),
     set(_f),
     drawBack(false),
+    solving(false),
     ui(new Ui::GUI_Optim)
 {
     ui->setupUi(this);
 
     scene = new MyGraphicsScene(ui->GraphicsFunction);
+    redrawTimer = new QTimer(this);
 
     ui->GraphicsFunction->setRenderHints(QPainter::Antialiasing);
     ui->GraphicsFunction->setScene(scene);
 
     QObject::connect(scene, &MyGraphicsScene::signalTargetCoordinate, this, &GUI_Optim::press_mouse_scene);
     QObject::connect(&set, &Settings::okButtonPress, this, &GUI_Optim::on_actionOptimize_triggered);
+    QObject::connect(redrawTimer, &QTimer::timeout, this, &GUI_Optim::drainPath);
     ui->statusbar->addWidget(new QLabel(copyright));
     set.setModal(true);
 }
 
 GUI_Optim::~GUI_Optim()
 {
+    async.Cancel();
     delete scene;
     delete ui;
 }
 
 void GUI_Optim::on_actionSettings_triggered()
 {
+    // The dialog changes the function, methods and stoppers, so the run must not use them.
+    if (solving)
+    {
+        async.Cancel();
+        finishOptimize();
+    }
+
     set.exec();
 }
 
@@ -63,25 +75,36 @@ void GUI_Optim::drawFunction()
     int height = ui->GraphicsFunction->height() / sizeRect;
     int color;
 
-    double maxValue = set.GetFunction().Value(set.GetMaxArea());
-    double minValue = maxValue, value;
+    // The grid is evaluated by one batch call. Rectangles below cover a subset of the same grid.
+    const size_t count = size_t(width + 1) * (height + 1);
+    std::vector<double> gridX(count), gridY(count), values(count);
+    const double* grid[] = {gridX.data(), gridY.data()};
 
     for (int i{}; i < width + 1; ++i)
     {
         for (int j{}; j < height + 1; ++j)
         {
-            value = set.GetFunction().Value(Point<double>({set.GetMinArea()[0] + (set.GetMaxArea()[0] - set.GetMinArea()[0]) * i / width, set.GetMinArea()[1] + (set.GetMaxArea()[1] - set.GetMinArea()[1]) * j / height}));
-
-            maxValue = std::max(maxValue, value);
-            minValue = std::min(minValue, value);
+            gridX[i * (height + 1) + j] = set.GetMinArea()[0] + (set.GetMaxArea()[0] - set.GetMinArea()[0]) * i / width;
+            gridY[i * (height + 1) + j] = set.GetMinArea()[1] + (set.GetMaxArea()[1] - set.GetMinArea()[1]) * j / height;
         }
     }
 
+    set.GetFunction().ValueBatch(grid, values);
+
+    double maxValue = set.GetFunction().Value(set.GetMaxArea());
+    double minValue = maxValue, value;
+
+    for (double v : values)
+    {
+        maxValue = std::max(maxValue, v);
+        minValue = std::min(minValue, v);
+    }
+
     for (int i{-width / 2}; i <= width / 2; ++i)
     {
         for (int j{-height / 2}; j <= height / 2; ++j)
         {
-            value = set.GetFunction().Value(Point<double>({set.GetMinArea()[0] + (set.GetMaxArea()[0] - set.GetMinArea()[0]) * (i + width / 2) / width, set.GetMinArea()[1] + (set.GetMaxArea()[1] - set.GetMinArea()[1]) * (j + height / 2) / height}));
+            value = values[(i + width / 2) * (height + 1) + j + height / 2];
             color = int((value - minValue) / (maxValue - minValue) * 255);
             pen.setColor(QColor(0, color, color));
             brush.setColor(QColor(0, color, color));
@@ -91,31 +114,115 @@ void GUI_Optim::drawFunction()
 
     pen.setColor(QColor(255, 0, 0));
 
-    Point<double> beg = *set.GetOptim()->getPathway().begin(), end;
+    // The pathway of the method belongs to the worker while the run is active, so points which arrived are drawn.
+    if (solving)
+    {
+        for (int i{1}; i < livePath.size(); ++i)
+            scene->addLine(QLineF(toScene(livePath[i - 1]), toScene(livePath[i])), pen);
 
-    for (size_t i{1}; i < set.GetOptim()->getPathway().size(); ++i)
+        return;
+    }
+
+    const PathwayView<double> pathway = result.pathway;
+
+    if (pathway.empty())
+        return;
+
+    PointView<double> beg = pathway.front();
+
+    for (auto it = pathway.begin() + 1; it != pathway.end(); ++it)
     {
-        end = set.GetOptim()->getPathway()[i];
+        const PointView<double> end = *it;
 
-        scene->addLine(((beg[0] - set.GetMinArea()[0]) * width / (set.GetMaxArea()[0] - set.GetMinArea()[0]) - width / 2) * sizeRect,
-                       -((beg[1] - set.GetMinArea()[1]) * height / (set.GetMaxArea()[1] - set.GetMinArea()[1]) - height / 2) * sizeRect,
-                       ((end[0] - set.GetMinArea()[0]) * width / (set.GetMaxArea()[0] - set.GetMinArea()[0]) - width / 2) * sizeRect,
-                       -((end[1] - set.GetMinArea()[1]) * height / (set.GetMaxArea()[1] - set.GetMinArea()[1]) - height / 2) * sizeRect, pen);
+        scene->addLine(QLineF(toScene(QPointF(beg[0], beg[1])), toScene(QPointF(end[0], end[1]))), pen);
 
         beg = end;
     }
 }
 
+QPointF GUI_Optim::toScene(const QPointF& point) const
+{
+    const int sizeRect = set.GetAccuracy();
+    const int width = ui->GraphicsFunction->width() / sizeRect;
+    const int height = ui->GraphicsFunction->height() / sizeRect;
+
+    return QPointF(((point.x() - set.GetMinArea()[0]) * width / (set.GetMaxArea()[0] - set.GetMinArea()[0]) - width / 2) * sizeRect,
+                   -((point.y() - set.GetMinArea()[1]) * height / (set.GetMaxArea()[1] - set.GetMinArea()[1]) - height / 2) * sizeRect);
+}
+
 void GUI_Optim::on_actionOptimize_triggered()
 {
+    // A new run aborts the current one, its results are not shown.
+    async.Cancel();
+    redrawTimer->stop();
+    solving = false;
+    livePath.clear();
+
     try
     {
         set.GetStopNum().SetParam(set.GetNumIter());
-        set.GetStopAbs().SetParam(set.GetFunction(), set.GetNumIter(), set.GetEpsilonAbs());
-        set.GetOptimDeter().SetParam(set.GetFunction(), *set.GetStoper(), set.GetEpsilon(), set.GetStep());
-        set.GetOptimStoch().SetParam(set.GetFunction(), *set.GetStoper(), set.GetProb(), set.GetDelta(), set.GetSeed(), set.GetAlpha());
-        set.GetOptim()->SetArea(set.GetMinArea(), set.GetMaxArea());
-        set.GetOptim()->DoOptimize(set.GetStart());
+        set.GetStopAbs().SetParam(set.GetNumIter(), set.GetEpsilonAbs());
+        result = RunResult<double>();
+        async.Start([this, run = set.GetRun()](GeneralStop<double>& stop) { result = run(stop); }, *set.GetStoper());
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << e.what();
+
+        return;
+    }
+
+    solving = true;
+    ui->actionCancel->setEnabled(true);
+    drawFunction();
+
+    // Points are drawn once per frame of the screen, the worker does not wait for drawing.
+    const double rate = screen() ? screen()->refreshRate() : 60.0;
+    redrawTimer->start(std::max(1, int(1000.0 / rate)));
+}
+
+void GUI_Optim::on_actionCancel_triggered()
+{
+    if (!solving)
+        return;
+
+    async.Cancel();
+    drainPath();
+}
+
+void GUI_Optim::drainPath()
+{
+    // The state is read before draining, so the last points of a finished run are drawn.
+    const bool finished = !async.IsRunning();
+    const bool draw = drawBack && set.GetMaxArea().size() == 2;
+    const QPen pen(QColor(255, 0, 0));
+
+    async.Drain([this, draw, &pen](const Point<double>& point)
+    {
+        if (point.size() < 2)
+            return;
+
+        const QPointF next(point[0], point[1]);
+
+        if (draw && !livePath.empty())
+            scene->addLine(QLineF(toScene(livePath.back()), toScene(next)), pen);
+
+        livePath.push_back(next);
+    });
+
+    if (finished)
+        finishOptimize();
+}
+
+void GUI_Optim::finishOptimize()
+{
+    redrawTimer->stop();
+    solving = false;
+    ui->actionCancel->setEnabled(false);
+
+    try
+    {
+        async.Wait();
     }
     catch (const std::exception& e)
     {
@@ -124,17 +231,33 @@ void GUI_Optim::on_actionOptimize_triggered()
 
     std::stringstream ss;
 
-    if (set.GetOptim()->getPathway().size() > 0)
+    const PathwayView<double> pathway = result.pathway;
+
+    if (!pathway.empty())
     {
-        ss << set.GetOptim()->getPathway().back();
+        ss << pathway.back();
         ui->resultPoint->setText(ss.str().c_str());
         ss.str("");
-        ss << set.GetOptim()->getValueLastPoint();
+        ss << result.summary.valueEnd;
         ui->resultValue->setText(ss.str().c_str());
         ss.str("");
-        ss << set.GetOptim()->getPathway().size();
+        ss << pathway.size();
         ui->resultCount->setText(ss.str().c_str());
         ss.str("");
+
+        const RunSummary<double>& summary = result.summary;
+        ss << summary.evaluations << " in " << summary.time / 1e6 << " ms, cache hits " << summary.cacheHits
+           << ", decrease per evaluation " << summary.DecreasePerEvaluation();
+        ui->resultEvaluations->setText(ss.str().c_str());
+        ss.str("");
+
+        for (size_t i{}; i < summary.calls.size(); ++i)
+            if (summary.calls[i].calls)
+                ss << (ss.tellp() > 0 ? "; " : "") << FunctionCallName(static_cast<FunctionCall>(i)) << ": " << summary.calls[i].calls
+                   << ", p50 " << summary.calls[i].p50 << " ns, p99 " << summary.calls[i].p99 << " ns";
+
+        ui->resultCalls->setText(ss.str().c_str());
+        ss.str("");
     }
 
     drawFunction();
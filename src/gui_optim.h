@@ -3,6 +3,9 @@
 
 #include <QMainWindow>
 #include <QGraphicsScene>
+#include <QTimer>
+#include <QVector>
+#include "AsyncOptim.h"
 #include "mygraphicsscene.h"
 #include "settings.h"
 
@@ -16,7 +19,19 @@ class GUI_Optim : public QMainWindow
 
     Settings set;
 
+    /// @brief Run of the optimization in a worker thread. It is declared after the settings, which own methods and stoppers,
+    /// so the run is stopped before they are destroyed.
+    AsyncOptimization<double> async;
+
     bool drawBack;
+    /// @brief A run is started and its results are not shown yet.
+    bool solving;
+
+    /// @brief Result of the last run. It belongs to the worker while the run is active.
+    RunResult<double> result;
+
+    /// @brief Points of the current run which arrived from the worker, in coordinates of the function.
+    QVector<QPointF> livePath;
 
 public:
     GUI_Optim(std::vector<FunctionData<double>>& _f, QWidget *parent = nullptr);
@@ -29,6 +44,11 @@ private slots:
 
     void on_actionOptimize_triggered();
 
+    void on_actionCancel_triggered();
+
+    /// @brief Draws points which arrived since the last redraw. It is called by the timer at the refresh rate of the screen.
+    void drainPath();
+
     void resizeEvent(QResizeEvent* event);
 
     void on_actionHelp_triggered();
@@ -38,8 +58,15 @@ private slots:
 private:
     void drawFunction();
 
+    /// @brief Shows results of the finished run and draws its whole pathway.
+    void finishOptimize();
+
+    /// @brief Position of a point of the function in the scene.
+    QPointF toScene(const QPointF& point) const;
+
     Ui::GUI_Optim *ui;
     MyGraphicsScene *scene;
+    QTimer *redrawTimer;
 };
 
 #endif // GUI_OPTIM_H
@@ -8,18 +8,18 @@ Settings::Settings(std::vector<FunctionData<double>>& _f, QWidget *parent) :
     f(_f),
     generator(std::chrono::system_clock::now().time_since_epoch().count()),
     numStop(),
-    absStop(_f[1].f),
-    determOptimization(_f[1].f, numStop, epsilon, epsilonStep),
-    stochastOptimization(_f[1].f, numStop, prob, delta),
+    absStop(),
     ui(new Ui::Settings)
 {
     ui->setupUi(this);
 
     MyMenuParam = {numIter, epsilon, epsilonStep, epsilonAbs, generator(), Point<double>({-1.0, -1.0}), Point<double>({1.0, 1.0}),
-                   Point<double>({0.5, 0.5}), prob, delta, alpha, &numStop, &f[0].f, &determOptimization, accuracyImg};
+                   Point<double>({0.5, 0.5}), prob, delta, alpha, cache, &numStop, &f[0].f, true, lineSearch, accuracyImg};
 
     ui->radioButtonMethod->setChecked(true);
     ui->radioButtonStoper->setChecked(true);
+    // Items of the list of line searches are in order of LineSearchMode.
+    ui->comboLineSearch->setCurrentIndex(static_cast<int>(lineSearch));
 
     for (const auto& i : f)
         ui->ListFunctions->addItem(QString(i.name.c_str()));
@@ -45,6 +45,7 @@ Settings::Settings(std::vector<FunctionData<double>>& _f, QWidget *parent) :
     ui->editProb->setText((ss.str(""), ss << prob, ss.str().c_str()));
     ui->editDelta->setText((ss.str(""), ss << delta, ss.str().c_str()));
     ui->editAccuracy->setText((ss.str(""), ss << accuracyImg, ss.str().c_str()));
+    ui->editCache->setText((ss.str(""), ss << cache, ss.str().c_str()));
 
     ui->sliderAlpha->setValue(static_cast<int>(alpha * 100));
     ui->sliderDelta->setValue(static_cast<int>(delta * 100));
@@ -249,6 +250,16 @@ bool Settings::CheckInput()
             warnings += "[Accuracy of Graph] must be less or equal than 50.\n";
     }
 
+    if (!IsIntNumb(ui->editCache->text().toStdString()))
+        warnings += "Incorrect input in [Cache of Evaluations] field.\n";
+    else
+    {
+        num = ui->editCache->text().toUInt();
+
+        if (num > 1000000)
+            warnings += "[Cache of Evaluations] must be less or equal than 1000000.\n";
+    }
+
     if (warnings == "")
         return true;
     else
@@ -273,6 +284,7 @@ bool Settings::ApplyInput()
     MyMenuParam.epsilonStep = ui->editStep->text().toDouble();
     MyMenuParam.seed = ui->editSeed->text().toUInt();
     MyMenuParam.accuracyImg = ui->editAccuracy->text().toUInt();
+    MyMenuParam.cache = ui->editCache->text().toUInt();
 
     MyMenuParam.maxArea = f[ui->ListFunctions->row(ui->ListFunctions->currentItem())].maxArea;
     MyMenuParam.minArea = f[ui->ListFunctions->row(ui->ListFunctions->currentItem())].minArea;
@@ -287,11 +299,8 @@ bool Settings::ApplyInput()
        MyMenuParam.start[i] = pointsStart[curInd][i]->text().toDouble();
     }
 
-    if (ui->radioButtonMethod->isChecked())
-        MyMenuParam.Opt = &determOptimization;
-
-    if (ui->radioButtonMethod_2->isChecked())
-        MyMenuParam.Opt = &stochastOptimization;
+    MyMenuParam.determ = ui->radioButtonMethod->isChecked();
+    MyMenuParam.lineSearch = static_cast<LineSearchMode>(ui->comboLineSearch->currentIndex());
 
     if (ui->radioButtonStoper->isChecked())
         MyMenuParam.stoper = &numStop;
@@ -309,6 +318,23 @@ bool Settings::GetDrawGraph() const
     return ui->checkDrawGraph->isChecked();
 }
 
+std::function<RunResult<double>(GeneralStop<double>&)> Settings::GetRun() const
+{
+    const MenuParam param = MyMenuParam;
+
+    return [param](GeneralStop<double>& stop)
+    {
+        const CubicArea<double> area{param.minArea, param.maxArea};
+
+        if (param.determ)
+            return OptimizeFixed<DetermOptimization>(*param.f, stop, area, param.start, param.cache, param.epsilon, param.epsilonStep,
+                                                     param.lineSearch);
+
+        return OptimizeFixed<StochastOptimization>(*param.f, stop, area, param.start, param.cache, param.prob, param.delta, param.seed,
+                                                   param.alpha);
+    };
+}
+
 void Settings::SetNewSeed()
 {
     std::stringstream ss;
@@ -475,3 +501,34 @@ void Settings::on_closeButton_clicked()
     QWidget::close();
 }
 
+
+void Settings::on_addFunctionButton_clicked()
+{
+    try
+    {
+        auto expression = std::make_unique<ExpressionFunction>(ui->editExpression->text().toStdString());
+        const size_t dim = expression->getDimension();
+
+        if (dim < 2 || dim > 4)
+            throw std::invalid_argument("Dimension of the function must be from 2 to 4.");
+
+        Point<double> minArea, maxArea, start;
+        minArea.Resize(dim);
+        maxArea.Resize(dim);
+        start.Resize(dim);
+        minArea.Fill(-1);
+        maxArea.Fill(1);
+        start.Fill(0.5);
+
+        f.push_back({expression->getText(), *expression, minArea, maxArea, start});
+        expressions.push_back(std::move(expression));
+
+        ui->ListFunctions->addItem(QString(f.back().name.c_str()));
+        ui->ListFunctions->setCurrentRow(ui->ListFunctions->count() - 1);
+        ui->editExpression->clear();
+    }
+    catch (const std::exception& e)
+    {
+        QMessageBox::warning(this, "Warning!", e.what());
+    }
+}
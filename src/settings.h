@@ -4,11 +4,15 @@
 #include <QDialog>
 #include <QLineEdit>
 #include <QListWidgetItem>
+#include <functional>
+#include <memory>
 #include <sstream>
 #include <string>
 #include "Optimization.h"
 #include "OptMethod.h"
 #include "DiffStoper.h"
+#include "Expression.h"
+#include "FixedOptim.h"
 
 namespace Ui {
 class Settings;
@@ -31,18 +35,21 @@ private:
         double prob;
         double delta;
         double alpha;
+        size_t cache;
         GeneralStop<double>* stoper;
         GeneralFunction<double>* f;
-        Optimization<double>* Opt;
+        /// @brief The Conjugate Vector Method is chosen, otherwise the random search.
+        bool determ;
+        LineSearchMode lineSearch;
         size_t accuracyImg;
     } MyMenuParam;
 
     std::vector<FunctionData<double>> f;
+    /// @brief Functions entered by the user. They are owned here and referenced by f.
+    std::vector<std::unique_ptr<ExpressionFunction>> expressions;
     std::mt19937 generator;
     NumStop<double> numStop;
     AbsStop<double> absStop;
-    DetermOptimization<double> determOptimization;
-    StochastOptimization<double> stochastOptimization;
     QLineEdit* pointsMax[3][4];
     QLineEdit* pointsMin[3][4];
     QLineEdit* pointsStart[3][4];
@@ -68,18 +75,21 @@ public:
     inline double GetProb() const { return MyMenuParam.prob; }
     inline double GetDelta() const { return MyMenuParam.delta; }
     inline double GetAlpha() const { return MyMenuParam.alpha; }
+    inline size_t GetCache() const { return MyMenuParam.cache; }
     inline GeneralStop<double>* GetStoper() const { return MyMenuParam.stoper; }
     inline NumStop<double>& GetStopNum() { return numStop; }
     inline AbsStop<double>& GetStopAbs() { return absStop; }
     inline GeneralFunction<double>& GetFunction() const { return *MyMenuParam.f; }
-    inline Optimization<double>* GetOptim() { return MyMenuParam.Opt; }
-    inline DetermOptimization<double>& GetOptimDeter() { return determOptimization; }
-    inline StochastOptimization<double>& GetOptimStoch() { return stochastOptimization; }
     inline size_t GetAccuracy() const { return MyMenuParam.accuracyImg; }
     inline void SetStartPoint(Point<double> p) { MyMenuParam.start = p; }
 
     bool GetDrawGraph() const;
 
+    /// @brief Run of the chosen method with the parameters of the dialog.
+    /// @details Parameters are copied, so the run does not read the dialog, which changes while the run is active.
+    /// The stopper of the run is the argument of the callable.
+    std::function<RunResult<double>(GeneralStop<double>&)> GetRun() const;
+
     void SetNewSeed();
 
 signals:
@@ -114,6 +124,8 @@ private slots:
 
     void on_closeButton_clicked();
 
+    void on_addFunctionButton_clicked();
+
 private:
     Ui::Settings *ui;
 
@@ -125,6 +137,8 @@ private:
     static constexpr double delta = 0.1;
     static constexpr double alpha = 0.2;
     static constexpr size_t accuracyImg = 10;
+    static constexpr size_t cache = 0;
+    static constexpr LineSearchMode lineSearch = LineSearchMode::Scan;
 };
 
 #endif // SETTINGS_H